@@ -1016,9 +1016,11 @@ static void dumpTrace(int outFd)
             return;
         }
 
-        constexpr size_t bufSize = 64*1024;
-        std::unique_ptr<uint8_t> in(new uint8_t[bufSize]);
-        std::unique_ptr<uint8_t> out(new uint8_t[bufSize]);
+        // Sized so draining a multi-hundred-MB ftrace buffer doesn't take
+        // tens of thousands of read syscalls.
+        constexpr size_t bufSize = 1024*1024;
+        std::unique_ptr<uint8_t[]> in(new uint8_t[bufSize]);
+        std::unique_ptr<uint8_t[]> out(new uint8_t[bufSize]);
         if (!in || !out) {
             fprintf(stderr, "couldn't allocate buffers\n");
             close(traceFD);
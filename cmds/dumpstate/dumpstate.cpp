@@ -1334,17 +1334,29 @@ static Dumpstate::RunStatus dumpstate() {
 
     RUN_SLOW_FUNCTION_WITH_CONSENT_CHECK(RunCommand, "PROCRANK", {"procrank"}, AS_ROOT_20);
 
-    DumpFile("VIRTUAL MEMORY STATS", "/proc/vmstat");
-    DumpFile("VMALLOC INFO", "/proc/vmallocinfo");
-    DumpFile("SLAB INFO", "/proc/slabinfo");
-    DumpFile("ZONEINFO", "/proc/zoneinfo");
-    DumpFile("PAGETYPEINFO", "/proc/pagetypeinfo");
-    DumpFile("BUDDYINFO", "/proc/buddyinfo");
-    DumpFile("FRAGMENTATION INFO", "/d/extfrag/unusable_index");
-
-    DumpFile("KERNEL WAKE SOURCES", "/d/wakeup_sources");
-    DumpFile("KERNEL CPUFREQ", "/sys/devices/system/cpu/cpu0/cpufreq/stats/time_in_state");
-    DumpFile("KERNEL SYNC", "/d/sync");
+    // These sections read independent /proc and debugfs files; run them
+    // as a group on workers and splice the buffers in order.  Commands
+    // stay out of parallel groups: fork()ing while sibling workers may
+    // hold the allocator lock could deadlock the child before exec.
+    {
+        std::vector<Dumpstate::ParallelSection> sections;
+        const auto addFile = [&sections](const char* title, const char* path) {
+            sections.push_back({title,
+                                [title, path](int fd) { DumpFileToFd(fd, title, path); },
+                                5 /* same weight DumpFile would report */});
+        };
+        addFile("VIRTUAL MEMORY STATS", "/proc/vmstat");
+        addFile("VMALLOC INFO", "/proc/vmallocinfo");
+        addFile("SLAB INFO", "/proc/slabinfo");
+        addFile("ZONEINFO", "/proc/zoneinfo");
+        addFile("PAGETYPEINFO", "/proc/pagetypeinfo");
+        addFile("BUDDYINFO", "/proc/buddyinfo");
+        addFile("FRAGMENTATION INFO", "/d/extfrag/unusable_index");
+        addFile("KERNEL WAKE SOURCES", "/d/wakeup_sources");
+        addFile("KERNEL CPUFREQ", "/sys/devices/system/cpu/cpu0/cpufreq/stats/time_in_state");
+        addFile("KERNEL SYNC", "/d/sync");
+        ds.RunParallelSections(std::move(sections));
+    }
 
     RunCommand("PROCESSES AND THREADS",
                {"ps", "-A", "-T", "-Z", "-O", "pri,nice,rtprio,sched,pcy,time"});
@@ -22,6 +22,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -226,6 +227,29 @@ class Dumpstate {
                    const android::os::dumpstate::CommandOptions& options =
                        android::os::dumpstate::CommandOptions::DEFAULT);
 
+    /*
+     * One independent bugreport section destined for a parallel group: the
+     * callable writes the whole section (including its header) to the
+     * given fd.  |progressWeight| mirrors what the serial path would have
+     * passed to UpdateProgress().
+     */
+    struct ParallelSection {
+        std::string title;
+        std::function<void(int fd)> dump;
+        int32_t progressWeight;
+    };
+
+    /*
+     * Runs a group of independent sections on a worker pool.  Each section
+     * writes into its own memory-backed buffer and the buffers are
+     * spliced into the report in submission order once all sections
+     * finish, so the output is identical to the serial form while the
+     * group's wall time approaches its slowest member.  Per-section
+     * durations are appended in the DurationReporter format.  Falls back
+     * to running serially when buffers cannot be created.
+     */
+    void RunParallelSections(std::vector<ParallelSection> sections);
+
     /*
      * Runs `dumpsys` with the given arguments, automatically setting its timeout
      * (`-T` argument)
@@ -31,6 +31,8 @@
 #include <sys/capability.h>
 #include <sys/inotify.h>
 #include <sys/klog.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 #include <sys/prctl.h>
 #include <sys/stat.h>
 #include <sys/time.h>
@@ -38,9 +40,11 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <android-base/file.h>
@@ -576,6 +580,70 @@ void do_showmap(int pid, const char *name) {
     RunCommand(title, {"showmap", "-q", arg}, CommandOptions::AS_ROOT);
 }
 
+void Dumpstate::RunParallelSections(std::vector<ParallelSection> sections) {
+    // Buffers are memory-backed (memfd); if the kernel doesn't support
+    // them, run the group serially against stdout as before.
+    std::vector<android::base::unique_fd> buffers;
+    buffers.reserve(sections.size());
+    bool haveBuffers = true;
+    for (size_t i = 0; i < sections.size() && haveBuffers; i++) {
+        int fd = syscall(__NR_memfd_create, "dumpstate-section", MFD_CLOEXEC);
+        if (fd < 0) {
+            haveBuffers = false;
+        } else {
+            buffers.emplace_back(fd);
+        }
+    }
+
+    if (!haveBuffers) {
+        MYLOGW("memfd_create unavailable; running %zu sections serially\n", sections.size());
+        for (const ParallelSection& section : sections) {
+            DurationReporter duration_reporter(section.title);
+            section.dump(STDOUT_FILENO);
+            UpdateProgress(section.progressWeight);
+        }
+        return;
+    }
+
+    // Stripe the sections over a small pool; each worker appends its own
+    // duration line in the DurationReporter format.
+    const size_t workerCount = std::min<size_t>(sections.size(), 4);
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (size_t worker = 0; worker < workerCount; worker++) {
+        workers.emplace_back([&, worker] {
+            for (size_t i = worker; i < sections.size(); i += workerCount) {
+                const uint64_t start = Nanotime();
+                sections[i].dump(buffers[i].get());
+                const double elapsed = (double)(Nanotime() - start) / NANOS_PER_SEC;
+                dprintf(buffers[i].get(), "------ %.3fs was the duration of '%s' ------\n",
+                        elapsed, sections[i].title.c_str());
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Splice the buffers into the report in submission order.
+    fflush(stdout);
+    for (size_t i = 0; i < sections.size(); i++) {
+        if (lseek(buffers[i].get(), 0, SEEK_SET) == -1) {
+            MYLOGE("failed to rewind section buffer for '%s'\n", sections[i].title.c_str());
+            continue;
+        }
+        char copyBuffer[65536];
+        ssize_t bytesRead;
+        while ((bytesRead = TEMP_FAILURE_RETRY(
+                        read(buffers[i].get(), copyBuffer, sizeof(copyBuffer)))) > 0) {
+            if (!android::base::WriteFully(STDOUT_FILENO, copyBuffer, bytesRead)) {
+                break;
+            }
+        }
+        UpdateProgress(sections[i].progressWeight);
+    }
+}
+
 int Dumpstate::DumpFile(const std::string& title, const std::string& path) {
     DurationReporter duration_reporter(title);
 
@@ -18,6 +18,7 @@
 #include <chrono>
 #include <iomanip>
 #include <thread>
+#include <vector>
 
 #include <android-base/file.h>
 #include <android-base/stringprintf.h>
@@ -34,8 +35,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/poll.h>
 #include <sys/socket.h>
+#include <sys/syscall.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -67,6 +70,9 @@ static void usage() {
             "         -T TIMEOUT_MS: TIMEOUT to use in milliseconds instead of default 10 seconds\n"
             "         --proto: filter services that support dumping data in proto format. Dumps\n"
             "               will be in proto format.\n"
+            "         --parallel: issue all service dumps concurrently and emit them in\n"
+            "               order as they complete; the timeout applies to each service\n"
+            "               independently\n"
             "         --priority LEVEL: filter services based on specified priority\n"
             "               LEVEL must be one of CRITICAL | HIGH | NORMAL\n"
             "         --skip SERVICES: dumps all services but SERVICES (comma-separated list)\n"
@@ -120,10 +126,12 @@ int Dumpsys::main(int argc, char* const argv[]) {
     bool showListOnly = false;
     bool skipServices = false;
     bool asProto = false;
+    bool parallel = false;
     int timeoutArgMs = 10000;
     int priorityFlags = IServiceManager::DUMP_FLAG_PRIORITY_ALL;
     static struct option longOptions[] = {{"priority", required_argument, 0, 0},
                                           {"proto", no_argument, 0, 0},
+                                          {"parallel", no_argument, 0, 0},
                                           {"skip", no_argument, 0, 0},
                                           {"help", no_argument, 0, 0},
                                           {0, 0, 0, 0}};
@@ -147,6 +155,8 @@ int Dumpsys::main(int argc, char* const argv[]) {
                 skipServices = true;
             } else if (!strcmp(longOptions[optionIndex].name, "proto")) {
                 asProto = true;
+            } else if (!strcmp(longOptions[optionIndex].name, "parallel")) {
+                parallel = true;
             } else if (!strcmp(longOptions[optionIndex].name, "help")) {
                 usage();
                 return 0;
@@ -236,6 +246,11 @@ int Dumpsys::main(int argc, char* const argv[]) {
         return 0;
     }
 
+    if (parallel && N > 1) {
+        return dumpServicesInParallel(services, skippedServices, args, priorityFlags,
+                                      std::chrono::milliseconds(timeoutArgMs), asProto);
+    }
+
     for (size_t i = 0; i < N; i++) {
         const String16& serviceName = services[i];
         if (IsSkipped(skippedServices, serviceName)) continue;
@@ -307,6 +322,119 @@ void Dumpsys::setServiceArgs(Vector<String16>& args, bool asProto, int priorityF
     }
 }
 
+int Dumpsys::dumpServicesInParallel(const Vector<String16>& services,
+                                    const Vector<String16>& skippedServices,
+                                    const Vector<String16>& args, int priorityFlags,
+                                    std::chrono::milliseconds timeout, bool asProto) {
+    // Every service dump is issued at once, each draining into its own
+    // memory buffer with the usual per-service timeout; the buffers are
+    // then emitted in the original order as they complete, so total wall
+    // time approaches the slowest service instead of the sum.
+    struct ParallelDump {
+        String16 name;
+        bool started = false;
+        unique_fd buffer;
+        std::thread serviceThread;
+        std::thread drainThread;
+        std::chrono::duration<double> elapsed{};
+        size_t bytes = 0;
+        status_t status = OK;
+    };
+
+    std::vector<ParallelDump> dumps(services.size());
+    for (size_t i = 0; i < services.size(); i++) {
+        ParallelDump& dump = dumps[i];
+        dump.name = services[i];
+        if (IsSkipped(skippedServices, dump.name)) continue;
+
+        sp<IBinder> service = sm_->checkService(dump.name);
+        if (service == nullptr) {
+            aerr << "Can't find service: " << dump.name << endl;
+            continue;
+        }
+
+        dump.buffer.reset(static_cast<int>(syscall(__NR_memfd_create, "dumpsys", MFD_CLOEXEC)));
+        if (dump.buffer.get() < 0) {
+            aerr << "Failed to create dump buffer for " << dump.name << ": " << strerror(errno)
+                 << endl;
+            continue;
+        }
+
+        int sfd[2];
+        if (pipe(sfd) != 0) {
+            aerr << "Failed to create pipe to dump service info for " << dump.name << ": "
+                 << strerror(errno) << endl;
+            continue;
+        }
+        unique_fd readEnd(sfd[0]);
+        unique_fd remoteEnd(sfd[1]);
+
+        dump.started = true;
+        dump.serviceThread = std::thread([service, args,
+                                          remoteEnd{std::move(remoteEnd)}]() mutable {
+            service->dump(remoteEnd.get(), args);
+            remoteEnd.reset();
+        });
+        dump.drainThread = std::thread([&dump, timeout, asProto,
+                                        readEnd{std::move(readEnd)}]() mutable {
+            dump.status = drainDumpOutput(readEnd.get(), dump.buffer.get(), dump.name, timeout,
+                                          asProto, dump.elapsed, dump.bytes);
+        });
+    }
+
+    const bool addSeparator = services.size() > 1;
+    for (ParallelDump& dump : dumps) {
+        if (!dump.started) continue;
+        dump.drainThread.join();
+        if (dump.status == OK) {
+            dump.serviceThread.join();
+        } else {
+            // The service is still writing (timeout or error); don't wait.
+            dump.serviceThread.detach();
+        }
+
+        if (addSeparator) {
+            writeDumpHeader(STDOUT_FILENO, dump.name, priorityFlags);
+        }
+        if (lseek(dump.buffer.get(), 0, SEEK_SET) == 0) {
+            char buf[65536];
+            ssize_t rc;
+            while ((rc = TEMP_FAILURE_RETRY(read(dump.buffer.get(), buf, sizeof(buf)))) > 0) {
+                if (!WriteFully(STDOUT_FILENO, buf, rc)) break;
+            }
+        }
+        if (dump.status == TIMED_OUT) {
+            aout << endl
+                 << "*** SERVICE '" << dump.name << "' DUMP TIMEOUT (" << timeout.count()
+                 << "ms) EXPIRED ***" << endl
+                 << endl;
+        }
+        if (addSeparator) {
+            writeDumpFooter(STDOUT_FILENO, dump.name, dump.elapsed);
+        }
+    }
+
+    // Anything whose parallel setup failed (no buffer, no pipe) still gets
+    // dumped the serial way rather than dropped.
+    for (const ParallelDump& dump : dumps) {
+        if (dump.started || IsSkipped(skippedServices, dump.name)) continue;
+        if (startDumpThread(dump.name, args) == OK) {
+            if (addSeparator) {
+                writeDumpHeader(STDOUT_FILENO, dump.name, priorityFlags);
+            }
+            std::chrono::duration<double> elapsed;
+            size_t bytes = 0;
+            status_t status =
+                    writeDump(STDOUT_FILENO, dump.name, timeout, asProto, elapsed, bytes);
+            if (addSeparator) {
+                writeDumpFooter(STDOUT_FILENO, dump.name, elapsed);
+            }
+            stopDumpThread(status == OK);
+        }
+    }
+    return 0;
+}
+
 status_t Dumpsys::startDumpThread(const String16& serviceName, const Vector<String16>& args) {
     sp<IBinder> service = sm_->checkService(serviceName);
     if (service == nullptr) {
@@ -372,17 +500,24 @@ void Dumpsys::writeDumpHeader(int fd, const String16& serviceName, int priorityF
 status_t Dumpsys::writeDump(int fd, const String16& serviceName, std::chrono::milliseconds timeout,
                             bool asProto, std::chrono::duration<double>& elapsedDuration,
                             size_t& bytesWritten) const {
-    status_t status = OK;
-    size_t totalBytes = 0;
-    auto start = std::chrono::steady_clock::now();
-    auto end = start + timeout;
-
     int serviceDumpFd = redirectFd_.get();
     if (serviceDumpFd == -1) {
         return INVALID_OPERATION;
     }
+    return drainDumpOutput(serviceDumpFd, fd, serviceName, timeout, asProto, elapsedDuration,
+                           bytesWritten);
+}
+
+status_t Dumpsys::drainDumpOutput(int sourceFd, int fd, const String16& serviceName,
+                                  std::chrono::milliseconds timeout, bool asProto,
+                                  std::chrono::duration<double>& elapsedDuration,
+                                  size_t& bytesWritten) {
+    status_t status = OK;
+    size_t totalBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + timeout;
 
-    struct pollfd pfd = {.fd = serviceDumpFd, .events = POLLIN};
+    struct pollfd pfd = {.fd = sourceFd, .events = POLLIN};
 
     while (true) {
         // Wrap this in a lambda so that TEMP_FAILURE_RETRY recalculates the timeout.
@@ -404,7 +539,7 @@ status_t Dumpsys::writeDump(int fd, const String16& serviceName, std::chrono::mi
         }
 
         char buf[4096];
-        rc = TEMP_FAILURE_RETRY(read(redirectFd_.get(), buf, sizeof(buf)));
+        rc = TEMP_FAILURE_RETRY(read(sourceFd, buf, sizeof(buf)));
         if (rc < 0) {
             aerr << "Failed to read while dumping service " << serviceName << ": "
                  << strerror(errno) << endl;
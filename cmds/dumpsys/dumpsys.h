@@ -63,6 +63,25 @@ class Dumpsys {
      */
     status_t startDumpThread(const String16& serviceName, const Vector<String16>& args);
 
+    /**
+     * Dumps every service concurrently into per-service memory buffers and
+     * emits them in the original order as they complete, applying the
+     * usual timeout to each service independently; used by --parallel.
+     */
+    int dumpServicesInParallel(const Vector<String16>& services,
+                               const Vector<String16>& skippedServices,
+                               const Vector<String16>& args, int priorityFlags,
+                               std::chrono::milliseconds timeout, bool asProto);
+
+    /**
+     * Drains one service's dump output from sourceFd into fd with the
+     * given timeout; the body of writeDump(), parametrized on the source.
+     */
+    static status_t drainDumpOutput(int sourceFd, int fd, const String16& serviceName,
+                                    std::chrono::milliseconds timeout, bool asProto,
+                                    std::chrono::duration<double>& elapsedDuration,
+                                    size_t& bytesWritten);
+
     /**
      * Writes a section header to a file descriptor.
      * @param fd file descriptor to write data
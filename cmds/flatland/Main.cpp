@@ -36,6 +36,7 @@ using namespace ::android;
 
 static uint32_t g_SleepBetweenSamplesMs = 0;
 static bool     g_PresentToWindow       = false;
+static bool     g_JsonOutput            = false;
 static size_t   g_BenchmarkNameLen      = 0;
 
 struct BenchmarkDesc {
@@ -590,13 +591,16 @@ static int cmpDouble(const double* lhs, const double* rhs) {
 static bool runTest(const BenchmarkDesc b, size_t run) {
     bool success = true;
     double prevResult = 0.0, result = 0.0;
+    const char* skipReason = NULL;
     Vector<double> samples;
 
     uint32_t runHeight = b.runHeights[run];
     uint32_t runWidth = b.width * runHeight / b.height;
-    printf(" %-*s | %4d x %4d | ", static_cast<int>(g_BenchmarkNameLen), b.name,
-            runWidth, runHeight);
-    fflush(stdout);
+    if (!g_JsonOutput) {
+        printf(" %-*s | %4d x %4d | ", static_cast<int>(g_BenchmarkNameLen), b.name,
+                runWidth, runHeight);
+        fflush(stdout);
+    }
 
     BenchmarkRunner r(b, run);
     if (!r.setUp()) {
@@ -627,11 +631,11 @@ static bool runTest(const BenchmarkDesc b, size_t run) {
 
     if (totalFrames - warmUpFrames > 16) {
         // The test runs too fast to get a stable result.  Skip it.
-        printf("  fast");
+        skipReason = "fast";
         goto done;
     } else if (totalFrames == 5 && runTime > 200e6) {
         // The test runs too slow to be very useful.  Skip it.
-        printf("  slow");
+        skipReason = "slow";
         goto done;
     }
 
@@ -642,7 +646,7 @@ static bool runTest(const BenchmarkDesc b, size_t run) {
         }
 
         if (newSamples > 512) {
-            printf("varies");
+            skipReason = "varies";
             goto done;
         }
 
@@ -668,11 +672,40 @@ static bool runTest(const BenchmarkDesc b, size_t run) {
         result = (samples[elem-1] + samples[elem]) * 0.5;
     } while (fabs(result - prevResult) > threshold * result);
 
-    printf("%6.3f", result / double(totalFrames - warmUpFrames) / 1e6);
-
 done:
 
-    printf("\n");
+    // samples are sorted by the measurement loop; report latency percentiles
+    // over the per-frame times so tails are visible, not just the filtered
+    // median the stability loop converges on.
+    double frameMs, p50Ms = 0.0, p95Ms = 0.0, p99Ms = 0.0;
+    frameMs = result / double(totalFrames - warmUpFrames) / 1e6;
+    if (samples.size() > 0) {
+        const double perFrame = 1e6 * double(totalFrames - warmUpFrames);
+        p50Ms = samples[samples.size() / 2] / perFrame;
+        p95Ms = samples[(samples.size() * 95) / 100] / perFrame;
+        p99Ms = samples[(samples.size() * 99) / 100] / perFrame;
+    }
+
+    if (g_JsonOutput) {
+        printf("{\"scenario\": \"%s\", \"width\": %u, \"height\": %u",
+                b.name, runWidth, runHeight);
+        if (skipReason != NULL) {
+            printf(", \"skipped\": \"%s\"}\n", skipReason);
+        } else if (!success) {
+            printf(", \"error\": true}\n");
+        } else {
+            printf(", \"frame_ms\": %.3f, \"p50_ms\": %.3f, \"p95_ms\": %.3f, "
+                    "\"p99_ms\": %.3f, \"samples\": %zu}\n",
+                    frameMs, p50Ms, p95Ms, p99Ms, samples.size());
+        }
+    } else {
+        if (skipReason != NULL) {
+            printf("  %s", skipReason);
+        } else if (success) {
+            printf("%6.3f | %6.3f | %6.3f | %6.3f", frameMs, p50Ms, p95Ms, p99Ms);
+        }
+        printf("\n");
+    }
     fflush(stdout);
     r.tearDown();
 
@@ -684,14 +717,16 @@ static void printResultsTableHeader() {
     size_t len = strlen(scenario);
     size_t leftPad = (g_BenchmarkNameLen - len) / 2;
     size_t rightPad = g_BenchmarkNameLen - len - leftPad;
-    printf(" %*s%s%*s | Resolution  | Time (ms)\n",
+    printf(" %*s%s%*s | Resolution  | Time (ms) | p50 | p95 | p99\n",
             static_cast<int>(leftPad), "",
             "Scenario", static_cast<int>(rightPad), "");
 }
 
 // Run ALL the benchmarks!
 static bool runTests() {
-    printResultsTableHeader();
+    if (!g_JsonOutput) {
+        printResultsTableHeader();
+    }
 
     for (size_t i = 0; i < NELEMS(benchmarks); i++) {
         const BenchmarkDesc& b = benchmarks[i];
@@ -723,6 +758,7 @@ static void showHelp(const char *cmd) {
     fprintf(stderr, "options include:\n"
                     "  -s N            sleep for N ms between samples\n"
                     "  -d              display the test frame to a window\n"
+                    "  -j              emit one JSON object per scenario instead of the table\n"
                     "  --help          print this helpful message and exit\n"
             );
 }
@@ -741,7 +777,7 @@ int main(int argc, char** argv) {
             {     0,               0, 0,  0 }
         };
 
-        ret = getopt_long(argc, argv, "ds:",
+        ret = getopt_long(argc, argv, "djs:",
                           long_options, &option_index);
 
         if (ret < 0) {
@@ -753,6 +789,10 @@ int main(int argc, char** argv) {
                 g_PresentToWindow = true;
             break;
 
+            case 'j':
+                g_JsonOutput = true;
+            break;
+
             case 's':
                 g_SleepBetweenSamplesMs = atoi(optarg);
             break;
@@ -772,11 +812,13 @@ int main(int argc, char** argv) {
 
     g_BenchmarkNameLen = maxBenchmarkNameLen();
 
-    printf(" cmdline:");
-    for (int i = 0; i < argc; i++) {
-        printf(" %s", argv[i]);
+    if (!g_JsonOutput) {
+        printf(" cmdline:");
+        for (int i = 0; i < argc; i++) {
+            printf(" %s", argv[i]);
+        }
+        printf("\n");
     }
-    printf("\n");
 
     if (!runTests()) {
         fprintf(stderr, "exiting due to error.\n");
@@ -19,6 +19,7 @@
 #define ATRACE_TAG ATRACE_TAG_PACKAGE_MANAGER
 
 #include <algorithm>
+#include <thread>
 #include <errno.h>
 #include <fstream>
 #include <fts.h>
@@ -2093,6 +2094,27 @@ static const char* getCStr(const std::unique_ptr<std::string>& data,
         const char* default_value = nullptr) {
     return data == nullptr ? default_value : data->c_str();
 }
+void InstalldNativeService::acquireDexoptSlot(const std::string& token) {
+    static const size_t kMaxConcurrentDexopt =
+            std::max(2u, std::thread::hardware_concurrency() / 2);
+    std::unique_lock<std::mutex> lock(mDexoptLock);
+    mDexoptCondition.wait(lock, [&] {
+        return mActiveDexoptCount < kMaxConcurrentDexopt &&
+                mActiveDexoptTargets.count(token) == 0;
+    });
+    mActiveDexoptTargets.insert(token);
+    mActiveDexoptCount++;
+}
+
+void InstalldNativeService::releaseDexoptSlot(const std::string& token) {
+    {
+        std::lock_guard<std::mutex> lock(mDexoptLock);
+        mActiveDexoptTargets.erase(token);
+        mActiveDexoptCount--;
+    }
+    mDexoptCondition.notify_all();
+}
+
 binder::Status InstalldNativeService::dexopt(const std::string& apkPath, int32_t uid,
         const std::unique_ptr<std::string>& packageName, const std::string& instructionSet,
         int32_t dexoptNeeded, const std::unique_ptr<std::string>& outputPath, int32_t dexFlags,
@@ -2110,7 +2132,17 @@ binder::Status InstalldNativeService::dexopt(const std::string& apkPath, int32_t
     }
     CHECK_ARGUMENT_PATH(outputPath);
     CHECK_ARGUMENT_PATH(dexMetadataPath);
-    std::lock_guard<std::recursive_mutex> lock(mLock);
+
+    // Per-target exclusion plus a bounded concurrency slot instead of the
+    // global service lock; see the declaration for rationale.
+    struct DexoptSlot {
+        InstalldNativeService* service;
+        const std::string& token;
+        DexoptSlot(InstalldNativeService* s, const std::string& t) : service(s), token(t) {
+            service->acquireDexoptSlot(token);
+        }
+        ~DexoptSlot() { service->releaseDexoptSlot(token); }
+    } dexoptSlot(this, apkPath);
 
     const char* apk_path = apkPath.c_str();
     const char* pkgname = getCStr(packageName, "*");
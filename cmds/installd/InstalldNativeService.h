@@ -21,8 +21,11 @@
 #include <inttypes.h>
 #include <unistd.h>
 
-#include <vector>
+#include <condition_variable>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <android-base/macros.h>
 #include <binder/BinderService.h>
@@ -160,6 +163,22 @@ public:
 private:
     std::recursive_mutex mLock;
 
+    /**
+     * dexopt can run dex2oat for minutes per package; holding mLock for
+     * its duration serialized the whole post-OTA optimization window and
+     * blocked unrelated installd work behind it.  dexopt instead holds a
+     * per-target token plus one of a bounded number of concurrency slots
+     * (sized from the core count), so several dex2oat children run in
+     * parallel while two requests for the same target still exclude each
+     * other.
+     */
+    void acquireDexoptSlot(const std::string& token);
+    void releaseDexoptSlot(const std::string& token);
+    std::mutex mDexoptLock;
+    std::condition_variable mDexoptCondition;
+    std::unordered_set<std::string> mActiveDexoptTargets;
+    size_t mActiveDexoptCount = 0;
+
     std::recursive_mutex mMountsLock;
     std::recursive_mutex mQuotasLock;
 
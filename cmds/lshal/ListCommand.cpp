@@ -19,6 +19,7 @@
 #include <getopt.h>
 
 #include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <functional>
 #include <iomanip>
@@ -26,6 +27,7 @@
 #include <map>
 #include <regex>
 #include <sstream>
+#include <thread>
 
 #include <android-base/file.h>
 #include <android-base/logging.h>
@@ -290,6 +292,7 @@ bool ListCommand::getPidInfo(
 }
 
 const PidInfo* ListCommand::getPidInfoCached(pid_t serverPid) {
+    std::lock_guard<std::mutex> lock(mFetchMutex);
     auto pair = mCachedPidInfos.insert({serverPid, PidInfo{}});
     if (pair.second /* did insertion take place? */) {
         if (!getPidInfo(serverPid, &pair.first->second)) {
@@ -674,9 +677,35 @@ Status ListCommand::fetchBinderized(const sp<IServiceManager> &manager) {
         entry.interfaceName = fqInstanceName;
         entry.transport = mode;
         entry.serviceStatus = ServiceStatus::NON_RESPONSIVE;
+    }
 
-        status |= fetchBinderizedEntry(manager, &entry);
+    // Interrogate the services concurrently on a bounded pool: each entry's
+    // calls already run under timeoutIPC, so with the pool the worst case is
+    // one timeout rather than the sum of every hung HAL's timeout.  Workers
+    // only touch their own entry; the pid-info cache and the error stream
+    // are guarded by mFetchMutex.
+    std::vector<TableEntry*> entries;
+    entries.reserve(allTableEntries.size());
+    for (auto& pair : allTableEntries) {
+        entries.push_back(&pair.second);
+    }
+    const size_t workerCount = std::min<size_t>(8, entries.size());
+    std::atomic<size_t> nextEntry(0);
+    std::atomic<uint32_t> statusBits(static_cast<uint32_t>(status));
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back([&] {
+            for (size_t index = nextEntry.fetch_add(1); index < entries.size();
+                 index = nextEntry.fetch_add(1)) {
+                statusBits.fetch_or(
+                        static_cast<uint32_t>(fetchBinderizedEntry(manager, entries[index])));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
     }
+    status = static_cast<Status>(statusBits.load());
 
     for (auto& pair : allTableEntries) {
         putEntry(HalType::BINDERIZED_SERVICES, std::move(pair.second));
@@ -688,6 +717,7 @@ Status ListCommand::fetchBinderizedEntry(const sp<IServiceManager> &manager,
                                          TableEntry *entry) {
     Status status = OK;
     const auto handleError = [&](Status additionalError, const std::string& msg) {
+        std::lock_guard<std::mutex> lock(mFetchMutex);
         err() << "Warning: Skipping \"" << entry->interfaceName << "\": " << msg << std::endl;
         status |= DUMP_BINDERIZED_ERROR | additionalError;
     };
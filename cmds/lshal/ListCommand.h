@@ -21,6 +21,7 @@
 #include <stdint.h>
 
 #include <fstream>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -188,6 +189,9 @@ protected:
     std::map<pid_t, std::string> mCmdlines;
 
     // Cache for getPidInfo.
+    // Protects mCachedPidInfos and error stream writes while
+    // fetchBinderized() interrogates services concurrently.
+    mutable std::mutex mFetchMutex;
     std::map<pid_t, PidInfo> mCachedPidInfos;
 
     // Cache for getPartition.
@@ -139,6 +139,7 @@ static int svc_can_find(const uint16_t *name, size_t name_len, pid_t spid, const
 struct svcinfo
 {
     struct svcinfo *next;
+    struct svcinfo *hashnext;
     uint32_t handle;
     struct binder_death death;
     int allow_isolated;
@@ -149,11 +150,29 @@ struct svcinfo
 
 struct svcinfo *svclist = NULL;
 
+/* Name-hash buckets in front of svclist: every getService() from every
+ * process lands here, and walking the flat list is O(registered
+ * services).  Entries are never removed (a dead service keeps its node
+ * with handle 0), so the buckets are insert-only. */
+#define SVC_HASH_BUCKETS 64
+static struct svcinfo *svc_hash[SVC_HASH_BUCKETS];
+
+static unsigned svc_hash_name(const uint16_t *s16, size_t len)
+{
+    unsigned h = 5381;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        h = h * 33 + s16[i];
+    }
+    return h & (SVC_HASH_BUCKETS - 1);
+}
+
 struct svcinfo *find_svc(const uint16_t *s16, size_t len)
 {
     struct svcinfo *si;
 
-    for (si = svclist; si; si = si->next) {
+    for (si = svc_hash[svc_hash_name(s16, len)]; si; si = si->hashnext) {
         if ((len == si->len) &&
             !memcmp(s16, si->name, len * sizeof(uint16_t))) {
             return si;
@@ -244,6 +263,10 @@ int do_add_service(struct binder_state *bs, const uint16_t *s, size_t len, uint3
         si->dumpsys_priority = dumpsys_priority;
         si->next = svclist;
         svclist = si;
+
+        unsigned bucket = svc_hash_name(si->name, si->len);
+        si->hashnext = svc_hash[bucket];
+        svc_hash[bucket] = si;
     }
 
     binder_acquire(bs, handle);
@@ -31,8 +31,11 @@
 #include <ui/DisplayInfo.h>
 #include <utils/Log.h>
 #include <utils/String8.h>
+#include <utils/Timers.h>
 #include <utils/Trace.h>
 
+#include <inttypes.h>
+
 #include <chrono>
 #include <cmath>
 #include <condition_variable>
@@ -155,6 +158,17 @@ status_t Replayer::replay() {
 
     SurfaceComposerClient::enableVSyncInjections(false);
 
+    if (mWaitForTimeStamps) {
+        if (mSlippedIncrements > 0) {
+            std::cout << "Replay slipped on " << mSlippedIncrements << " increment(s): max "
+                      << ns2ms(mMaxSlipNs) << " ms, total " << ns2ms(mTotalSlipNs)
+                      << " ms behind trace time" << std::endl;
+        } else {
+            std::cout << "Replay held trace pacing (no increment more than 1 ms late)"
+                      << std::endl;
+        }
+    }
+
     return status;
 }
 
@@ -665,8 +679,34 @@ void Replayer::updatePowerMode(const PowerModeUpdate& pmu, const std::shared_ptr
 }
 
 void Replayer::waitUntilTimestamp(int64_t timestamp) {
-    ALOGV("Waiting for %lld nanoseconds...", static_cast<int64_t>(timestamp - mCurrentTime));
-    std::this_thread::sleep_for(std::chrono::nanoseconds(timestamp - mCurrentTime));
+    if (mTraceTimeOrigin < 0) {
+        mTraceTimeOrigin = timestamp;
+        mRealtimeOrigin = systemTime();
+        return;
+    }
+
+    // Sleep to the absolute deadline for this increment rather than by the
+    // trace delta: sleeping deltas lets every increment's processing time
+    // accumulate as drift, which is exactly what makes a replayed 60fps
+    // trace fall behind realtime.
+    const nsecs_t deadline = mRealtimeOrigin + (timestamp - mTraceTimeOrigin);
+    const nsecs_t now = systemTime();
+    if (deadline > now) {
+        ALOGV("Waiting for %" PRId64 " nanoseconds...", deadline - now);
+        std::this_thread::sleep_for(std::chrono::nanoseconds(deadline - now));
+    } else if (now - deadline > s2ns(1)) {
+        // a gap this large is a manual pause at the console, not pacing
+        // slip; re-anchor so the rest of the replay is still comparable
+        mRealtimeOrigin += now - deadline;
+    } else if (now - deadline > ms2ns(1)) {
+        // more than a millisecond late to this increment's deadline
+        const int64_t slip = now - deadline;
+        mSlippedIncrements++;
+        mTotalSlipNs += slip;
+        if (slip > mMaxSlipNs) {
+            mMaxSlipNs = slip;
+        }
+    }
 }
 
 void Replayer::waitUntilDeferredTransactionLayerExists(
@@ -127,6 +127,16 @@ class Replayer {
     bool mLoaded = false;
     int32_t mIncrementIndex = 0;
     int64_t mCurrentTime = 0;
+
+    // Frame-accurate pacing: increments are slept to an absolute deadline
+    // derived from a realtime origin, so per-increment processing time does
+    // not accumulate as drift.  Slip (arriving late at a deadline) is
+    // tracked and summarized when the replay ends.
+    nsecs_t mRealtimeOrigin = 0;
+    int64_t mTraceTimeOrigin = -1;
+    int64_t mMaxSlipNs = 0;
+    int64_t mTotalSlipNs = 0;
+    uint64_t mSlippedIncrements = 0;
     int32_t mNumThreads = DEFAULT_THREADS;
 
     Increment mCurrentIncrement;
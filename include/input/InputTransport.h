@@ -30,6 +30,7 @@
  */
 
 #include <string>
+#include <vector>
 
 #include <binder/IBinder.h>
 #include <input/Input.h>
@@ -187,6 +188,18 @@ public:
      */
     status_t sendMessage(const InputMessage* msg);
 
+    /* Batched sending: between startMessageBatch() and flushMessageBatch(),
+     * sendMessage() stages messages and flushMessageBatch() writes them as
+     * a single seqpacket datagram (receiveMessage() on the peer splits
+     * such datagrams transparently).  At most kMaxBatchedMessages are
+     * staged; staging past that flushes eagerly.  A flush that returns
+     * WOULD_BLOCK keeps the staged bytes, and the next flush retries them
+     * first, preserving ordering.
+     */
+    static constexpr size_t kMaxBatchedMessages = 4;
+    void startMessageBatch();
+    status_t flushMessageBatch();
+
     /* Receives a message sent by the other endpoint.
      *
      * If there is no message present, try again after poll() indicates that the fd
@@ -211,9 +224,18 @@ public:
 private:
     void setFd(int fd);
 
+    status_t sendBytes(const void* data, size_t size);
+
     std::string mName;
     int mFd = -1;
 
+    // Batched-send staging and receive-side splitting of batched
+    // datagrams; allocated lazily since most channels never batch.
+    bool mBatchingSends = false;
+    std::vector<uint8_t> mSendBatch;
+    std::vector<uint8_t> mPendingReceived;
+    size_t mPendingReceivedOffset = 0;
+
     sp<IBinder> mToken = nullptr;
 };
 
@@ -138,6 +138,8 @@ BpBinder* BpBinder::create(int32_t handle) {
 BpBinder::BpBinder(int32_t handle, int32_t trackedUid)
     : mHandle(handle)
     , mAlive(1)
+    , mOnewayBatching(0)
+    , mOnewayFlushThreshold(kDefaultOnewayFlushThreshold)
     , mObitsSent(0)
     , mObituaries(nullptr)
     , mTrackedUid(trackedUid)
@@ -212,8 +214,14 @@ status_t BpBinder::transact(
 {
     // Once a binder has died, it will never come back to life.
     if (mAlive) {
-        status_t status = IPCThreadState::self()->transact(
-            mHandle, code, data, reply, flags);
+        status_t status;
+        if ((flags & FLAG_ONEWAY) && mOnewayBatching) {
+            status = IPCThreadState::self()->queueBatchedOneway(
+                mHandle, code, data, mOnewayFlushThreshold);
+        } else {
+            status = IPCThreadState::self()->transact(
+                mHandle, code, data, reply, flags);
+        }
         if (status == DEAD_OBJECT) mAlive = 0;
         return status;
     }
@@ -221,6 +229,17 @@ status_t BpBinder::transact(
     return DEAD_OBJECT;
 }
 
+void BpBinder::setOnewayBatchingEnabled(bool enabled, size_t flushThresholdBytes)
+{
+    mOnewayFlushThreshold = flushThresholdBytes;
+    mOnewayBatching = enabled ? 1 : 0;
+}
+
+status_t BpBinder::flushOnewayBatch()
+{
+    return IPCThreadState::self()->flushBatchedOneway();
+}
+
 // NOLINTNEXTLINE(google-default-arguments)
 status_t BpBinder::linkToDeath(
     const sp<DeathRecipient>& recipient, void* cookie, uint32_t flags)
@@ -65,11 +65,14 @@ struct BufferedTextOutput::BufferState : public RefBase
     void restart() {
         bufferPos = 0;
         atFront = true;
-        if (bufferSize > 256) {
-            void* b = realloc(buffer, 256);
+        // Keep a few KB of capacity across lines: dump output routinely
+        // exceeds the old 256-byte floor, and shrinking after every line
+        // meant a realloc up and back down per line written.
+        if (bufferSize > 4096) {
+            void* b = realloc(buffer, 4096);
             if (b) {
                 buffer = (char*)b;
-                bufferSize = 256;
+                bufferSize = 4096;
             }
         }
     }
@@ -158,9 +161,20 @@ BufferedTextOutput::~BufferedTextOutput()
 
 status_t BufferedTextOutput::print(const char* txt, size_t len)
 {
-    //printf("BufferedTextOutput: printing %d\n", len);
-    
+    if ((mFlags&MULTITHREADED) != 0) {
+        // Each thread appends to its own BufferState and every completed
+        // line reaches the fd through a single writev(), so the instance
+        // lock adds contention without adding atomicity.
+        return printInternal(txt, len);
+    }
     AutoMutex _l(mLock);
+    return printInternal(txt, len);
+}
+
+status_t BufferedTextOutput::printInternal(const char* txt, size_t len)
+{
+    //printf("BufferedTextOutput: printing %d\n", len);
+
     BufferState* b = getBuffer();
     
     const char* const end = txt+len;
@@ -505,6 +505,12 @@ status_t IPCThreadState::getAndExecuteCommand()
 
         pthread_mutex_lock(&mProcess->mThreadCountLock);
         mProcess->mExecutingThreadsCount++;
+        if (mProcess->mExecutingThreadsCount > mProcess->mPeakExecutingThreadsCount) {
+            mProcess->mPeakExecutingThreadsCount = mProcess->mExecutingThreadsCount;
+        }
+        if (cmd == (int32_t)BR_TRANSACTION || cmd == (int32_t)BR_TRANSACTION_SEC_CTX) {
+            mProcess->mTransactionsExecuted++;
+        }
         if (mProcess->mExecutingThreadsCount >= mProcess->mMaxThreads &&
                 mProcess->mStarvationStartTimeMs == 0) {
             mProcess->mStarvationStartTimeMs = uptimeMillis();
@@ -521,7 +527,25 @@ status_t IPCThreadState::getAndExecuteCommand()
             if (starvationTimeMs > 100) {
                 ALOGE("binder thread pool (%zu threads) starved for %" PRId64 " ms",
                       mProcess->mMaxThreads, starvationTimeMs);
+                // Name the transactions still holding pool threads: the
+                // long-runners that outlasted the whole starvation window are
+                // the ones worth chasing.
+                const int64_t nowMs = uptimeMillis();
+                for (size_t i = 0; i < mProcess->mThreadStates.size(); i++) {
+                    const IPCThreadState* ts = mProcess->mThreadStates[i];
+                    const uintptr_t target =
+                            ts->mInFlightTarget.load(std::memory_order_relaxed);
+                    if (target == 0) continue;
+                    ALOGE("  still executing: target %p code %u from pid %d for %" PRId64 " ms",
+                          reinterpret_cast<void*>(target),
+                          ts->mInFlightCode.load(std::memory_order_relaxed),
+                          ts->mInFlightCallerPid.load(std::memory_order_relaxed),
+                          nowMs - ts->mInFlightStartMs.load(std::memory_order_relaxed));
+                }
             }
+            mProcess->mStarvationEpisodes +=
+                    (starvationTimeMs > 100) ? 1 : 0;
+            mProcess->mStarvationTotalMs += starvationTimeMs;
             mProcess->mStarvationStartTimeMs = 0;
         }
         pthread_cond_broadcast(&mProcess->mThreadCountDecrement);
@@ -717,6 +741,64 @@ status_t IPCThreadState::transact(int32_t handle,
     return err;
 }
 
+status_t IPCThreadState::queueBatchedOneway(int32_t handle, uint32_t code,
+                                            const Parcel& data, size_t flushThreshold)
+{
+    // The BC_TRANSACTION written into mOut references its payload by
+    // pointer until the driver consumes it, which with batching happens
+    // after the caller's Parcel may be gone; stage a copy that lives
+    // until the queue is flushed.
+    Parcel* staged = new Parcel();
+    status_t err = staged->appendFrom(&data, 0, data.dataSize());
+    if (err != NO_ERROR) {
+        delete staged;
+        return (mLastError = err);
+    }
+
+    LOG_ONEWAY(">>>> QUEUE from pid %d uid %d", getpid(), getuid());
+    err = writeTransactionData(BC_TRANSACTION, TF_ONE_WAY | TF_ACCEPT_FDS,
+                               handle, code, *staged, nullptr);
+    if (err != NO_ERROR) {
+        delete staged;
+        return (mLastError = err);
+    }
+
+    mBatchedOnewayData.push(staged);
+    mPendingBatchedOneway++;
+
+    if (mOut.dataSize() >= flushThreshold) {
+        return flushBatchedOneway();
+    }
+    return NO_ERROR;
+}
+
+status_t IPCThreadState::flushBatchedOneway()
+{
+    status_t result = NO_ERROR;
+
+    // The first wait writes every queued BC_TRANSACTION in a single
+    // BINDER_WRITE_READ; the remaining iterations only consume the
+    // BR_TRANSACTION_COMPLETE acknowledgements already read into mIn.
+    while (mPendingBatchedOneway > 0) {
+        mPendingBatchedOneway--;
+        const status_t err = waitForResponse(nullptr, nullptr);
+        if (err != NO_ERROR && result == NO_ERROR) result = err;
+    }
+
+    // All queued commands have been acknowledged, so the driver is done
+    // with the staged payloads.  If the driver write itself failed the
+    // commands may still be sitting in mOut; keep the payloads alive for
+    // the destructor in that case.
+    if (mOut.dataSize() == 0) {
+        while (mBatchedOnewayData.size() > 0) {
+            delete mBatchedOnewayData.top();
+            mBatchedOnewayData.pop();
+        }
+    }
+
+    return result;
+}
+
 void IPCThreadState::incStrongHandle(int32_t handle, BpBinder *proxy)
 {
     LOG_REMOTEREFS("IPCThreadState::incStrongHandle(%d)\n", handle);
@@ -805,6 +887,7 @@ IPCThreadState::IPCThreadState()
       mPropagateWorkSource(false),
       mStrictModePolicy(0),
       mLastTransactionBinderFlags(0),
+      mPendingBatchedOneway(0),
       mCallRestriction(mProcess->mCallRestriction)
 {
     pthread_setspecific(gTLS, this);
@@ -812,10 +895,24 @@ IPCThreadState::IPCThreadState()
     mIn.setDataCapacity(256);
     mOut.setDataCapacity(256);
     mIPCThreadStateBase = IPCThreadStateBase::self();
+
+    pthread_mutex_lock(&mProcess->mThreadCountLock);
+    mProcess->mThreadStates.add(this);
+    pthread_mutex_unlock(&mProcess->mThreadCountLock);
 }
 
 IPCThreadState::~IPCThreadState()
 {
+    pthread_mutex_lock(&mProcess->mThreadCountLock);
+    const ssize_t index = mProcess->mThreadStates.indexOf(this);
+    if (index >= 0) {
+        mProcess->mThreadStates.removeAt(index);
+    }
+    pthread_mutex_unlock(&mProcess->mThreadCountLock);
+
+    for (size_t i = 0; i < mBatchedOnewayData.size(); i++) {
+        delete mBatchedOnewayData[i];
+    }
 }
 
 status_t IPCThreadState::sendReply(const Parcel& reply, uint32_t flags)
@@ -849,6 +946,9 @@ status_t IPCThreadState::waitForResponse(Parcel *reply, status_t *acquireResult)
         switch (cmd) {
         case BR_TRANSACTION_COMPLETE:
             if (!reply && !acquireResult) goto finish;
+            // A complete consumed while waiting for something else
+            // acknowledges a previously batched oneway transaction.
+            if (mPendingBatchedOneway > 0) mPendingBatchedOneway--;
             break;
 
         case BR_DEAD_REPLY:
@@ -1205,22 +1305,47 @@ status_t IPCThreadState::executeCommand(int32_t cmd)
                     << ", offsets addr="
                     << reinterpret_cast<const size_t*>(tr.data.ptr.offsets) << endl;
             }
+            mInFlightTarget.store(tr.cookie, std::memory_order_relaxed);
+            mInFlightCode.store(tr.code, std::memory_order_relaxed);
+            mInFlightCallerPid.store(tr.sender_pid, std::memory_order_relaxed);
+            mInFlightStartMs.store(uptimeMillis(), std::memory_order_relaxed);
+
+            const bool recordLatency = ProcessState::isBinderLatencyEnabled();
+            nsecs_t executeStart = 0;
+            const String16* latencyKey = nullptr;
+
             if (tr.target.ptr) {
                 // We only have a weak reference on the target object, so we must first try to
                 // safely acquire a strong reference before doing anything else with it.
                 if (reinterpret_cast<RefBase::weakref_type*>(
                         tr.target.ptr)->attemptIncStrong(this)) {
-                    error = reinterpret_cast<BBinder*>(tr.cookie)->transact(tr.code, buffer,
-                            &reply, tr.flags);
-                    reinterpret_cast<BBinder*>(tr.cookie)->decStrong(this);
+                    BBinder* b = reinterpret_cast<BBinder*>(tr.cookie);
+                    if (recordLatency) {
+                        // descriptors are static per interface class, so the
+                        // pointer is a stable, allocation-free histogram key
+                        latencyKey = &b->getInterfaceDescriptor();
+                        executeStart = systemTime();
+                    }
+                    error = b->transact(tr.code, buffer, &reply, tr.flags);
+                    b->decStrong(this);
                 } else {
                     error = UNKNOWN_TRANSACTION;
                 }
 
             } else {
+                if (recordLatency) {
+                    latencyKey = &the_context_object->getInterfaceDescriptor();
+                    executeStart = systemTime();
+                }
                 error = the_context_object->transact(tr.code, buffer, &reply, tr.flags);
             }
 
+            if (recordLatency && latencyKey != nullptr) {
+                recordTransactionLatency(latencyKey, systemTime() - executeStart);
+            }
+
+            mInFlightTarget.store(0, std::memory_order_relaxed);
+
             mIPCThreadStateBase->popCurrentState();
             //ALOGI("<<<< TRANSACT from pid %d restore pid %d sid %s uid %d\n",
             //     mCallingPid, origPid, (origSid ? origSid : "<N/A>"), origUid);
@@ -1271,6 +1396,13 @@ status_t IPCThreadState::executeCommand(int32_t cmd)
     case BR_NOOP:
         break;
 
+    case BR_TRANSACTION_COMPLETE:
+        // Acknowledgement for a batched oneway transaction that was
+        // flushed by a pool thread's read loop rather than by
+        // flushBatchedOneway(); nothing further to do.
+        if (mPendingBatchedOneway > 0) mPendingBatchedOneway--;
+        break;
+
     case BR_SPAWN_LOOPER:
         mProcess->spawnPooledThread(false);
         break;
@@ -1292,6 +1424,36 @@ bool IPCThreadState::isServingCall() const {
     return mIPCThreadStateBase->getCurrentBinderCallState() == IPCThreadStateBase::CallState::BINDER;
 }
 
+void IPCThreadState::recordTransactionLatency(const String16* descriptor, nsecs_t durationNs) {
+    // Structural changes to the map (first sighting of an interface, reset)
+    // must not race the merge in getBinderLatencyStats(), which iterates it
+    // under mThreadCountLock.  Steady-state updates of existing entries stay
+    // lock-free; only their values can tear under the reader.
+    const uint32_t generation =
+            mProcess->mLatencyStatsGeneration.load(std::memory_order_relaxed);
+    auto it = mLatencyStats.find(descriptor);
+    if (generation != mLatencyStatsGeneration || it == mLatencyStats.end()) {
+        pthread_mutex_lock(&mProcess->mThreadCountLock);
+        if (generation != mLatencyStatsGeneration) {
+            mLatencyStats.clear();
+            mLatencyStatsGeneration = generation;
+        }
+        it = mLatencyStats.emplace(descriptor, LatencyHistogram()).first;
+        pthread_mutex_unlock(&mProcess->mThreadCountLock);
+    }
+
+    LatencyHistogram& hist = it->second;
+    hist.count++;
+    hist.totalNs += durationNs;
+    uint64_t us = durationNs > 0 ? static_cast<uint64_t>(durationNs) / 1000 : 0;
+    size_t bucket = 0;
+    while (us > 1 && bucket < 15) {
+        us >>= 1;
+        bucket++;
+    }
+    hist.buckets[bucket]++;
+}
+
 void IPCThreadState::threadDestructor(void *st)
 {
         IPCThreadState* const self = static_cast<IPCThreadState*>(st);
@@ -154,8 +154,12 @@ public:
             property_get("sys.boot_completed", bootCompleted, "0");
             gSystemBootCompleted = strcmp(bootCompleted, "1") == 0 ? true : false;
         }
-        // retry interval in millisecond; note that vendor services stay at 100ms
-        const long sleepTime = gSystemBootCompleted ? 1000 : 100;
+        // Retry with a ramping interval: most services appear within
+        // milliseconds of the first miss, so fixed one-second sleeps turn
+        // boot-time acquisition into latency spikes.  The interval doubles
+        // from 10ms up to the old cap (vendor services stay at 100ms).
+        const long maxSleepTime = gSystemBootCompleted ? 1000 : 100;
+        long sleepTime = 10;
 
         int n = 0;
         while (uptimeMillis() < timeout) {
@@ -163,6 +167,9 @@ public:
             ALOGI("Waiting for service '%s' on '%s'...", String8(name).string(),
                 ProcessState::self()->getDriverName().c_str());
             usleep(1000*sleepTime);
+            if (sleepTime < maxSleepTime) {
+                sleepTime = sleepTime * 2 < maxSleepTime ? sleepTime * 2 : maxSleepTime;
+            }
 
             sp<IBinder> svc = checkService(name);
             if (svc != nullptr) return svc;
@@ -38,6 +38,8 @@
 #include <sys/mman.h>
 #include <sys/file.h>
 
+#include <map>
+
 namespace android {
 // ----------------------------------------------------------------------------
 
@@ -139,25 +141,36 @@ public:
 
 private:
 
+    struct chunk_t;
+    typedef std::multimap<size_t, chunk_t*> free_index_t;
+
     struct chunk_t {
         chunk_t(size_t start, size_t size)
-        : start(start), size(size), free(1), prev(nullptr), next(nullptr) {
+        : start(start), size(size), free(1), indexed(false),
+          prev(nullptr), next(nullptr) {
         }
         size_t              start;
         size_t              size : 28;
-        int                 free : 4;
+        int                 free : 3;
+        unsigned int        indexed : 1;
+        free_index_t::iterator indexPos;
         mutable chunk_t*    prev;
         mutable chunk_t*    next;
     };
 
     ssize_t  alloc(size_t size, uint32_t flags);
     chunk_t* dealloc(size_t start);
+    void     indexInsert(chunk_t* chunk);
+    void     indexRemove(chunk_t* chunk);
     void     dump_l(const char* what) const;
     void     dump_l(String8& res, const char* what) const;
 
     static const int    kMemoryAlign;
     mutable Mutex       mLock;
     LinkedList<chunk_t> mList;
+    // Free chunks indexed by size, so the best fit is a lower_bound() away instead of a walk
+    // of every chunk.  mList stays authoritative and address-ordered for coalescing.
+    free_index_t        mFreeBySize;
     size_t              mHeapSize;
 };
 
@@ -284,6 +297,7 @@ SimpleBestFitAllocator::SimpleBestFitAllocator(size_t size)
 
     chunk_t* node = new chunk_t(0, mHeapSize / kMemoryAlign);
     mList.insertHead(node);
+    indexInsert(node);
 }
 
 SimpleBestFitAllocator::~SimpleBestFitAllocator()
@@ -323,6 +337,20 @@ status_t SimpleBestFitAllocator::deallocate(size_t offset)
     return NAME_NOT_FOUND;
 }
 
+void SimpleBestFitAllocator::indexInsert(chunk_t* chunk)
+{
+    chunk->indexPos = mFreeBySize.emplace(size_t(chunk->size), chunk);
+    chunk->indexed = true;
+}
+
+void SimpleBestFitAllocator::indexRemove(chunk_t* chunk)
+{
+    if (chunk->indexed) {
+        mFreeBySize.erase(chunk->indexPos);
+        chunk->indexed = false;
+    }
+}
+
 ssize_t SimpleBestFitAllocator::alloc(size_t size, uint32_t flags)
 {
     if (size == 0) {
@@ -330,27 +358,37 @@ ssize_t SimpleBestFitAllocator::alloc(size_t size, uint32_t flags)
     }
     size = (size + kMemoryAlign-1) / kMemoryAlign;
     chunk_t* free_chunk = nullptr;
-    chunk_t* cur = mList.head();
 
     size_t pagesize = getpagesize();
-    while (cur) {
-        int extra = 0;
-        if (flags & PAGE_ALIGNED)
-            extra = ( -cur->start & ((pagesize/kMemoryAlign)-1) ) ;
-
-        // best fit
-        if (cur->free && (cur->size >= (size+extra))) {
-            if ((!free_chunk) || (cur->size < free_chunk->size)) {
-                free_chunk = cur;
-            }
-            if (cur->size == size) {
-                break;
+    if (!(flags & PAGE_ALIGNED)) {
+        // The smallest adequate chunk is the best fit.
+        free_index_t::iterator it = mFreeBySize.lower_bound(size);
+        if (it != mFreeBySize.end()) {
+            free_chunk = it->second;
+        }
+    } else {
+        // The alignment padding depends on each chunk's start, so the size index cannot answer
+        // this query; walk the list the way the allocator always has.  No caller in the tree
+        // requests page alignment, so this path is cold.
+        chunk_t* cur = mList.head();
+        while (cur) {
+            const int extra = ( -cur->start & ((pagesize/kMemoryAlign)-1) ) ;
+
+            // best fit
+            if (cur->free && (cur->size >= (size+extra))) {
+                if ((!free_chunk) || (cur->size < free_chunk->size)) {
+                    free_chunk = cur;
+                }
+                if (cur->size == size) {
+                    break;
+                }
             }
+            cur = cur->next;
         }
-        cur = cur->next;
     }
 
     if (free_chunk) {
+        indexRemove(free_chunk);
         const size_t free_size = free_chunk->size;
         free_chunk->free = 0;
         free_chunk->size = size;
@@ -362,6 +400,7 @@ ssize_t SimpleBestFitAllocator::alloc(size_t size, uint32_t flags)
                 chunk_t* split = new chunk_t(free_chunk->start, extra);
                 free_chunk->start += extra;
                 mList.insertBefore(free_chunk, split);
+                indexInsert(split);
             }
 
             ALOGE_IF((flags&PAGE_ALIGNED) && 
@@ -373,6 +412,7 @@ ssize_t SimpleBestFitAllocator::alloc(size_t size, uint32_t flags)
                 chunk_t* split = new chunk_t(
                         free_chunk->start + free_chunk->size, tail_free);
                 mList.insertAfter(free_chunk, split);
+                indexInsert(split);
             }
         }
         return (free_chunk->start)*kMemoryAlign;
@@ -398,8 +438,10 @@ SimpleBestFitAllocator::chunk_t* SimpleBestFitAllocator::dealloc(size_t start)
                 chunk_t* const n = cur->next;
                 if (p && (p->free || !cur->size)) {
                     freed = p;
+                    indexRemove(p); // size is about to change
                     p->size += cur->size;
                     mList.remove(cur);
+                    indexRemove(cur);
                     delete cur;
                 }
                 cur = n;
@@ -414,6 +456,12 @@ SimpleBestFitAllocator::chunk_t* SimpleBestFitAllocator::dealloc(size_t start)
                 "freed block at offset 0x%08lX of size 0x%08lX is not free!",
                 freed->start * kMemoryAlign, freed->size * kMemoryAlign);
 
+            if (freed->free) {
+                // re-index under the merged size
+                indexRemove(freed);
+                indexInsert(freed);
+            }
+
             return freed;
         }
         cur = cur->next;
@@ -478,6 +526,20 @@ void SimpleBestFitAllocator::dump_l(String8& result,
     snprintf(buffer, SIZE,
             "  size allocated: %u (%u KB)\n", int(size), int(size/1024));
     result.append(buffer);
+
+    // free chunks per size class, from the best-fit index
+    result.append("  free chunks by size:\n");
+    free_index_t::const_iterator it = mFreeBySize.begin();
+    while (it != mFreeBySize.end()) {
+        const size_t chunkSize = it->first;
+        size_t count = 0;
+        for (; it != mFreeBySize.end() && it->first == chunkSize; ++it) {
+            count++;
+        }
+        snprintf(buffer, SIZE, "    0x%08X x %zu\n",
+                int(chunkSize*kMemoryAlign), count);
+        result.append(buffer);
+    }
 }
 
 
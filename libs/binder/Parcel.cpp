@@ -17,6 +17,10 @@
 #define LOG_TAG "Parcel"
 //#define LOG_NDEBUG 0
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <type_traits>
 #include <errno.h>
 #include <fcntl.h>
 #include <inttypes.h>
@@ -84,6 +88,111 @@ static size_t gParcelGlobalAllocCount = 0;
 
 static size_t gMaxFds = 0;
 
+// Per-thread cache of recently freed write buffers.  Binder-heavy threads
+// construct and tear down a Parcel on every transaction; recycling the
+// backing allocation per thread keeps that churn off the global heap.
+// Disabled by default; see ProcessState::setThreadParcelCachingEnabled().
+static std::atomic<bool> gThreadBufferCacheEnabled(false);
+
+struct ThreadBufferCache {
+    static const size_t kMaxEntries = 4;
+    // Buffers larger than this go back to the heap rather than staying
+    // pinned to one thread.
+    static const size_t kMaxCachedCapacity = 64 * 1024;
+
+    struct Entry {
+        uint8_t* data;
+        size_t capacity;
+    };
+    Entry entries[kMaxEntries];
+    size_t count = 0;
+    // Cleared by the destructor so Parcels torn down after this
+    // thread-local during thread exit fall back to the heap.
+    bool alive = true;
+    // High-water mark of capacities requested on this thread; fresh
+    // allocations are rounded up to it so recycled buffers converge on a
+    // size that satisfies the thread's steady-state transactions.
+    size_t highWater = 0;
+
+    ~ThreadBufferCache() {
+        for (size_t i = 0; i < count; i++) {
+            free(entries[i].data);
+        }
+        count = 0;
+        alive = false;
+    }
+
+    uint8_t* take(size_t desired, size_t* actualCapacity) {
+        size_t best = count;
+        for (size_t i = 0; i < count; i++) {
+            if (entries[i].capacity >= desired
+                    && (best == count || entries[i].capacity < entries[best].capacity)) {
+                best = i;
+            }
+        }
+        if (best == count) return nullptr;
+        uint8_t* data = entries[best].data;
+        *actualCapacity = entries[best].capacity;
+        entries[best] = entries[--count];
+        return data;
+    }
+
+    bool put(uint8_t* data, size_t capacity) {
+        if (!alive || capacity == 0 || capacity > kMaxCachedCapacity) return false;
+        if (count == kMaxEntries) {
+            // Keep the set biased towards larger buffers: evict the
+            // smallest entry if the incoming one beats it.
+            size_t smallest = 0;
+            for (size_t i = 1; i < kMaxEntries; i++) {
+                if (entries[i].capacity < entries[smallest].capacity) smallest = i;
+            }
+            if (entries[smallest].capacity >= capacity) return false;
+            free(entries[smallest].data);
+            entries[smallest].data = data;
+            entries[smallest].capacity = capacity;
+            return true;
+        }
+        entries[count].data = data;
+        entries[count].capacity = capacity;
+        count++;
+        return true;
+    }
+};
+static thread_local ThreadBufferCache gThreadBufferCache;
+
+// Allocates a parcel data buffer, preferring the per-thread cache when
+// enabled.  *capacity holds the desired size on entry and the actual
+// capacity of the returned buffer on exit.
+static uint8_t* allocParcelData(size_t* capacity) {
+    if (gThreadBufferCacheEnabled.load(std::memory_order_relaxed)) {
+        const size_t desired = *capacity;
+        if (desired > gThreadBufferCache.highWater
+                && desired <= ThreadBufferCache::kMaxCachedCapacity) {
+            gThreadBufferCache.highWater = desired;
+        }
+        size_t actual = 0;
+        uint8_t* data = gThreadBufferCache.take(desired, &actual);
+        if (data == nullptr && gThreadBufferCache.highWater > desired) {
+            actual = gThreadBufferCache.highWater;
+            data = (uint8_t*)malloc(actual);
+        }
+        if (data != nullptr) {
+            *capacity = actual;
+            return data;
+        }
+    }
+    return (uint8_t*)malloc(*capacity);
+}
+
+// Returns true if the buffer was parked in the per-thread cache; the
+// caller frees it otherwise.
+static bool recycleParcelData(uint8_t* data, size_t capacity) {
+    if (!gThreadBufferCacheEnabled.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    return gThreadBufferCache.put(data, capacity);
+}
+
 // Maximum size of a blob to transfer in-place.
 static const size_t BLOB_INPLACE_LIMIT = 16 * 1024;
 
@@ -375,14 +484,19 @@ size_t Parcel::getGlobalAllocCount() {
     return count;
 }
 
+void Parcel::setThreadBufferCachingEnabled(bool enabled) {
+    gThreadBufferCacheEnabled.store(enabled, std::memory_order_relaxed);
+}
+
 const uint8_t* Parcel::data() const
 {
+    if (mReferencedSegments != nullptr) flattenReferencedData();
     return mData;
 }
 
 size_t Parcel::dataSize() const
 {
-    return (mDataSize > mDataPos ? mDataSize : mDataPos);
+    return (mDataSize > mDataPos ? mDataSize : mDataPos) + mReferencedSize;
 }
 
 size_t Parcel::dataAvail() const
@@ -413,6 +527,12 @@ status_t Parcel::setDataSize(size_t size)
     }
 
     status_t err;
+    if (mReferencedSegments != nullptr) {
+        // Resizing can move mDataSize below a pending segment's insertion
+        // point; splice the segments in first so positions stay valid.
+        err = flattenReferencedData();
+        if (err != NO_ERROR) return err;
+    }
     err = continueWrite(size);
     if (err == NO_ERROR) {
         mDataSize = size;
@@ -429,6 +549,7 @@ void Parcel::setDataPosition(size_t pos) const
         abort();
     }
 
+    if (mReferencedSegments != nullptr) flattenReferencedData();
     mDataPos = pos;
     mNextObjectHint = 0;
     mObjectsSorted = false;
@@ -466,6 +587,10 @@ status_t Parcel::setData(const uint8_t* buffer, size_t len)
 status_t Parcel::appendFrom(const Parcel *parcel, size_t offset, size_t len)
 {
     status_t err;
+    if (parcel->mReferencedSegments != nullptr) {
+        err = parcel->flattenReferencedData();
+        if (err != NO_ERROR) return err;
+    }
     const uint8_t *data = parcel->mData;
     const binder_size_t *objects = parcel->mObjects;
     size_t size = parcel->mObjectsSize;
@@ -873,6 +998,45 @@ status_t writeByteVectorInternalPtr(Parcel* parcel,
     return writeByteVectorInternal(parcel, *val);
 }
 
+// Bulk path for 4/8-byte primitive vectors.  Each per-element write of these
+// types lands sizeof(T) bytes at 4-byte alignment with no padding, so the
+// packed array has exactly the wire layout of the element-by-element loop --
+// one length check and one memcpy replace size() write calls.
+template <typename T>
+status_t writePrimitiveVectorInternal(Parcel* parcel, const std::vector<T>& val)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "need a trivially copyable type");
+    static_assert(sizeof(T) % sizeof(int32_t) == 0, "element writes would be padded");
+
+    if (val.size() > std::numeric_limits<int32_t>::max() / sizeof(T)) {
+        return BAD_VALUE;
+    }
+
+    status_t status = parcel->writeInt32(val.size());
+    if (status != OK) {
+        return status;
+    }
+
+    void* data = parcel->writeInplace(val.size() * sizeof(T));
+    if (!data) {
+        return BAD_VALUE;
+    }
+
+    memcpy(data, val.data(), val.size() * sizeof(T));
+    return OK;
+}
+
+template <typename T>
+status_t writePrimitiveVectorInternalPtr(Parcel* parcel,
+                                         const std::unique_ptr<std::vector<T>>& val)
+{
+    if (!val) {
+        return parcel->writeInt32(-1);
+    }
+
+    return writePrimitiveVectorInternal(parcel, *val);
+}
+
 }  // namespace
 
 status_t Parcel::writeByteVector(const std::vector<int8_t>& val) {
@@ -895,52 +1059,52 @@ status_t Parcel::writeByteVector(const std::unique_ptr<std::vector<uint8_t>>& va
 
 status_t Parcel::writeInt32Vector(const std::vector<int32_t>& val)
 {
-    return writeTypedVector(val, &Parcel::writeInt32);
+    return writePrimitiveVectorInternal(this, val);
 }
 
 status_t Parcel::writeInt32Vector(const std::unique_ptr<std::vector<int32_t>>& val)
 {
-    return writeNullableTypedVector(val, &Parcel::writeInt32);
+    return writePrimitiveVectorInternalPtr(this, val);
 }
 
 status_t Parcel::writeInt64Vector(const std::vector<int64_t>& val)
 {
-    return writeTypedVector(val, &Parcel::writeInt64);
+    return writePrimitiveVectorInternal(this, val);
 }
 
 status_t Parcel::writeInt64Vector(const std::unique_ptr<std::vector<int64_t>>& val)
 {
-    return writeNullableTypedVector(val, &Parcel::writeInt64);
+    return writePrimitiveVectorInternalPtr(this, val);
 }
 
 status_t Parcel::writeUint64Vector(const std::vector<uint64_t>& val)
 {
-    return writeTypedVector(val, &Parcel::writeUint64);
+    return writePrimitiveVectorInternal(this, val);
 }
 
 status_t Parcel::writeUint64Vector(const std::unique_ptr<std::vector<uint64_t>>& val)
 {
-    return writeNullableTypedVector(val, &Parcel::writeUint64);
+    return writePrimitiveVectorInternalPtr(this, val);
 }
 
 status_t Parcel::writeFloatVector(const std::vector<float>& val)
 {
-    return writeTypedVector(val, &Parcel::writeFloat);
+    return writePrimitiveVectorInternal(this, val);
 }
 
 status_t Parcel::writeFloatVector(const std::unique_ptr<std::vector<float>>& val)
 {
-    return writeNullableTypedVector(val, &Parcel::writeFloat);
+    return writePrimitiveVectorInternalPtr(this, val);
 }
 
 status_t Parcel::writeDoubleVector(const std::vector<double>& val)
 {
-    return writeTypedVector(val, &Parcel::writeDouble);
+    return writePrimitiveVectorInternal(this, val);
 }
 
 status_t Parcel::writeDoubleVector(const std::unique_ptr<std::vector<double>>& val)
 {
-    return writeNullableTypedVector(val, &Parcel::writeDouble);
+    return writePrimitiveVectorInternalPtr(this, val);
 }
 
 status_t Parcel::writeBoolVector(const std::vector<bool>& val)
@@ -1312,6 +1476,153 @@ status_t Parcel::writeBlob(size_t len, bool mutableCopy, WritableBlob* outBlob)
     return status;
 }
 
+status_t Parcel::writeReferencedData(const void* buffer, size_t len,
+                                     referenced_release_func relFunc, void* relCookie)
+{
+    if (len > INT32_MAX) {
+        // don't accept size_t values which may have come from an
+        // inadvertent conversion from a negative int.
+        if (relFunc) relFunc(buffer, len, relCookie);
+        return BAD_VALUE;
+    }
+
+    if (mOwner) {
+        // Parcels wrapping externally-owned data cannot accept writes.
+        if (relFunc) relFunc(buffer, len, relCookie);
+        return INVALID_OPERATION;
+    }
+
+    if (mDataPos < mDataSize) {
+        // Splicing a reference into the middle of the stream would
+        // invalidate positions of data written after it; fall back to
+        // the copying path.
+        void* const dst = writeInplace(len);
+        status_t err = NO_ERROR;
+        if (dst != nullptr) {
+            memcpy(dst, buffer, len);
+        } else {
+            err = mError != NO_ERROR ? mError : NO_MEMORY;
+        }
+        if (relFunc) relFunc(buffer, len, relCookie);
+        return err;
+    }
+
+    if (mReferencedSegments == nullptr) {
+        mReferencedSegments = new (std::nothrow) std::vector<ReferencedSegment>();
+        if (mReferencedSegments == nullptr) {
+            if (relFunc) relFunc(buffer, len, relCookie);
+            return NO_MEMORY;
+        }
+    }
+
+    ReferencedSegment seg;
+    seg.insertPos = mDataPos;
+    seg.data = buffer;
+    seg.len = len;
+    seg.relFunc = relFunc;
+    seg.relCookie = relCookie;
+    mReferencedSegments->push_back(seg);
+    mReferencedSize += pad_size(len);
+    LOG_ALLOC("Parcel %p: referenced %zu bytes at %zu (pending %zu)",
+            this, len, seg.insertPos, mReferencedSize);
+    return NO_ERROR;
+}
+
+status_t Parcel::flattenReferencedData() const
+{
+    if (mReferencedSegments == nullptr || mReferencedSegments->empty()) {
+        return NO_ERROR;
+    }
+
+    Parcel* self = const_cast<Parcel*>(this);
+    std::vector<ReferencedSegment>& segs = *self->mReferencedSegments;
+
+    const size_t newSize = mDataSize + mReferencedSize;
+    if (newSize < mDataSize || newSize > INT32_MAX) {
+        // Drop the segments so dataSize() stays consistent with mData.
+        self->releaseReferencedData();
+        self->mError = NO_MEMORY;
+        return NO_MEMORY;
+    }
+
+    uint8_t* data = (uint8_t*)malloc(newSize);
+    if (data == nullptr) {
+        self->releaseReferencedData();
+        self->mError = NO_MEMORY;
+        return NO_MEMORY;
+    }
+
+    LOG_ALLOC("Parcel %p: flattening %zu referenced segments into %zu bytes",
+            this, segs.size(), newSize);
+
+    // Interleave the contiguous buffer with the referenced segments,
+    // padding each segment like writeInplace() would have.
+    size_t srcPos = 0;
+    size_t dstPos = 0;
+    for (const ReferencedSegment& seg : segs) {
+        const size_t run = seg.insertPos - srcPos;
+        memcpy(data + dstPos, mData + srcPos, run);
+        srcPos += run;
+        dstPos += run;
+        memcpy(data + dstPos, seg.data, seg.len);
+        dstPos += seg.len;
+        const size_t padded = pad_size(seg.len);
+        if (padded != seg.len) {
+            memset(data + dstPos, 0, padded - seg.len);
+            dstPos += padded - seg.len;
+        }
+    }
+    memcpy(data + dstPos, mData + srcPos, mDataSize - srcPos);
+
+    // Object offsets recorded after a segment's insertion point shift by
+    // the padded sizes of all segments spliced in before them.
+    for (size_t i = 0; i < mObjectsSize; i++) {
+        size_t shift = 0;
+        for (const ReferencedSegment& seg : segs) {
+            if (seg.insertPos > mObjects[i]) break;
+            shift += pad_size(seg.len);
+        }
+        self->mObjects[i] += shift;
+    }
+
+    size_t posShift = 0;
+    for (const ReferencedSegment& seg : segs) {
+        if (seg.insertPos > mDataPos) break;
+        posShift += pad_size(seg.len);
+    }
+
+    pthread_mutex_lock(&gParcelGlobalAllocSizeLock);
+    gParcelGlobalAllocSize += newSize;
+    gParcelGlobalAllocSize -= mDataCapacity;
+    if (!mData) {
+        gParcelGlobalAllocCount++;
+    }
+    pthread_mutex_unlock(&gParcelGlobalAllocSizeLock);
+
+    if (mData) {
+        free(self->mData);
+    }
+    self->mData = data;
+    self->mDataSize = newSize;
+    self->mDataCapacity = newSize;
+    self->mDataPos = mDataPos + posShift;
+    self->releaseReferencedData();
+    return NO_ERROR;
+}
+
+void Parcel::releaseReferencedData()
+{
+    if (mReferencedSegments == nullptr) return;
+    for (const ReferencedSegment& seg : *mReferencedSegments) {
+        if (seg.relFunc) {
+            seg.relFunc(seg.data, seg.len, seg.relCookie);
+        }
+    }
+    delete mReferencedSegments;
+    mReferencedSegments = nullptr;
+    mReferencedSize = 0;
+}
+
 status_t Parcel::writeDupImmutableBlobFileDescriptor(int fd)
 {
     // Must match up with what's done in writeBlob.
@@ -1596,6 +1907,8 @@ status_t Parcel::read(void* outData, size_t len) const
         return BAD_VALUE;
     }
 
+    if (mReferencedSegments != nullptr) flattenReferencedData();
+
     if ((mDataPos+pad_size(len)) >= mDataPos && (mDataPos+pad_size(len)) <= mDataSize
             && len <= pad_size(len)) {
         if (mObjectsSize > 0) {
@@ -1623,6 +1936,8 @@ const void* Parcel::readInplace(size_t len) const
         return nullptr;
     }
 
+    if (mReferencedSegments != nullptr) flattenReferencedData();
+
     if ((mDataPos+pad_size(len)) >= mDataPos && (mDataPos+pad_size(len)) <= mDataSize
             && len <= pad_size(len)) {
         if (mObjectsSize > 0) {
@@ -1647,6 +1962,8 @@ template<class T>
 status_t Parcel::readAligned(T *pArg) const {
     COMPILE_TIME_ASSERT_FUNCTION_SCOPE(PAD_SIZE_UNSAFE(sizeof(T)) == sizeof(T));
 
+    if (mReferencedSegments != nullptr) flattenReferencedData();
+
     if ((mDataPos+sizeof(T)) <= mDataSize) {
         if (mObjectsSize > 0) {
             status_t err = validateReadData(mDataPos + sizeof(T));
@@ -1725,6 +2042,58 @@ status_t readByteVectorInternal(const Parcel* parcel,
     return status;
 }
 
+// Bulk read for 4/8-byte primitive vectors; see writePrimitiveVectorInternal
+// for the layout argument.  readInplace() performs the same object-overlap
+// validation the per-element reads did.
+template <typename T>
+status_t readPrimitiveVectorInternal(const Parcel* parcel, std::vector<T>* val) {
+    static_assert(std::is_trivially_copyable<T>::value, "need a trivially copyable type");
+    val->clear();
+
+    int32_t size;
+    status_t status = parcel->readInt32(&size);
+    if (status != OK) {
+        return status;
+    }
+    if (size < 0) {
+        return UNEXPECTED_NULL;
+    }
+    if (size_t(size) > parcel->dataAvail() / sizeof(T)) {
+        return BAD_VALUE;
+    }
+
+    const T* data = reinterpret_cast<const T*>(parcel->readInplace(size_t(size) * sizeof(T)));
+    if (!data) {
+        return BAD_VALUE;
+    }
+    val->reserve(size);
+    val->insert(val->end(), data, data + size);
+
+    return OK;
+}
+
+template <typename T>
+status_t readPrimitiveVectorInternalPtr(const Parcel* parcel,
+                                        std::unique_ptr<std::vector<T>>* val) {
+    const int32_t start = parcel->dataPosition();
+    int32_t size;
+    status_t status = parcel->readInt32(&size);
+    val->reset();
+    if (status != OK || size < 0) {
+        return status;
+    }
+
+    parcel->setDataPosition(start);
+    val->reset(new std::vector<T>());
+
+    status = readPrimitiveVectorInternal(parcel, val->get());
+    if (status != OK) {
+        val->reset();
+    }
+
+    return status;
+}
+
 template<typename T>
 status_t readByteVectorInternalPtr(
         const Parcel* parcel,
@@ -1769,43 +2138,43 @@ status_t Parcel::readByteVector(std::unique_ptr<std::vector<uint8_t>>* val) cons
 }
 
 status_t Parcel::readInt32Vector(std::unique_ptr<std::vector<int32_t>>* val) const {
-    return readNullableTypedVector(val, &Parcel::readInt32);
+    return readPrimitiveVectorInternalPtr(this, val);
 }
 
 status_t Parcel::readInt32Vector(std::vector<int32_t>* val) const {
-    return readTypedVector(val, &Parcel::readInt32);
+    return readPrimitiveVectorInternal(this, val);
 }
 
 status_t Parcel::readInt64Vector(std::unique_ptr<std::vector<int64_t>>* val) const {
-    return readNullableTypedVector(val, &Parcel::readInt64);
+    return readPrimitiveVectorInternalPtr(this, val);
 }
 
 status_t Parcel::readInt64Vector(std::vector<int64_t>* val) const {
-    return readTypedVector(val, &Parcel::readInt64);
+    return readPrimitiveVectorInternal(this, val);
 }
 
 status_t Parcel::readUint64Vector(std::unique_ptr<std::vector<uint64_t>>* val) const {
-    return readNullableTypedVector(val, &Parcel::readUint64);
+    return readPrimitiveVectorInternalPtr(this, val);
 }
 
 status_t Parcel::readUint64Vector(std::vector<uint64_t>* val) const {
-    return readTypedVector(val, &Parcel::readUint64);
+    return readPrimitiveVectorInternal(this, val);
 }
 
 status_t Parcel::readFloatVector(std::unique_ptr<std::vector<float>>* val) const {
-    return readNullableTypedVector(val, &Parcel::readFloat);
+    return readPrimitiveVectorInternalPtr(this, val);
 }
 
 status_t Parcel::readFloatVector(std::vector<float>* val) const {
-    return readTypedVector(val, &Parcel::readFloat);
+    return readPrimitiveVectorInternal(this, val);
 }
 
 status_t Parcel::readDoubleVector(std::unique_ptr<std::vector<double>>* val) const {
-    return readNullableTypedVector(val, &Parcel::readDouble);
+    return readPrimitiveVectorInternalPtr(this, val);
 }
 
 status_t Parcel::readDoubleVector(std::vector<double>* val) const {
-    return readTypedVector(val, &Parcel::readDouble);
+    return readPrimitiveVectorInternal(this, val);
 }
 
 status_t Parcel::readBoolVector(std::unique_ptr<std::vector<bool>>* val) const {
@@ -2480,35 +2849,61 @@ const flat_binder_object* Parcel::readObject(bool nullMetaData) const
             ALOGV("Parcel %p looking for obj at %zu, hint=%zu",
                  this, DPOS, opos);
 
-            // Start at the current hint position, looking for an object at
-            // the current data position.
-            if (opos < N) {
-                while (opos < (N-1) && OBJS[opos] < DPOS) {
-                    opos++;
-                }
-            } else {
-                opos = N-1;
-            }
-            if (OBJS[opos] == DPOS) {
-                // Found it!
-                ALOGV("Parcel %p found obj %zu at index %zu with forward search",
-                     this, DPOS, opos);
+            // The cursor hint covers in-order reads: the next object is
+            // usually exactly at the hint.
+            if (opos < N && OBJS[opos] == DPOS) {
+                ALOGV("Parcel %p found obj %zu at hint index %zu", this, DPOS, opos);
                 mNextObjectHint = opos+1;
                 ALOGV("readObject Setting data pos of %p to %zu", this, mDataPos);
                 return obj;
             }
 
-            // Look backwards for it...
-            while (opos > 0 && OBJS[opos] > DPOS) {
-                opos--;
+            // Out-of-order read.  The offset table is sorted for any parcel
+            // written front to back (and validateReadData() sorts the rest),
+            // so verify once and binary search instead of walking the table
+            // linearly in both directions -- fd-heavy parcels read out of
+            // order degenerated quadratically on those walks.
+            if (!mObjectsSorted) {
+                bool sorted = true;
+                for (size_t i = 1; i < N; i++) {
+                    if (OBJS[i-1] > OBJS[i]) {
+                        sorted = false;
+                        break;
+                    }
+                }
+                mObjectsSorted = sorted;
             }
-            if (OBJS[opos] == DPOS) {
-                // Found it!
-                ALOGV("Parcel %p found obj %zu at index %zu with backward search",
-                     this, DPOS, opos);
-                mNextObjectHint = opos+1;
-                ALOGV("readObject Setting data pos of %p to %zu", this, mDataPos);
-                return obj;
+            if (mObjectsSorted) {
+                const binder_size_t* found = std::lower_bound(
+                        OBJS, OBJS + N, static_cast<binder_size_t>(DPOS));
+                if (found < OBJS + N && *found == static_cast<binder_size_t>(DPOS)) {
+                    const size_t index = static_cast<size_t>(found - OBJS);
+                    ALOGV("Parcel %p found obj %zu at index %zu with binary search",
+                         this, DPOS, index);
+                    mNextObjectHint = index+1;
+                    ALOGV("readObject Setting data pos of %p to %zu", this, mDataPos);
+                    return obj;
+                }
+            } else {
+                // Unsorted table (edited parcel): keep the legacy scans.
+                if (opos < N) {
+                    while (opos < (N-1) && OBJS[opos] < DPOS) {
+                        opos++;
+                    }
+                } else {
+                    opos = N-1;
+                }
+                if (OBJS[opos] == DPOS) {
+                    mNextObjectHint = opos+1;
+                    return obj;
+                }
+                while (opos > 0 && OBJS[opos] > DPOS) {
+                    opos--;
+                }
+                if (OBJS[opos] == DPOS) {
+                    mNextObjectHint = opos+1;
+                    return obj;
+                }
             }
         }
         ALOGW("Attempt to read object from Parcel %p at offset %zu that is not in the object list",
@@ -2536,16 +2931,19 @@ void Parcel::closeFileDescriptors()
 
 uintptr_t Parcel::ipcData() const
 {
+    if (mReferencedSegments != nullptr) flattenReferencedData();
     return reinterpret_cast<uintptr_t>(mData);
 }
 
 size_t Parcel::ipcDataSize() const
 {
+    if (mReferencedSegments != nullptr) flattenReferencedData();
     return (mDataSize > mDataPos ? mDataSize : mDataPos);
 }
 
 uintptr_t Parcel::ipcObjects() const
 {
+    if (mReferencedSegments != nullptr) flattenReferencedData();
     return reinterpret_cast<uintptr_t>(mObjects);
 }
 
@@ -2652,6 +3050,7 @@ void Parcel::freeData()
 
 void Parcel::freeDataNoInit()
 {
+    releaseReferencedData();
     if (mOwner) {
         LOG_ALLOC("Parcel %p: freeing other owner data", this);
         //ALOGI("Freeing data ref of %p (pid=%d)", this, getpid());
@@ -2671,7 +3070,9 @@ void Parcel::freeDataNoInit()
               gParcelGlobalAllocCount--;
             }
             pthread_mutex_unlock(&gParcelGlobalAllocSizeLock);
-            free(mData);
+            if (!recycleParcelData(mData, mDataCapacity)) {
+                free(mData);
+            }
         }
         if (mObjects) free(mObjects);
     }
@@ -2699,6 +3100,9 @@ status_t Parcel::restartWrite(size_t desired)
         return BAD_VALUE;
     }
 
+    // Restarting discards all pending writes, referenced ones included.
+    releaseReferencedData();
+
     if (mOwner) {
         freeData();
         return continueWrite(desired);
@@ -2882,7 +3286,8 @@ status_t Parcel::continueWrite(size_t desired)
 
     } else {
         // This is the first data.  Easy!
-        uint8_t* data = (uint8_t*)malloc(desired);
+        size_t capacity = desired;
+        uint8_t* data = allocParcelData(&capacity);
         if (!data) {
             mError = NO_MEMORY;
             return NO_MEMORY;
@@ -2893,9 +3298,9 @@ status_t Parcel::continueWrite(size_t desired)
             ALOGE("continueWrite: %zu/%p/%zu/%zu", mDataCapacity, mObjects, mObjectsCapacity, desired);
         }
 
-        LOG_ALLOC("Parcel %p: allocating with %zu capacity", this, desired);
+        LOG_ALLOC("Parcel %p: allocating with %zu capacity", this, capacity);
         pthread_mutex_lock(&gParcelGlobalAllocSizeLock);
-        gParcelGlobalAllocSize += desired;
+        gParcelGlobalAllocSize += capacity;
         gParcelGlobalAllocCount++;
         pthread_mutex_unlock(&gParcelGlobalAllocSizeLock);
 
@@ -2903,7 +3308,7 @@ status_t Parcel::continueWrite(size_t desired)
         mDataSize = mDataPos = 0;
         ALOGV("continueWrite Setting data size of %p to %zu", this, mDataSize);
         ALOGV("continueWrite Setting data pos of %p to %zu", this, mDataPos);
-        mDataCapacity = desired;
+        mDataCapacity = capacity;
     }
 
     return NO_ERROR;
@@ -2928,6 +3333,8 @@ void Parcel::initState()
     mFdsKnown = true;
     mAllowFds = true;
     mOwner = nullptr;
+    mReferencedSegments = nullptr;
+    mReferencedSize = 0;
     mOpenAshmemSize = 0;
     mWorkSourceRequestHeaderPosition = 0;
     mRequestHeaderPresent = false;
@@ -36,13 +36,25 @@ PermissionCache::PermissionCache() {
 
 status_t PermissionCache::check(bool* granted,
         const String16& permission, uid_t uid) const {
-    Mutex::Autolock _l(mLock);
+    // lock-free: hits only dereference the current immutable snapshot
+    std::shared_ptr<const SortedVector<Entry>> cache =
+            std::atomic_load_explicit(&mCache, std::memory_order_acquire);
+    if (cache == nullptr) {
+        return NAME_NOT_FOUND;
+    }
     Entry e;
     e.name = permission;
     e.uid  = uid;
-    ssize_t index = mCache.indexOf(e);
+    ssize_t index = cache->indexOf(e);
     if (index >= 0) {
-        *granted = mCache.itemAt(index).granted;
+        const Entry& cached = cache->itemAt(index);
+        if (!cached.granted
+                && systemTime() - cached.checkTime > kDeniedValidityNs) {
+            // a stale denial: have the caller ask the permission
+            // controller again, in case it has been granted since
+            return NAME_NOT_FOUND;
+        }
+        *granted = cached.granted;
         return NO_ERROR;
     }
     return NAME_NOT_FOUND;
@@ -63,15 +75,32 @@ void PermissionCache::cache(const String16& permission,
     // permission checks
     e.uid  = uid;
     e.granted = granted;
-    index = mCache.indexOf(e);
+    e.checkTime = systemTime();
+
+    // copy-on-write: readers keep whatever snapshot they are holding
+    std::shared_ptr<const SortedVector<Entry>> current =
+            std::atomic_load_explicit(&mCache, std::memory_order_acquire);
+    auto updated = current != nullptr
+            ? std::make_shared<SortedVector<Entry>>(*current)
+            : std::make_shared<SortedVector<Entry>>();
+    index = updated->indexOf(e);
     if (index < 0) {
-        mCache.add(e);
+        updated->add(e);
+    } else {
+        // refresh the verdict and its timestamp (a denial may have been
+        // re-resolved after expiring)
+        updated->editItemAt(index) = e;
     }
+    std::atomic_store_explicit(&mCache,
+            std::shared_ptr<const SortedVector<Entry>>(std::move(updated)),
+            std::memory_order_release);
 }
 
 void PermissionCache::purge() {
     Mutex::Autolock _l(mLock);
-    mCache.clear();
+    std::atomic_store_explicit(&mCache,
+            std::shared_ptr<const SortedVector<Entry>>(),
+            std::memory_order_release);
 }
 
 bool PermissionCache::checkCallingPermission(const String16& permission) {
@@ -19,6 +19,7 @@
 #include <binder/PersistableBundle.h>
 #include <private/binder/ParcelValTypes.h>
 
+#include <algorithm>
 #include <limits>
 
 #include <binder/IBinder.h>
@@ -86,12 +87,138 @@ namespace os {
          }                                                               \
     }
 
+// Skips over a String16 in the parcel without materializing it.
+static status_t skipString16(const Parcel* parcel) {
+    int32_t size;
+    RETURN_IF_FAILED(parcel->readInt32(&size));
+    if (size < 0) return NO_ERROR;  // null string
+    const size_t bytes = (static_cast<size_t>(size) + 1) * sizeof(char16_t);
+    if (bytes > parcel->dataAvail()) return NOT_ENOUGH_DATA;
+    parcel->setDataPosition(parcel->dataPosition() + ((bytes + 3) & ~static_cast<size_t>(3)));
+    return NO_ERROR;
+}
+
+// Advances the parcel past one value of the given type, validating sizes
+// against the remaining data so a corrupt length cannot push the position
+// past the end.
+static status_t skipValue(const Parcel* parcel, int32_t value_type) {
+    switch (value_type) {
+        case VAL_BOOLEAN:
+        case VAL_INTEGER: {
+            int32_t dummy;
+            RETURN_IF_FAILED(parcel->readInt32(&dummy));
+            break;
+        }
+        case VAL_LONG: {
+            int64_t dummy;
+            RETURN_IF_FAILED(parcel->readInt64(&dummy));
+            break;
+        }
+        case VAL_DOUBLE: {
+            double dummy;
+            RETURN_IF_FAILED(parcel->readDouble(&dummy));
+            break;
+        }
+        case VAL_STRING: {
+            RETURN_IF_FAILED(skipString16(parcel));
+            break;
+        }
+        case VAL_BOOLEANARRAY:
+        case VAL_INTARRAY:
+        case VAL_LONGARRAY:
+        case VAL_DOUBLEARRAY: {
+            int32_t count;
+            RETURN_IF_FAILED(parcel->readInt32(&count));
+            if (count < 0) break;  // null vector
+            const size_t elem = (value_type == VAL_LONGARRAY || value_type == VAL_DOUBLEARRAY)
+                    ? sizeof(int64_t)
+                    : sizeof(int32_t);
+            const size_t bytes = static_cast<size_t>(count) * elem;
+            if (bytes > parcel->dataAvail()) return NOT_ENOUGH_DATA;
+            parcel->setDataPosition(parcel->dataPosition() + bytes);
+            break;
+        }
+        case VAL_STRINGARRAY: {
+            int32_t count;
+            RETURN_IF_FAILED(parcel->readInt32(&count));
+            for (int32_t i = 0; i < count; ++i) {
+                RETURN_IF_FAILED(skipString16(parcel));
+            }
+            break;
+        }
+        case VAL_PERSISTABLEBUNDLE: {
+            // Nested bundles are [length][magic][count + entries], where
+            // length covers everything after the magic.
+            int32_t length;
+            RETURN_IF_FAILED(parcel->readInt32(&length));
+            if (length == 0) break;
+            if (length < 0) return BAD_VALUE;
+            int32_t magic;
+            RETURN_IF_FAILED(parcel->readInt32(&magic));
+            if (magic != BUNDLE_MAGIC && magic != BUNDLE_MAGIC_NATIVE) {
+                ALOGE("Bad magic number for PersistableBundle: 0x%08x", magic);
+                return BAD_VALUE;
+            }
+            if (static_cast<size_t>(length) > parcel->dataAvail()) return NOT_ENOUGH_DATA;
+            parcel->setDataPosition(parcel->dataPosition() + static_cast<size_t>(length));
+            break;
+        }
+        default: {
+            ALOGE("Unrecognized type: %d", value_type);
+            return BAD_TYPE;
+        }
+    }
+    return NO_ERROR;
+}
+
+PersistableBundle::PersistableBundle(const PersistableBundle& bundle) {
+    *this = bundle;
+}
+
+PersistableBundle& PersistableBundle::operator=(const PersistableBundle& bundle) {
+    if (this == &bundle) return *this;
+    // Decode the source rather than cloning its raw bytes; copies are
+    // typically made to be mutated.
+    bundle.unparcel();
+    mLazy = nullptr;
+    mBoolMap = bundle.mBoolMap;
+    mIntMap = bundle.mIntMap;
+    mLongMap = bundle.mLongMap;
+    mDoubleMap = bundle.mDoubleMap;
+    mStringMap = bundle.mStringMap;
+    mBoolVectorMap = bundle.mBoolVectorMap;
+    mIntVectorMap = bundle.mIntVectorMap;
+    mLongVectorMap = bundle.mLongVectorMap;
+    mDoubleVectorMap = bundle.mDoubleVectorMap;
+    mStringVectorMap = bundle.mStringVectorMap;
+    mPersistableBundleMap = bundle.mPersistableBundleMap;
+    return *this;
+}
+
 status_t PersistableBundle::writeToParcel(Parcel* parcel) const {
     /*
      * Keep implementation in sync with writeToParcelInner() in
      * frameworks/base/core/java/android/os/BaseBundle.java.
      */
 
+    // A bundle that was received lazily and never mutated re-emits its raw
+    // bytes instead of re-serializing the maps.
+    if (mLazy) {
+        size_t length_pos = parcel->dataPosition();
+        RETURN_IF_FAILED(parcel->writeInt32(1));  // dummy, will hold length
+        RETURN_IF_FAILED(parcel->writeInt32(BUNDLE_MAGIC_NATIVE));
+
+        size_t start_pos = parcel->dataPosition();
+        RETURN_IF_FAILED(parcel->writeInt32(mLazy->numEntries));
+        RETURN_IF_FAILED(parcel->appendFrom(&mLazy->data, 0, mLazy->data.dataSize()));
+        size_t end_pos = parcel->dataPosition();
+
+        parcel->setDataPosition(length_pos);
+        RETURN_IF_FAILED(parcel->writeInt32(static_cast<int32_t>(end_pos - start_pos)));
+        parcel->setDataPosition(end_pos);
+        return NO_ERROR;
+    }
+
     // Special case for empty bundles.
     if (empty()) {
         RETURN_IF_FAILED(parcel->writeInt32(0));
@@ -128,8 +255,171 @@ status_t PersistableBundle::readFromParcel(const Parcel* parcel) {
         ALOGE("Bad length in parcel: %d", length);
         return UNEXPECTED_NULL;
     }
+    if (length == 0) {
+        // Empty PersistableBundle or end of data.
+        return NO_ERROR;
+    }
+
+    /*
+     * A bundle that already holds entries keeps the historical merge
+     * behavior and decodes eagerly; fresh bundles only index the key
+     * directory and decode values on first access.
+     */
+    if (size() != 0) {
+        unparcel();
+        return readFromParcelInner(parcel, static_cast<size_t>(length));
+    }
+
+    return initLazy(parcel);
+}
+
+status_t PersistableBundle::initLazy(const Parcel* parcel) {
+    int32_t magic;
+    RETURN_IF_FAILED(parcel->readInt32(&magic));
+    if (magic != BUNDLE_MAGIC && magic != BUNDLE_MAGIC_NATIVE) {
+        ALOGE("Bad magic number for PersistableBundle: 0x%08x", magic);
+        return BAD_VALUE;
+    }
 
-    return readFromParcelInner(parcel, static_cast<size_t>(length));
+    int32_t num_entries;
+    RETURN_IF_FAILED(parcel->readInt32(&num_entries));
+    if (num_entries < 0) {
+        ALOGE("Bad entry count in parcel: %d", num_entries);
+        return BAD_VALUE;
+    }
+    if (num_entries == 0) {
+        return NO_ERROR;
+    }
+
+    auto lazy = std::make_unique<LazyState>();
+    lazy->numEntries = num_entries;
+
+    // Shallow pass: record each key, type and value offset, skipping the
+    // value bytes without materializing them.
+    const size_t start_pos = parcel->dataPosition();
+    for (int32_t i = 0; i < num_entries; ++i) {
+        LazyEntry entry;
+        entry.decoded = false;
+        RETURN_IF_FAILED(parcel->readString16(&entry.key));
+        RETURN_IF_FAILED(parcel->readInt32(&entry.type));
+        entry.offset = parcel->dataPosition() - start_pos;
+        RETURN_IF_FAILED(skipValue(parcel, entry.type));
+        lazy->entries.push_back(std::move(entry));
+    }
+    const size_t end_pos = parcel->dataPosition();
+
+    RETURN_IF_FAILED(lazy->data.appendFrom(parcel, start_pos, end_pos - start_pos));
+
+    std::sort(lazy->entries.begin(), lazy->entries.end(),
+              [](const LazyEntry& lhs, const LazyEntry& rhs) { return lhs.key < rhs.key; });
+
+    mLazy = std::move(lazy);
+    return NO_ERROR;
+}
+
+void PersistableBundle::decodeKey(const String16& key) const {
+    if (!mLazy) return;
+    auto& entries = mLazy->entries;
+    auto it = std::lower_bound(entries.begin(), entries.end(), key,
+                               [](const LazyEntry& entry, const String16& k) {
+                                   return entry.key < k;
+                               });
+    if (it == entries.end() || it->key != key || it->decoded) return;
+    const_cast<PersistableBundle*>(this)->decodeLazyEntry(&*it);
+}
+
+void PersistableBundle::unparcel() const {
+    if (!mLazy) return;
+    PersistableBundle* self = const_cast<PersistableBundle*>(this);
+    for (LazyEntry& entry : mLazy->entries) {
+        if (!entry.decoded) self->decodeLazyEntry(&entry);
+    }
+    self->mLazy = nullptr;
+}
+
+status_t PersistableBundle::decodeLazyEntry(LazyEntry* entry) {
+    const Parcel* parcel = &mLazy->data;
+    parcel->setDataPosition(entry->offset);
+    // Don't retry a corrupt entry; the key simply stays absent.
+    entry->decoded = true;
+    const String16& key = entry->key;
+
+    // Values are read into locals and only committed on success so a
+    // corrupt entry does not leave a default-constructed value behind.
+    switch (entry->type) {
+        case VAL_STRING: {
+            String16 value;
+            RETURN_IF_FAILED(parcel->readString16(&value));
+            mStringMap[key] = value;
+            break;
+        }
+        case VAL_INTEGER: {
+            int32_t value;
+            RETURN_IF_FAILED(parcel->readInt32(&value));
+            mIntMap[key] = value;
+            break;
+        }
+        case VAL_LONG: {
+            int64_t value;
+            RETURN_IF_FAILED(parcel->readInt64(&value));
+            mLongMap[key] = value;
+            break;
+        }
+        case VAL_DOUBLE: {
+            double value;
+            RETURN_IF_FAILED(parcel->readDouble(&value));
+            mDoubleMap[key] = value;
+            break;
+        }
+        case VAL_BOOLEAN: {
+            bool value;
+            RETURN_IF_FAILED(parcel->readBool(&value));
+            mBoolMap[key] = value;
+            break;
+        }
+        case VAL_STRINGARRAY: {
+            vector<String16> value;
+            RETURN_IF_FAILED(parcel->readString16Vector(&value));
+            mStringVectorMap[key] = std::move(value);
+            break;
+        }
+        case VAL_INTARRAY: {
+            vector<int32_t> value;
+            RETURN_IF_FAILED(parcel->readInt32Vector(&value));
+            mIntVectorMap[key] = std::move(value);
+            break;
+        }
+        case VAL_LONGARRAY: {
+            vector<int64_t> value;
+            RETURN_IF_FAILED(parcel->readInt64Vector(&value));
+            mLongVectorMap[key] = std::move(value);
+            break;
+        }
+        case VAL_BOOLEANARRAY: {
+            vector<bool> value;
+            RETURN_IF_FAILED(parcel->readBoolVector(&value));
+            mBoolVectorMap[key] = std::move(value);
+            break;
+        }
+        case VAL_PERSISTABLEBUNDLE: {
+            PersistableBundle value;
+            RETURN_IF_FAILED(value.readFromParcel(parcel));
+            mPersistableBundleMap[key] = value;
+            break;
+        }
+        case VAL_DOUBLEARRAY: {
+            vector<double> value;
+            RETURN_IF_FAILED(parcel->readDoubleVector(&value));
+            mDoubleVectorMap[key] = std::move(value);
+            break;
+        }
+        default: {
+            ALOGE("Unrecognized type: %d", entry->type);
+            return BAD_TYPE;
+        }
+    }
+
+    return NO_ERROR;
 }
 
 bool PersistableBundle::empty() const {
@@ -137,6 +427,10 @@ bool PersistableBundle::empty() const {
 }
 
 size_t PersistableBundle::size() const {
+    // Undecoded entries are known from the key directory without decoding.
+    if (mLazy) {
+        return mLazy->entries.size();
+    }
     return (mBoolMap.size() +
             mIntMap.size() +
             mLongMap.size() +
@@ -151,6 +445,7 @@ size_t PersistableBundle::size() const {
 }
 
 size_t PersistableBundle::erase(const String16& key) {
+    unparcel();
     RETURN_IF_ENTRY_ERASED(mBoolMap, key);
     RETURN_IF_ENTRY_ERASED(mIntMap, key);
     RETURN_IF_ENTRY_ERASED(mLongMap, key);
@@ -220,90 +515,112 @@ void PersistableBundle::putPersistableBundle(const String16& key, const Persista
 }
 
 bool PersistableBundle::getBoolean(const String16& key, bool* out) const {
+    decodeKey(key);
     return getValue(key, out, mBoolMap);
 }
 
 bool PersistableBundle::getInt(const String16& key, int32_t* out) const {
+    decodeKey(key);
     return getValue(key, out, mIntMap);
 }
 
 bool PersistableBundle::getLong(const String16& key, int64_t* out) const {
+    decodeKey(key);
     return getValue(key, out, mLongMap);
 }
 
 bool PersistableBundle::getDouble(const String16& key, double* out) const {
+    decodeKey(key);
     return getValue(key, out, mDoubleMap);
 }
 
 bool PersistableBundle::getString(const String16& key, String16* out) const {
+    decodeKey(key);
     return getValue(key, out, mStringMap);
 }
 
 bool PersistableBundle::getBooleanVector(const String16& key, vector<bool>* out) const {
+    decodeKey(key);
     return getValue(key, out, mBoolVectorMap);
 }
 
 bool PersistableBundle::getIntVector(const String16& key, vector<int32_t>* out) const {
+    decodeKey(key);
     return getValue(key, out, mIntVectorMap);
 }
 
 bool PersistableBundle::getLongVector(const String16& key, vector<int64_t>* out) const {
+    decodeKey(key);
     return getValue(key, out, mLongVectorMap);
 }
 
 bool PersistableBundle::getDoubleVector(const String16& key, vector<double>* out) const {
+    decodeKey(key);
     return getValue(key, out, mDoubleVectorMap);
 }
 
 bool PersistableBundle::getStringVector(const String16& key, vector<String16>* out) const {
+    decodeKey(key);
     return getValue(key, out, mStringVectorMap);
 }
 
 bool PersistableBundle::getPersistableBundle(const String16& key, PersistableBundle* out) const {
+    decodeKey(key);
     return getValue(key, out, mPersistableBundleMap);
 }
 
 set<String16> PersistableBundle::getBooleanKeys() const {
+    unparcel();
     return getKeys(mBoolMap);
 }
 
 set<String16> PersistableBundle::getIntKeys() const {
+    unparcel();
     return getKeys(mIntMap);
 }
 
 set<String16> PersistableBundle::getLongKeys() const {
+    unparcel();
     return getKeys(mLongMap);
 }
 
 set<String16> PersistableBundle::getDoubleKeys() const {
+    unparcel();
     return getKeys(mDoubleMap);
 }
 
 set<String16> PersistableBundle::getStringKeys() const {
+    unparcel();
     return getKeys(mStringMap);
 }
 
 set<String16> PersistableBundle::getBooleanVectorKeys() const {
+    unparcel();
     return getKeys(mBoolVectorMap);
 }
 
 set<String16> PersistableBundle::getIntVectorKeys() const {
+    unparcel();
     return getKeys(mIntVectorMap);
 }
 
 set<String16> PersistableBundle::getLongVectorKeys() const {
+    unparcel();
     return getKeys(mLongVectorMap);
 }
 
 set<String16> PersistableBundle::getDoubleVectorKeys() const {
+    unparcel();
     return getKeys(mDoubleVectorMap);
 }
 
 set<String16> PersistableBundle::getStringVectorKeys() const {
+    unparcel();
     return getKeys(mStringVectorMap);
 }
 
 set<String16> PersistableBundle::getPersistableBundleKeys() const {
+    unparcel();
     return getKeys(mPersistableBundleMap);
 }
 
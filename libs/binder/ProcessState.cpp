@@ -18,10 +18,13 @@
 
 #include <binder/ProcessState.h>
 
+#include <android-base/stringprintf.h>
 #include <binder/BpBinder.h>
 #include <binder/IPCThreadState.h>
 #include <binder/IServiceManager.h>
+#include <binder/Parcel.h>
 #include <cutils/atomic.h>
+#include <cutils/properties.h>
 #include <utils/Log.h>
 #include <utils/String8.h>
 #include <utils/String8.h>
@@ -32,7 +35,10 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <inttypes.h>
 #include <stdio.h>
+
+#include <map>
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
@@ -40,6 +46,8 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+using android::base::StringPrintf;
+
 #define BINDER_VM_SIZE ((1 * 1024 * 1024) - sysconf(_SC_PAGE_SIZE) * 2)
 #define DEFAULT_MAX_BINDER_THREADS 15
 
@@ -243,26 +251,38 @@ void ProcessState::setCallRestriction(CallRestriction restriction) {
     mCallRestriction = restriction;
 }
 
-ProcessState::handle_entry* ProcessState::lookupHandleLocked(int32_t handle)
+void ProcessState::setThreadParcelCachingEnabled(bool enabled) {
+    Parcel::setThreadBufferCachingEnabled(enabled);
+}
+
+ProcessState::HandleTableShard& ProcessState::handleShard(int32_t handle)
+{
+    return mHandleTable[((size_t)handle) % kHandleTableShards];
+}
+
+ProcessState::handle_entry* ProcessState::lookupHandleLocked(HandleTableShard& shard,
+                                                             int32_t handle)
 {
-    const size_t N=mHandleToObject.size();
-    if (N <= (size_t)handle) {
+    const size_t index = ((size_t)handle) / kHandleTableShards;
+    const size_t N = shard.entries.size();
+    if (N <= index) {
         handle_entry e;
         e.binder = nullptr;
         e.refs = nullptr;
-        status_t err = mHandleToObject.insertAt(e, N, handle+1-N);
+        status_t err = shard.entries.insertAt(e, N, index+1-N);
         if (err < NO_ERROR) return nullptr;
     }
-    return &mHandleToObject.editItemAt(handle);
+    return &shard.entries.editItemAt(index);
 }
 
 sp<IBinder> ProcessState::getStrongProxyForHandle(int32_t handle)
 {
     sp<IBinder> result;
 
-    AutoMutex _l(mLock);
+    HandleTableShard& shard = handleShard(handle);
+    AutoMutex _l(shard.lock);
 
-    handle_entry* e = lookupHandleLocked(handle);
+    handle_entry* e = lookupHandleLocked(shard, handle);
 
     if (e != nullptr) {
         // We need to create a new BpBinder if there isn't currently one, OR we
@@ -317,9 +337,10 @@ wp<IBinder> ProcessState::getWeakProxyForHandle(int32_t handle)
 {
     wp<IBinder> result;
 
-    AutoMutex _l(mLock);
+    HandleTableShard& shard = handleShard(handle);
+    AutoMutex _l(shard.lock);
 
-    handle_entry* e = lookupHandleLocked(handle);
+    handle_entry* e = lookupHandleLocked(shard, handle);
 
     if (e != nullptr) {        
         // We need to create a new BpBinder if there isn't currently one, OR we
@@ -346,9 +367,10 @@ wp<IBinder> ProcessState::getWeakProxyForHandle(int32_t handle)
 
 void ProcessState::expungeHandle(int32_t handle, IBinder* binder)
 {
-    AutoMutex _l(mLock);
-    
-    handle_entry* e = lookupHandleLocked(handle);
+    HandleTableShard& shard = handleShard(handle);
+    AutoMutex _l(shard.lock);
+
+    handle_entry* e = lookupHandleLocked(shard, handle);
 
     // This handle may have already been replaced with a new BpBinder
     // (if someone failed the AttemptIncWeak() above); we don't want
@@ -374,6 +396,68 @@ void ProcessState::spawnPooledThread(bool isMain)
     }
 }
 
+bool ProcessState::isBinderLatencyEnabled() {
+    static const bool enabled = property_get_bool("debug.binder.latency_histograms", false);
+    return enabled;
+}
+
+std::string ProcessState::getBinderLatencyStats() {
+    std::string result;
+    if (!isBinderLatencyEnabled()) {
+        return "binder latency histograms disabled "
+               "(set debug.binder.latency_histograms)\n";
+    }
+
+    // Merge each thread's histograms.  The owning threads keep writing while
+    // we read; torn counters only smudge the histogram, they can't corrupt
+    // anything, and that is the price of keeping the record path lock-free.
+    std::map<const String16*, IPCThreadState::LatencyHistogram> merged;
+    pthread_mutex_lock(&mThreadCountLock);
+    for (size_t i = 0; i < mThreadStates.size(); i++) {
+        for (const auto& pair : mThreadStates[i]->mLatencyStats) {
+            IPCThreadState::LatencyHistogram& hist = merged[pair.first];
+            hist.count += pair.second.count;
+            hist.totalNs += pair.second.totalNs;
+            for (size_t b = 0; b < 16; b++) {
+                hist.buckets[b] += pair.second.buckets[b];
+            }
+        }
+    }
+    pthread_mutex_unlock(&mThreadCountLock);
+
+    for (const auto& pair : merged) {
+        const IPCThreadState::LatencyHistogram& hist = pair.second;
+        if (hist.count == 0) continue;
+        result += String8(*pair.first).string();
+        result += StringPrintf(": %" PRIu64 " transactions, avg %.1f us, buckets(us)",
+                               hist.count, hist.totalNs / (1e3 * hist.count));
+        for (size_t b = 0; b < 16; b++) {
+            if (hist.buckets[b] == 0) continue;
+            result += StringPrintf(" [%llu:%" PRIu64 "]", 1ULL << b, hist.buckets[b]);
+        }
+        result += "\n";
+    }
+    return result;
+}
+
+void ProcessState::resetBinderLatencyStats() {
+    // Threads notice the new generation on their next recorded transaction
+    // and drop their local tables; nothing here may touch another thread's
+    // unsynchronized map.
+    mLatencyStatsGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ProcessState::getThreadPoolStats(ThreadPoolStats* outStats) {
+    pthread_mutex_lock(&mThreadCountLock);
+    outStats->maxThreads = mMaxThreads;
+    outStats->executingThreads = mExecutingThreadsCount;
+    outStats->peakExecutingThreads = mPeakExecutingThreadsCount;
+    outStats->transactionsExecuted = mTransactionsExecuted;
+    outStats->starvationEpisodes = mStarvationEpisodes;
+    outStats->starvationTotalMs = mStarvationTotalMs;
+    pthread_mutex_unlock(&mThreadCountLock);
+}
+
 status_t ProcessState::setThreadPoolMaxThreadCount(size_t maxThreads) {
     status_t result = NO_ERROR;
     if (ioctl(mDriverFD, BINDER_SET_MAX_THREADS, &maxThreads) != -1) {
@@ -429,6 +513,10 @@ ProcessState::ProcessState(const char *driver)
     , mThreadCountDecrement(PTHREAD_COND_INITIALIZER)
     , mExecutingThreadsCount(0)
     , mMaxThreads(DEFAULT_MAX_BINDER_THREADS)
+    , mPeakExecutingThreadsCount(0)
+    , mTransactionsExecuted(0)
+    , mStarvationEpisodes(0)
+    , mStarvationTotalMs(0)
     , mStarvationStartTimeMs(0)
     , mManagesContexts(false)
     , mBinderContextCheckFunc(nullptr)
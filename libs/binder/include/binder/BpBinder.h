@@ -70,6 +70,21 @@ public:
             status_t    setConstantData(const void* data, size_t size);
             void        sendObituary();
 
+    static const size_t kDefaultOnewayFlushThreshold = 16 * 1024;
+
+            // Opt-in batching of oneway transactions sent through this
+            // proxy: TF_ONE_WAY parcels are queued in the calling thread's
+            // outgoing command buffer and written to the driver in a single
+            // kernel write once the queue reaches flushThresholdBytes or
+            // flushOnewayBatch() is called.  Intended for high-rate
+            // fire-and-forget paths where one ioctl per send dominates.
+            // Queued work is also flushed ahead of any synchronous
+            // transaction issued by the same thread, preserving ordering.
+            void        setOnewayBatchingEnabled(bool enabled,
+                            size_t flushThresholdBytes = kDefaultOnewayFlushThreshold);
+            // Writes any oneway transactions batched by the calling thread.
+            status_t    flushOnewayBatch();
+
     static uint32_t     getBinderProxyCount(uint32_t uid);
     static void         getCountByUid(Vector<uint32_t>& uids, Vector<uint32_t>& counts);
     static void         enableCountByUid();
@@ -128,6 +143,8 @@ private:
 
     mutable Mutex               mLock;
             volatile int32_t    mAlive;
+            volatile int32_t    mOnewayBatching;
+            size_t              mOnewayFlushThreshold;
             volatile int32_t    mObitsSent;
             Vector<Obituary>*   mObituaries;
             ObjectManager       mObjects;
@@ -52,6 +52,8 @@ private:
     static  void        threadDestructor(void *st);
     
             BufferState*getBuffer() const;
+
+            status_t    printInternal(const char* txt, size_t len);
             
     uint32_t            mFlags;
     const int32_t       mSeq;
@@ -19,7 +19,12 @@
 
 #include <utils/Errors.h>
 #include <binder/Parcel.h>
+
+#include <atomic>
+#include <unordered_map>
+
 #include <binder/ProcessState.h>
+#include <utils/Timers.h>
 #include <utils/Vector.h>
 
 #if defined(_WIN32)
@@ -33,6 +38,9 @@ class IPCThreadStateBase;
 
 class IPCThreadState
 {
+    // merges the per-thread latency histograms in getBinderLatencyStats()
+    friend class ProcessState;
+
 public:
     static  IPCThreadState*     self();
     static  IPCThreadState*     selfOrNull();  // self(), but won't instantiate
@@ -85,6 +93,16 @@ public:
                                          uint32_t code, const Parcel& data,
                                          Parcel* reply, uint32_t flags);
 
+            // Batched oneway support; see BpBinder::setOnewayBatchingEnabled().
+            // Queues a TF_ONE_WAY transaction in this thread's outgoing
+            // command buffer without issuing a kernel write.  The queue is
+            // written in a single BINDER_WRITE_READ once it reaches
+            // flushThreshold bytes or flushBatchedOneway() is called.
+            status_t            queueBatchedOneway(int32_t handle, uint32_t code,
+                                                   const Parcel& data,
+                                                   size_t flushThreshold);
+            status_t            flushBatchedOneway();
+
             void                incStrongHandle(int32_t handle, BpBinder *proxy);
             void                decStrongHandle(int32_t handle);
             void                incWeakHandle(int32_t handle, BpBinder *proxy);
@@ -189,8 +207,35 @@ private:
             bool                mPropagateWorkSource;
             int32_t             mStrictModePolicy;
             int32_t             mLastTransactionBinderFlags;
+            // Batched oneway transactions whose BR_TRANSACTION_COMPLETE has
+            // not been consumed yet, and the staged payload copies that must
+            // stay alive until the driver has read them.
+            size_t              mPendingBatchedOneway;
+            Vector<Parcel*>     mBatchedOnewayData;
             IPCThreadStateBase  *mIPCThreadStateBase;
 
+            // Incoming transaction this thread is currently executing, for
+            // the thread-pool starvation watchdog.  Written with relaxed
+            // atomics on the transaction path and read (racily, for logging
+            // only) by whichever thread reports starvation.
+            std::atomic<uintptr_t> mInFlightTarget { 0 };
+            std::atomic<uint32_t>  mInFlightCode { 0 };
+            std::atomic<int32_t>   mInFlightCallerPid { 0 };
+            std::atomic<int64_t>   mInFlightStartMs { 0 };
+
+            // Per-interface execute-time histograms (log2 microsecond
+            // buckets), owned by this thread and merged racily by
+            // ProcessState::getBinderLatencyStats().  Keys are the static
+            // interface descriptor objects, so they are stable and cheap.
+            struct LatencyHistogram {
+                uint64_t count = 0;
+                int64_t totalNs = 0;
+                uint64_t buckets[16] = {};
+            };
+            std::unordered_map<const String16*, LatencyHistogram> mLatencyStats;
+            uint32_t mLatencyStatsGeneration = 0;
+            void recordTransactionLatency(const String16* descriptor, nsecs_t durationNs);
+
             ProcessState::CallRestriction mCallRestriction;
 };
 
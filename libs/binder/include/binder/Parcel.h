@@ -233,6 +233,20 @@ public:
     // The caller should call release() on the blob after writing its contents.
     status_t            writeBlob(size_t len, bool mutableCopy, WritableBlob* outBlob);
 
+    // Zero-copy write path for large payloads.  Records a reference to a
+    // caller-owned buffer instead of copying it into the parcel now; all
+    // pending references are flattened into a single exactly-sized
+    // allocation the first time the contiguous data is needed (typically
+    // at transact() time), replacing the repeated grow+copy cycle of
+    // writeInplace() with one copy.  The buffer must remain valid until
+    // relFunc is invoked; relFunc is also invoked if the write is
+    // rejected or the parcel is cleared before being flattened.
+    typedef void        (*referenced_release_func)(const void* data, size_t len,
+                                                   void* cookie);
+    status_t            writeReferencedData(const void* buffer, size_t len,
+                                            referenced_release_func relFunc,
+                                            void* relCookie);
+
     // Write an existing immutable blob file descriptor to the parcel.
     // This allows the client to send the same blob to multiple processes
     // as long as it keeps a dup of the blob file descriptor handy for later.
@@ -396,6 +410,10 @@ public:
     static size_t       getGlobalAllocSize();
     static size_t       getGlobalAllocCount();
 
+    // Controls the per-thread cache of parcel write buffers; normally
+    // toggled process-wide via ProcessState::setThreadParcelCachingEnabled().
+    static void         setThreadBufferCachingEnabled(bool enabled);
+
     bool                replaceCallingWorkSourceUid(uid_t uid);
     // Returns the work source provided by the caller. This can only be trusted for trusted calling
     // uid.
@@ -433,6 +451,8 @@ private:
     status_t            readPointer(uintptr_t *pArg) const;
     uintptr_t           readPointer() const;
     void                freeDataNoInit();
+    status_t            flattenReferencedData() const;
+    void                releaseReferencedData();
     void                initState();
     void                scanForFds() const;
     status_t            validateReadData(size_t len) const;
@@ -495,6 +515,18 @@ private:
     release_func        mOwner;
     void*               mOwnerCookie;
 
+    // Pending zero-copy segments recorded by writeReferencedData(),
+    // ordered by insertPos; spliced into mData by flattenReferencedData().
+    struct ReferencedSegment {
+        size_t                  insertPos;  // offset into mData where the segment belongs
+        const void*             data;
+        size_t                  len;        // unpadded length
+        referenced_release_func relFunc;
+        void*                   relCookie;
+    };
+    mutable std::vector<ReferencedSegment>* mReferencedSegments;
+    mutable size_t      mReferencedSize;    // total padded bytes pending
+
     class Blob {
     public:
         Blob();
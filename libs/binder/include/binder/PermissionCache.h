@@ -22,9 +22,12 @@
 #include <stdint.h>
 #include <unistd.h>
 
+#include <memory>
+
 #include <utils/String16.h>
 #include <utils/Singleton.h>
 #include <utils/SortedVector.h>
+#include <utils/Timers.h>
 
 namespace android {
 // ---------------------------------------------------------------------------
@@ -32,12 +35,18 @@ namespace android {
 /*
  * PermissionCache caches permission checks for a given uid.
  *
- * Currently the cache is not updated when there is a permission change,
- * for instance when an application is uninstalled.
+ * Grants are cached forever; they are only updated when there is a
+ * permission change, for instance when an application is uninstalled.
+ * Denials expire after kDeniedValidityNs so a permission granted after
+ * the first check is eventually observed.
  *
- * IMPORTANT: for the reason stated above, only system permissions are safe
- * to cache. This restriction may be lifted at a later time.
+ * IMPORTANT: because grants are never invalidated, only system
+ * permissions are safe to cache. This restriction may be lifted at a
+ * later time.
  *
+ * Reads go against an immutable snapshot published with an atomic
+ * pointer, so the hot path (a cache hit) takes no lock and cannot
+ * contend with a miss resolving through the permission controller.
  */
 
 class PermissionCache : Singleton<PermissionCache> {
@@ -45,16 +54,23 @@ class PermissionCache : Singleton<PermissionCache> {
         String16    name;
         uid_t       uid;
         bool        granted;
+        nsecs_t     checkTime;
         inline bool operator < (const Entry& e) const {
             return (uid == e.uid) ? (name < e.name) : (uid < e.uid);
         }
     };
+
+    // how long a cached denial stays valid
+    static constexpr nsecs_t kDeniedValidityNs = s2ns(10);
+
+    // serializes writers only; readers use the snapshot
     mutable Mutex mLock;
     // we pool all the permission names we see, as many permissions checks
     // will have identical names
     SortedVector< String16 > mPermissionNamesPool;
-    // this is our cache per say. it stores pooled names.
-    SortedVector< Entry > mCache;
+    // the cache itself: an immutable sorted snapshot, atomically swapped by
+    // writers. it stores pooled names.
+    std::shared_ptr<const SortedVector< Entry >> mCache;
 
     // free the whole cache, but keep the permission name pool
     void purge();
@@ -18,9 +18,11 @@
 #define ANDROID_PERSISTABLE_BUNDLE_H
 
 #include <map>
+#include <memory>
 #include <set>
 #include <vector>
 
+#include <binder/Parcel.h>
 #include <binder/Parcelable.h>
 #include <utils/String16.h>
 #include <utils/StrongPointer.h>
@@ -32,12 +34,18 @@ namespace os {
 /*
  * C++ implementation of PersistableBundle, a mapping from String values to
  * various types that can be saved to persistent and later restored.
+ *
+ * A bundle read from a parcel is decoded lazily: only the key directory is
+ * indexed up front and each value is materialized on first access.  As a
+ * consequence, concurrent access to a lazily-loaded bundle must be
+ * externally synchronized even when all accesses are const.
  */
 class PersistableBundle : public Parcelable {
 public:
     PersistableBundle() = default;
     virtual ~PersistableBundle() = default;
-    PersistableBundle(const PersistableBundle& bundle) = default;
+    PersistableBundle(const PersistableBundle& bundle);
+    PersistableBundle& operator=(const PersistableBundle& bundle);
 
     status_t writeToParcel(Parcel* parcel) const override;
     status_t readFromParcel(const Parcel* parcel) override;
@@ -94,6 +102,8 @@ public:
     std::set<String16> getPersistableBundleKeys() const;
 
     friend bool operator==(const PersistableBundle& lhs, const PersistableBundle& rhs) {
+        lhs.unparcel();
+        rhs.unparcel();
         return (lhs.mBoolMap == rhs.mBoolMap && lhs.mIntMap == rhs.mIntMap &&
                 lhs.mLongMap == rhs.mLongMap && lhs.mDoubleMap == rhs.mDoubleMap &&
                 lhs.mStringMap == rhs.mStringMap && lhs.mBoolVectorMap == rhs.mBoolVectorMap &&
@@ -112,6 +122,33 @@ private:
     status_t writeToParcelInner(Parcel* parcel) const;
     status_t readFromParcelInner(const Parcel* parcel, size_t length);
 
+    /*
+     * Lazily-indexed representation of a bundle received over binder.
+     * readFromParcel() captures the raw entry bytes and a key directory
+     * (a sorted array, binary-searched on lookup) built by skipping over
+     * values without materializing them; a value is decoded into the maps
+     * below the first time its key is requested.  Mutation and whole-map
+     * operations decode everything and drop the raw bytes.
+     */
+    struct LazyEntry {
+        String16 key;
+        int32_t type;
+        size_t offset;  // value position within LazyState::data
+        bool decoded;
+    };
+    struct LazyState {
+        Parcel data;  // raw entry bytes, excluding magic and entry count
+        int32_t numEntries;
+        std::vector<LazyEntry> entries;  // sorted by key
+    };
+
+    status_t initLazy(const Parcel* parcel);
+    void unparcel() const;
+    void decodeKey(const String16& key) const;
+    status_t decodeLazyEntry(LazyEntry* entry);
+
+    mutable std::unique_ptr<LazyState> mLazy;
+
     std::map<String16, bool> mBoolMap;
     std::map<String16, int32_t> mIntMap;
     std::map<String16, int64_t> mLongMap;
@@ -22,6 +22,9 @@
 #include <utils/String8.h>
 #include <utils/String16.h>
 
+#include <atomic>
+#include <string>
+
 #include <utils/threads.h>
 
 #include <pthread.h>
@@ -69,6 +72,26 @@ public:
             void                expungeHandle(int32_t handle, IBinder* binder);
 
             void                spawnPooledThread(bool isMain);
+
+            // Snapshot of thread pool utilization counters.
+            struct ThreadPoolStats {
+                size_t maxThreads;
+                size_t executingThreads;
+                size_t peakExecutingThreads;
+                uint64_t transactionsExecuted;
+                uint64_t starvationEpisodes;
+                int64_t starvationTotalMs;
+            };
+            void                getThreadPoolStats(ThreadPoolStats* outStats);
+
+            // Per-interface binder latency histograms, collected around
+            // incoming transaction execution when
+            // debug.binder.latency_histograms is set.  Merging is racy by
+            // design (counters live in each thread's IPCThreadState and are
+            // read without synchronization); good enough for histograms.
+            std::string         getBinderLatencyStats();
+            void                resetBinderLatencyStats();
+            static bool         isBinderLatencyEnabled();
             
             status_t            setThreadPoolMaxThreadCount(size_t maxThreads);
             void                giveThreadPoolName();
@@ -89,6 +112,11 @@ public:
             // before any threads are spawned.
             void setCallRestriction(CallRestriction restriction);
 
+            // Enables recycling of Parcel write buffers through a per-thread
+            // cache, keeping transaction-rate Parcel construction off the
+            // global heap in binder-heavy processes.
+            void setThreadParcelCachingEnabled(bool enabled);
+
 private:
     friend class IPCThreadState;
     
@@ -104,7 +132,23 @@ private:
                 RefBase::weakref_type* refs;
             };
 
-            handle_entry*       lookupHandleLocked(int32_t handle);
+            // The handle table is sharded by handle so concurrent proxy
+            // lookups of unrelated handles never serialize on one mutex;
+            // under large thread pools the single table lock is a
+            // measurable contention point.  A handle maps to shard
+            // (handle % kHandleTableShards) for its lifetime, so the
+            // lock-ordering argument in getWeakProxyForHandle() about
+            // expungeHandle() still holds per shard.
+            static const size_t kHandleTableShards = 16;
+            struct HandleTableShard {
+                Mutex               lock;
+                // Indexed by handle / kHandleTableShards.
+                Vector<handle_entry> entries;
+            };
+
+            HandleTableShard&   handleShard(int32_t handle);
+            handle_entry*       lookupHandleLocked(HandleTableShard& shard,
+                                                   int32_t handle);
 
             String8             mDriverName;
             int                 mDriverFD;
@@ -119,11 +163,23 @@ private:
             size_t              mMaxThreads;
             // Time when thread pool was emptied
             int64_t             mStarvationStartTimeMs;
+            // Utilization accounting, all guarded by mThreadCountLock.
+            size_t              mPeakExecutingThreadsCount;
+            uint64_t            mTransactionsExecuted;
+            uint64_t            mStarvationEpisodes;
+            int64_t             mStarvationTotalMs;
+            // IPCThreadStates of threads currently using binder in this
+            // process, for the starvation watchdog.
+            Vector<IPCThreadState*> mThreadStates;
+            // bumped by resetBinderLatencyStats(); threads drop their local
+            // histograms when they notice the generation moved
+            std::atomic<uint32_t> mLatencyStatsGeneration { 0 };
+
+            // Each shard is protected by its own lock, not mLock.
+            HandleTableShard    mHandleTable[kHandleTableShards];
 
     mutable Mutex               mLock;  // protects everything below.
 
-            Vector<handle_entry>mHandleToObject;
-
             bool                mManagesContexts;
             context_check_func  mBinderContextCheckFunc;
             void*               mBinderContextUserData;
@@ -196,7 +196,9 @@ bool getUidsCpuFreqTimes(
         std::unordered_map<uint32_t, std::vector<std::vector<uint64_t>>> *freqTimeMap) {
     if (!gInitialized && !initGlobals()) return false;
 
-    int fd = bpf_obj_get(BPF_FS_PATH "map_time_in_state_uid_times");
+    // reuse the map fd opened at init instead of resolving the pinned path
+    // on every poll
+    int fd = dup(gMapFd);
     if (fd < 0) return false;
     BpfMap<time_key_t, val_t> m(fd);
 
@@ -227,6 +229,49 @@ bool getUidsCpuFreqTimes(
     return isOk(m.iterateWithValue(fn));
 }
 
+// Retrieve, for every uid, the time spent at each CPU frequency since the
+// previous call with the same snapshot map, in the getUidsCpuFreqTimes format.
+// On success, snapshot is replaced with the current totals and deltaMap
+// contains only uids with at least one changed counter.  The first call with
+// an empty snapshot returns all uids' totals.  A counter that went backwards
+// (the uid was cleared and reappeared) reports its current value.
+bool getUidsCpuFreqTimesDelta(
+        std::unordered_map<uint32_t, std::vector<std::vector<uint64_t>>> *snapshot,
+        std::unordered_map<uint32_t, std::vector<std::vector<uint64_t>>> *deltaMap) {
+    std::unordered_map<uint32_t, std::vector<std::vector<uint64_t>>> current;
+    if (!getUidsCpuFreqTimes(&current)) return false;
+
+    deltaMap->clear();
+    for (const auto &pair : current) {
+        const uint32_t uid = pair.first;
+        const auto &now = pair.second;
+        auto last = snapshot->find(uid);
+        if (last == snapshot->end()) {
+            (*deltaMap)[uid] = now;
+            continue;
+        }
+
+        bool changed = false;
+        std::vector<std::vector<uint64_t>> delta(now.size());
+        for (size_t policy = 0; policy < now.size(); ++policy) {
+            delta[policy].resize(now[policy].size(), 0);
+            for (size_t freq = 0; freq < now[policy].size(); ++freq) {
+                const uint64_t prev = policy < last->second.size() &&
+                                freq < last->second[policy].size()
+                        ? last->second[policy][freq]
+                        : 0;
+                const uint64_t cur = now[policy][freq];
+                delta[policy][freq] = cur >= prev ? cur - prev : cur;
+                changed |= delta[policy][freq] != 0;
+            }
+        }
+        if (changed) (*deltaMap)[uid] = std::move(delta);
+    }
+
+    *snapshot = std::move(current);
+    return true;
+}
+
 // Clear all time in state data for a given uid. Returns false on error, true otherwise.
 bool clearUidCpuFreqTimes(uint32_t uid) {
     if (!gInitialized && !initGlobals()) return false;
@@ -25,6 +25,9 @@ namespace bpf {
 bool startTrackingUidCpuFreqTimes();
 bool getUidCpuFreqTimes(unsigned int uid, std::vector<std::vector<uint64_t>> *freqTimes);
 bool getUidsCpuFreqTimes(std::unordered_map<uint32_t, std::vector<std::vector<uint64_t>>> *tisMap);
+bool getUidsCpuFreqTimesDelta(
+        std::unordered_map<uint32_t, std::vector<std::vector<uint64_t>>> *snapshot,
+        std::unordered_map<uint32_t, std::vector<std::vector<uint64_t>>> *deltaMap);
 bool clearUidCpuFreqTimes(unsigned int uid);
 
 } // namespace bpf
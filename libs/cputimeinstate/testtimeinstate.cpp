@@ -33,6 +33,28 @@ TEST(TimeInStateTest, AllUid) {
     }
 }
 
+TEST(TimeInStateTest, AllUidDelta) {
+    std::unordered_map<uint32_t, vector<vector<uint64_t>>> snapshot, delta;
+
+    // First call with an empty snapshot returns every uid's totals.
+    ASSERT_TRUE(getUidsCpuFreqTimesDelta(&snapshot, &delta));
+    ASSERT_FALSE(snapshot.empty());
+    ASSERT_EQ(delta.size(), snapshot.size());
+
+    // Subsequent deltas only contain uids that accumulated time, and the
+    // snapshot advances to the current totals.
+    ASSERT_TRUE(getUidsCpuFreqTimesDelta(&snapshot, &delta));
+    for (const auto &entry : delta) {
+        auto it = snapshot.find(entry.first);
+        ASSERT_NE(it, snapshot.end());
+        uint64_t sum = 0;
+        for (const auto &policyTimes : entry.second) {
+            for (auto t : policyTimes) sum += t;
+        }
+        EXPECT_GT(sum, (uint64_t)0);
+    }
+}
+
 TEST(TimeInStateTest, RemoveUid) {
     vector<vector<uint64_t>> times, times2;
     ASSERT_TRUE(getUidCpuFreqTimes(0, &times));
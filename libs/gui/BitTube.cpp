@@ -133,6 +133,11 @@ ssize_t BitTube::sendObjects(BitTube* tube, void const* events, size_t count, si
     const char* vaddr = reinterpret_cast<const char*>(events);
     ssize_t size = tube->write(vaddr, count * objSize);
 
+    if (size == -EAGAIN) {
+        // The socket is full; the caller is about to drop these objects.
+        tube->mDroppedSends.fetch_add(1, std::memory_order_relaxed);
+    }
+
     // should never happen because of SOCK_SEQPACKET
     LOG_ALWAYS_FATAL_IF((size >= 0) && (size % static_cast<ssize_t>(objSize)),
                         "BitTube::sendObjects(count=%zu, size=%zu), res=%zd (partial events were "
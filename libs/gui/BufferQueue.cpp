@@ -23,6 +23,7 @@
 #include <gui/BufferHubProducer.h>
 #endif
 
+#include <binder/IMemory.h>
 #include <gui/BufferQueue.h>
 #include <gui/BufferQueueConsumer.h>
 #include <gui/BufferQueueCore.h>
@@ -73,6 +74,11 @@ void BufferQueue::ProxyConsumerListener::onSidebandStreamChanged() {
     }
 }
 
+sp<IMemory> BufferQueue::ProxyConsumerListener::getFrameTimestampsRing() {
+    sp<ConsumerListener> listener(mConsumerListener.promote());
+    return listener != nullptr ? listener->getFrameTimestampsRing() : nullptr;
+}
+
 void BufferQueue::ProxyConsumerListener::addAndGetFrameTimestamps(
         const NewFrameEventsEntry* newTimestamps,
         FrameEventHistoryDelta* outDelta) {
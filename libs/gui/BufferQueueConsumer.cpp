@@ -83,6 +83,7 @@ status_t BufferQueueConsumer::acquireBuffer(BufferItem* outBuffer,
         // In asynchronous mode the list is guaranteed to be one buffer deep,
         // while in synchronous mode we use the oldest buffer.
         if (mCore->mQueue.empty() && !sharedBufferAvailable) {
+            mCore->mAcquireStarvedCount++;
             return NO_BUFFER_AVAILABLE;
         }
 
@@ -85,6 +85,9 @@ BufferQueueCore::BufferQueueCore() :
     mMaxDequeuedBufferCount(1),
     mBufferHasBeenQueued(false),
     mFrameCounter(0),
+    mDequeueBlockedNs(0),
+    mDequeueBlockedCount(0),
+    mAcquireStarvedCount(0),
     mTransformHint(0),
     mIsAllocating(false),
     mIsAllocatingCondition(),
@@ -126,6 +129,12 @@ void BufferQueueCore::dumpState(const String8& prefix, String8* outResult) const
                             mDefaultWidth, mDefaultHeight, mDefaultBufferFormat);
     outResult->appendFormat("transform-hint=%02x frame-counter=%" PRIu64, mTransformHint,
                             mFrameCounter);
+    if (mDequeueBlockedCount > 0 || mAcquireStarvedCount > 0) {
+        outResult->appendFormat("\n%s  dequeue-blocked=%" PRIu64 " times (%.2fms total) "
+                                "acquire-starved=%" PRIu64 " times",
+                                prefix.string(), mDequeueBlockedCount,
+                                mDequeueBlockedNs / 1e6, mAcquireStarvedCount);
+    }
 
     outResult->appendFormat("\n%sFIFO(%zu):\n", prefix.string(), mQueue.size());
     Fifo::const_iterator current(mQueue.begin());
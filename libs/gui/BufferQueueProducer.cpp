@@ -31,6 +31,7 @@
 #include <binder/IPCThreadState.h>
 #include <gui/BufferItem.h>
 #include <gui/BufferQueueCore.h>
+#include <binder/IMemory.h>
 #include <gui/BufferQueueProducer.h>
 #include <gui/GLConsumer.h>
 #include <gui/IConsumerListener.h>
@@ -38,6 +39,7 @@
 #include <private/gui/BufferQueueThreadState.h>
 
 #include <utils/Log.h>
+#include <utils/Timers.h>
 #include <utils/Trace.h>
 
 #include <system/window.h>
@@ -338,14 +340,19 @@ status_t BufferQueueProducer::waitForFreeSlotThenRelock(FreeSlotCaller caller,
                     (acquiredCount <= mCore->mMaxAcquiredBufferCount)) {
                 return WOULD_BLOCK;
             }
+            const nsecs_t blockStart = systemTime();
             if (mDequeueTimeout >= 0) {
                 std::cv_status result = mCore->mDequeueCondition.wait_for(lock,
                         std::chrono::nanoseconds(mDequeueTimeout));
+                mCore->mDequeueBlockedNs += systemTime() - blockStart;
+                mCore->mDequeueBlockedCount++;
                 if (result == std::cv_status::timeout) {
                     return TIMED_OUT;
                 }
             } else {
                 mCore->mDequeueCondition.wait(lock);
+                mCore->mDequeueBlockedNs += systemTime() - blockStart;
+                mCore->mDequeueBlockedCount++;
             }
         }
     } // while (tryAgain)
@@ -358,20 +365,6 @@ status_t BufferQueueProducer::dequeueBuffer(int* outSlot, sp<android::Fence>* ou
                                             uint64_t usage, uint64_t* outBufferAge,
                                             FrameEventHistoryDelta* outTimestamps) {
     ATRACE_CALL();
-    { // Autolock scope
-        std::lock_guard<std::mutex> lock(mCore->mMutex);
-        mConsumerName = mCore->mConsumerName;
-
-        if (mCore->mIsAbandoned) {
-            BQ_LOGE("dequeueBuffer: BufferQueue has been abandoned");
-            return NO_INIT;
-        }
-
-        if (mCore->mConnectedApi == BufferQueueCore::NO_CONNECTED_API) {
-            BQ_LOGE("dequeueBuffer: BufferQueue has no connected producer");
-            return NO_INIT;
-        }
-    } // Autolock scope
 
     BQ_LOGV("dequeueBuffer: w=%u h=%u format=%#x, usage=%#" PRIx64, width, height, format, usage);
 
@@ -388,6 +381,22 @@ status_t BufferQueueProducer::dequeueBuffer(int* outSlot, sp<android::Fence>* ou
     { // Autolock scope
         std::unique_lock<std::mutex> lock(mCore->mMutex);
 
+        // The connection checks used to live in a separate lock scope,
+        // costing an extra mutex round trip per dequeue on the hottest
+        // producer path; they are validated here under the same lock that
+        // protects the slot search.
+        mConsumerName = mCore->mConsumerName;
+
+        if (mCore->mIsAbandoned) {
+            BQ_LOGE("dequeueBuffer: BufferQueue has been abandoned");
+            return NO_INIT;
+        }
+
+        if (mCore->mConnectedApi == BufferQueueCore::NO_CONNECTED_API) {
+            BQ_LOGE("dequeueBuffer: BufferQueue has no connected producer");
+            return NO_INIT;
+        }
+
         // If we don't have a free buffer, but we are currently allocating, we wait until allocation
         // is finished such that we don't allocate in parallel.
         if (mCore->mFreeBuffers.empty() && mCore->mIsAllocating) {
@@ -1032,6 +1041,47 @@ status_t BufferQueueProducer::queueBuffer(int slot,
     return NO_ERROR;
 }
 
+status_t BufferQueueProducer::queueAndDequeueBuffer(int slot, const QueueBufferInput& input,
+                                                    QueueBufferOutput* output, uint32_t width,
+                                                    uint32_t height, PixelFormat format,
+                                                    uint64_t usage, uint64_t* outBufferAge,
+                                                    int* outSlot, sp<Fence>* outFence) {
+    ATRACE_CALL();
+    *outSlot = BufferItem::INVALID_BUFFER_SLOT;
+    *outFence = Fence::NO_FENCE;
+
+    status_t result = queueBuffer(slot, input, output);
+    if (result != NO_ERROR) {
+        return result;
+    }
+
+    // Opportunistic prefetch of the next buffer.  Only attempted when a
+    // free, already-allocated buffer is available right now: the queue
+    // reply must never block on the consumer, and a slot that needs
+    // reallocation would cost the caller a requestBuffer trip anyway.
+    {
+        std::lock_guard<std::mutex> lock(mCore->mMutex);
+        if (mCore->mIsAbandoned || mCore->mSharedBufferMode || mCore->mFreeBuffers.empty()) {
+            return NO_ERROR;
+        }
+    }
+
+    int prefetchSlot = BufferItem::INVALID_BUFFER_SLOT;
+    sp<Fence> prefetchFence = Fence::NO_FENCE;
+    const status_t dequeueResult =
+            dequeueBuffer(&prefetchSlot, &prefetchFence, width, height, format, usage,
+                          outBufferAge, nullptr /*outTimestamps*/);
+    if (dequeueResult == NO_ERROR) {
+        *outSlot = prefetchSlot;
+        *outFence = prefetchFence;
+    } else if (dequeueResult > 0 && prefetchSlot != BufferItem::INVALID_BUFFER_SLOT) {
+        // Carried flags (e.g. BUFFER_NEEDS_REALLOCATION): give the slot
+        // back and let the caller take the regular path.
+        cancelBuffer(prefetchSlot, prefetchFence);
+    }
+    return NO_ERROR;
+}
+
 status_t BufferQueueProducer::cancelBuffer(int slot, const sp<Fence>& fence) {
     ATRACE_CALL();
     BQ_LOGV("cancelBuffer: slot %d", slot);
@@ -1564,6 +1614,20 @@ void BufferQueueProducer::getFrameTimestamps(FrameEventHistoryDelta* outDelta) {
     addAndGetFrameTimestamps(nullptr, outDelta);
 }
 
+status_t BufferQueueProducer::getFrameTimestampsRing(sp<IMemory>* outRing) {
+    sp<IConsumerListener> listener;
+    {
+        std::lock_guard<std::mutex> lock(mCore->mMutex);
+        listener = mCore->mConsumerListener;
+    }
+    if (listener == nullptr) {
+        *outRing = nullptr;
+        return INVALID_OPERATION;
+    }
+    *outRing = listener->getFrameTimestampsRing();
+    return *outRing != nullptr ? NO_ERROR : INVALID_OPERATION;
+}
+
 void BufferQueueProducer::addAndGetFrameTimestamps(
         const NewFrameEventsEntry* newTimestamps,
         FrameEventHistoryDelta* outDelta) {
@@ -44,6 +44,104 @@ CpuConsumer::CpuConsumer(const sp<IGraphicBufferConsumer>& bq,
     mConsumer->setMaxAcquiredBufferCount(static_cast<int32_t>(maxLockedBuffers));
 }
 
+CpuConsumer::~CpuConsumer() {
+    {
+        Mutex::Autolock _l(mMutex);
+        mPrefetchExit = true;
+        mPrefetchWork.signal();
+    }
+    if (mPrefetchThread.joinable()) {
+        mPrefetchThread.join();
+    }
+    Mutex::Autolock _l(mMutex);
+    drainPrefetchedLocked();
+}
+
+void CpuConsumer::setBufferPrefetchEnabled(bool enabled) {
+    Mutex::Autolock _l(mMutex);
+    if (enabled == mPrefetchEnabled) {
+        return;
+    }
+    mPrefetchEnabled = enabled;
+    if (enabled && !mPrefetchThread.joinable()) {
+        mPrefetchThread = std::thread(&CpuConsumer::prefetchLoop, this);
+    }
+    if (!enabled) {
+        // anything already mapped but unclaimed goes back to the queue; an
+        // in-flight mapping will be consumed by the next lockNextBuffer
+        drainPrefetchedLocked();
+    }
+    mPrefetchWork.signal();
+}
+
+void CpuConsumer::onFrameAvailable(const BufferItem& item) {
+    {
+        Mutex::Autolock _l(mMutex);
+        if (mPrefetchEnabled) {
+            mPrefetchPending++;
+            mPrefetchWork.signal();
+        }
+    }
+    ConsumerBase::onFrameAvailable(item);
+}
+
+void CpuConsumer::prefetchLoop() {
+    mMutex.lock();
+    while (true) {
+        while (!mPrefetchExit &&
+                (!mPrefetchEnabled || mPrefetchPending == 0 ||
+                 mCurrentLockedBuffers + mPrefetched.size() >= mMaxLockedBuffers)) {
+            mPrefetchWork.wait(mMutex);
+        }
+        if (mPrefetchExit) {
+            break;
+        }
+        mPrefetchPending--;
+
+        BufferItem b;
+        status_t err = acquireBufferLocked(&b, 0);
+        if (err != OK) {
+            // raced with a direct lockNextBuffer, or the queue went away
+            continue;
+        }
+        if (b.mGraphicBuffer == nullptr) {
+            b.mGraphicBuffer = mSlots[b.mSlot].mGraphicBuffer;
+        }
+
+        // The gralloc mapping is the expensive part; do it off the mutex.
+        // mPrefetchInFlight keeps lockNextBuffer from acquiring a newer frame
+        // around us, which would reorder delivery.
+        mPrefetchInFlight = true;
+        LockedBuffer lb;
+        mMutex.unlock();
+        err = lockBufferItem(b, &lb);
+        mMutex.lock();
+        mPrefetchInFlight = false;
+
+        if (err == OK) {
+            mPrefetched.push_back({b, lb});
+        } else {
+            CC_LOGW("prefetch: failed to lock buffer (%d)", err);
+            releaseBufferLocked(b.mSlot, b.mGraphicBuffer);
+        }
+        mPrefetchDone.broadcast();
+    }
+    mMutex.unlock();
+}
+
+void CpuConsumer::drainPrefetchedLocked() {
+    for (PrefetchedBuffer& pb : mPrefetched) {
+        int fenceFd = -1;
+        status_t err = pb.item.mGraphicBuffer->unlockAsync(&fenceFd);
+        if (err == OK) {
+            sp<Fence> fence(fenceFd >= 0 ? new Fence(fenceFd) : Fence::NO_FENCE);
+            addReleaseFenceLocked(pb.item.mSlot, pb.item.mGraphicBuffer, fence);
+        }
+        releaseBufferLocked(pb.item.mSlot, pb.item.mGraphicBuffer);
+    }
+    mPrefetched.clear();
+}
+
 size_t CpuConsumer::findAcquiredBufferLocked(uintptr_t id) const {
     for (size_t i = 0; i < mMaxLockedBuffers; i++) {
         const auto& ab = mAcquiredBuffers[i];
@@ -161,6 +259,31 @@ status_t CpuConsumer::lockNextBuffer(LockedBuffer *nativeBuffer) {
         return NOT_ENOUGH_DATA;
     }
 
+    // Consume the prefetch pipeline first so frames keep arriving in order:
+    // if the worker is mapping a buffer right now, it acquired before us.
+    while (mPrefetchInFlight && mPrefetched.empty()) {
+        mPrefetchDone.wait(mMutex);
+    }
+    // another consumer thread may have taken the last slot while we waited
+    if (mCurrentLockedBuffers == mMaxLockedBuffers) {
+        return NOT_ENOUGH_DATA;
+    }
+    if (!mPrefetched.empty()) {
+        const PrefetchedBuffer& pb = mPrefetched.front();
+        *nativeBuffer = pb.buffer;
+
+        size_t lockedIdx = findAcquiredBufferLocked(AcquiredBuffer::kUnusedId);
+        ALOG_ASSERT(lockedIdx < mMaxLockedBuffers);
+        AcquiredBuffer& ab = mAcquiredBuffers.editItemAt(lockedIdx);
+        ab.mSlot = pb.item.mSlot;
+        ab.mGraphicBuffer = pb.item.mGraphicBuffer;
+        ab.mLockedBufferId = getLockedBufferId(*nativeBuffer);
+
+        mPrefetched.pop_front();
+        mCurrentLockedBuffers++;
+        return OK;
+    }
+
     BufferItem b;
     err = acquireBufferLocked(&b, 0);
     if (err != OK) {
@@ -223,6 +346,8 @@ status_t CpuConsumer::unlockBuffer(const LockedBuffer &nativeBuffer) {
     ab.reset();
 
     mCurrentLockedBuffers--;
+    // a slot freed up; the prefetch worker may have deferred on the bound
+    mPrefetchWork.signal();
 
     return OK;
 }
@@ -18,6 +18,7 @@
 
 #include <utils/Errors.h>
 
+#include <binder/IMemory.h>
 #include <gui/DisplayEventReceiver.h>
 #include <gui/IDisplayEventConnection.h>
 #include <gui/ISurfaceComposer.h>
@@ -47,6 +48,45 @@ DisplayEventReceiver::DisplayEventReceiver(ISurfaceComposer::VsyncSource vsyncSo
 DisplayEventReceiver::~DisplayEventReceiver() {
 }
 
+status_t DisplayEventReceiver::getLatestVsyncEvent(Event* outEvent) {
+    if (mVsyncRing == nullptr) {
+        if (mEventConnection == nullptr) {
+            return NO_INIT;
+        }
+        status_t err = mEventConnection->getLatestVsyncRing(&mVsyncRingMemory);
+        if (err != NO_ERROR) {
+            return err;
+        }
+        if (mVsyncRingMemory == nullptr || mVsyncRingMemory->pointer() == nullptr ||
+            mVsyncRingMemory->size() < sizeof(VsyncEventRing)) {
+            mVsyncRingMemory = nullptr;
+            return NO_MEMORY;
+        }
+        mVsyncRing = static_cast<VsyncEventRing*>(mVsyncRingMemory->pointer());
+    }
+
+    // Seqlock read: retry while the producer is mid-write (odd) or wrote
+    // concurrently (sequence moved).  Bounded so a producer that died
+    // mid-write cannot spin us forever.
+    constexpr int kMaxRetries = 1000;
+    for (int retry = 0; retry < kMaxRetries; retry++) {
+        const uint32_t before = mVsyncRing->seq.load(std::memory_order_acquire);
+        if (before == 0) {
+            return NAME_NOT_FOUND;  // nothing published yet
+        }
+        if (before & 1) {
+            continue;
+        }
+        *outEvent = mVsyncRing->event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint32_t after = mVsyncRing->seq.load(std::memory_order_relaxed);
+        if (after == before) {
+            return NO_ERROR;
+        }
+    }
+    return WOULD_BLOCK;
+}
+
 status_t DisplayEventReceiver::initCheck() const {
     if (mDataChannel != nullptr)
         return NO_ERROR;
@@ -71,6 +111,13 @@ status_t DisplayEventReceiver::setVsyncRate(uint32_t count) {
     return NO_INIT;
 }
 
+status_t DisplayEventReceiver::setVsyncPhase(uint32_t phase) {
+    if (mEventConnection != nullptr) {
+        return mEventConnection->setVsyncPhase(phase);
+    }
+    return NO_INIT;
+}
+
 status_t DisplayEventReceiver::requestNextVsync() {
     if (mEventConnection != nullptr) {
         mEventConnection->requestNextVsync();
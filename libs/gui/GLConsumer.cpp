@@ -330,17 +330,40 @@ status_t GLConsumer::acquireBufferLocked(BufferItem *item,
         return err;
     }
 
-    // If item->mGraphicBuffer is not null, this buffer has not been acquired
-    // before, so any prior EglImage created is using a stale buffer. This
-    // replaces any old EglImage with a new one (using the new buffer).
+    // If item->mGraphicBuffer is not null, the slot is carrying a buffer
+    // it hasn't held before.  That buffer itself is often one we've seen
+    // in another slot though (producers cycle a fixed set of buffers
+    // through recycled slots), so the images are kept in a small LRU
+    // keyed by buffer id instead of being recreated per slot change.
     if (item->mGraphicBuffer != nullptr) {
         int slot = item->mSlot;
-        mEglSlots[slot].mEglImage = new EglImage(item->mGraphicBuffer);
+        mEglSlots[slot].mEglImage = getImageForBufferLocked(item->mGraphicBuffer);
     }
 
     return NO_ERROR;
 }
 
+sp<GLConsumer::EglImage> GLConsumer::getImageForBufferLocked(const sp<GraphicBuffer>& buffer) {
+    const uint64_t bufferId = buffer->getId();
+    for (auto it = mEglImageCache.begin(); it != mEglImageCache.end(); it++) {
+        if (it->first == bufferId) {
+            sp<EglImage> image = it->second;
+            mEglImageCache.erase(it);
+            mEglImageCache.emplace_front(bufferId, image);
+            return image;
+        }
+    }
+
+    sp<EglImage> image = new EglImage(buffer);
+    mEglImageCache.emplace_front(bufferId, image);
+    if (mEglImageCache.size() > kEglImageCacheSize) {
+        // The evicted image may still be referenced by a slot or as the
+        // current texture; it is destroyed once those drop it.
+        mEglImageCache.pop_back();
+    }
+    return image;
+}
+
 status_t GLConsumer::releaseBufferLocked(int buf,
         sp<GraphicBuffer> graphicBuffer,
         EGLDisplay display, EGLSyncKHR eglFence) {
@@ -908,6 +931,17 @@ void GLConsumer::freeBufferLocked(int slotIndex) {
     if (slotIndex == mCurrentTexture) {
         mCurrentTexture = BufferQueue::INVALID_BUFFER_SLOT;
     }
+    // Drop the cached image too so a freed buffer isn't pinned by the
+    // image cache.
+    if (mSlots[slotIndex].mGraphicBuffer != nullptr) {
+        const uint64_t bufferId = mSlots[slotIndex].mGraphicBuffer->getId();
+        for (auto it = mEglImageCache.begin(); it != mEglImageCache.end(); it++) {
+            if (it->first == bufferId) {
+                mEglImageCache.erase(it);
+                break;
+            }
+        }
+    }
     mEglSlots[slotIndex].mEglImage.clear();
     ConsumerBase::freeBufferLocked(slotIndex);
 }
@@ -915,6 +949,7 @@ void GLConsumer::freeBufferLocked(int slotIndex) {
 void GLConsumer::abandonLocked() {
     GLC_LOGV("abandonLocked");
     mCurrentTextureImage.clear();
+    mEglImageCache.clear();
     ConsumerBase::abandonLocked();
 }
 
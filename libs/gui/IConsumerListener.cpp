@@ -16,6 +16,8 @@
 
 #include <gui/IConsumerListener.h>
 
+#include <binder/IMemory.h>
+
 #include <gui/BufferItem.h>
 
 namespace android {
@@ -67,6 +69,11 @@ public:
                                   FrameEventHistoryDelta* /*outDelta*/) override {
         LOG_ALWAYS_FATAL("IConsumerListener::addAndGetFrameTimestamps cannot be proxied");
     }
+
+    sp<IMemory> getFrameTimestampsRing() override {
+        // Cannot be proxied; callers degrade to the binder query path.
+        return nullptr;
+    }
 };
 
 // Out-of-line virtual method definitions to trigger vtable emission in this translation unit (see
@@ -74,6 +81,10 @@ public:
 BpConsumerListener::~BpConsumerListener() = default;
 ConsumerListener::~ConsumerListener() = default;
 
+sp<IMemory> ConsumerListener::getFrameTimestampsRing() {
+    return nullptr;
+}
+
 IMPLEMENT_META_INTERFACE(ConsumerListener, "android.gui.IConsumerListener");
 
 status_t BnConsumerListener::onTransact(uint32_t code, const Parcel& data, Parcel* reply,
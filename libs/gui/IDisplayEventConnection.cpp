@@ -16,6 +16,7 @@
 
 #include <gui/IDisplayEventConnection.h>
 
+#include <binder/IMemory.h>
 #include <private/gui/BitTube.h>
 
 namespace android {
@@ -26,7 +27,9 @@ enum class Tag : uint32_t {
     STEAL_RECEIVE_CHANNEL = IBinder::FIRST_CALL_TRANSACTION,
     SET_VSYNC_RATE,
     REQUEST_NEXT_VSYNC,
-    LAST = REQUEST_NEXT_VSYNC,
+    GET_LATEST_VSYNC_RING,
+    SET_VSYNC_PHASE,
+    LAST = SET_VSYNC_PHASE,
 };
 
 } // Anonymous namespace
@@ -53,6 +56,17 @@ public:
         callRemoteAsync<decltype(&IDisplayEventConnection::requestNextVsync)>(
                 Tag::REQUEST_NEXT_VSYNC);
     }
+
+    status_t getLatestVsyncRing(sp<IMemory>* outRing) override {
+        return callRemote<decltype(
+                &IDisplayEventConnection::getLatestVsyncRing)>(Tag::GET_LATEST_VSYNC_RING,
+                                                               outRing);
+    }
+
+    status_t setVsyncPhase(uint32_t phase) override {
+        return callRemote<decltype(&IDisplayEventConnection::setVsyncPhase)>(Tag::SET_VSYNC_PHASE,
+                                                                             phase);
+    }
 };
 
 // Out-of-line virtual method definition to trigger vtable emission in this translation unit (see
@@ -74,6 +88,10 @@ status_t BnDisplayEventConnection::onTransact(uint32_t code, const Parcel& data,
             return callLocal(data, reply, &IDisplayEventConnection::setVsyncRate);
         case Tag::REQUEST_NEXT_VSYNC:
             return callLocalAsync(data, reply, &IDisplayEventConnection::requestNextVsync);
+        case Tag::GET_LATEST_VSYNC_RING:
+            return callLocal(data, reply, &IDisplayEventConnection::getLatestVsyncRing);
+        case Tag::SET_VSYNC_PHASE:
+            return callLocal(data, reply, &IDisplayEventConnection::setVsyncPhase);
     }
 }
 
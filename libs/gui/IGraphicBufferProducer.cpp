@@ -34,6 +34,7 @@
 #include <gui/bufferqueue/1.0/H2BGraphicBufferProducer.h>
 #include <gui/bufferqueue/2.0/H2BGraphicBufferProducer.h>
 #include <gui/BufferQueueDefs.h>
+#include <binder/IMemory.h>
 #include <gui/IGraphicBufferProducer.h>
 #include <gui/IProducerListener.h>
 
@@ -73,6 +74,8 @@ enum {
     GET_UNIQUE_ID,
     GET_CONSUMER_USAGE,
     SET_LEGACY_BUFFER_DROP,
+    QUEUE_AND_DEQUEUE_BUFFER,
+    GET_FRAME_TIMESTAMPS_RING,
 };
 
 class BpGraphicBufferProducer : public BpInterface<IGraphicBufferProducer>
@@ -277,6 +280,83 @@ public:
         return result;
     }
 
+    virtual status_t queueAndDequeueBuffer(int buf, const QueueBufferInput& input,
+                                           QueueBufferOutput* output, uint32_t width,
+                                           uint32_t height, PixelFormat format, uint64_t usage,
+                                           uint64_t* outBufferAge, int* outSlot,
+                                           sp<Fence>* outFence) {
+        Parcel data, reply;
+
+        data.writeInterfaceToken(IGraphicBufferProducer::getInterfaceDescriptor());
+        data.writeInt32(buf);
+        data.write(input);
+        data.writeUint32(width);
+        data.writeUint32(height);
+        data.writeInt32(static_cast<int32_t>(format));
+        data.writeUint64(usage);
+
+        status_t result = remote()->transact(QUEUE_AND_DEQUEUE_BUFFER, data, &reply);
+        if (result != NO_ERROR) {
+            return result;
+        }
+
+        result = reply.read(*output);
+        if (result != NO_ERROR) {
+            return result;
+        }
+
+        result = reply.readInt32();
+        if (result != NO_ERROR) {
+            return result;
+        }
+
+        *outSlot = reply.readInt32();
+        if (*outSlot >= 0) {
+            if (*outSlot >= BufferQueueDefs::NUM_BUFFER_SLOTS) {
+                ALOGE("queueAndDequeueBuffer returned invalid slot %d", *outSlot);
+                android_errorWriteLog(0x534e4554, "36991414"); // SafetyNet logging
+                return UNKNOWN_ERROR;
+            }
+            *outFence = new Fence();
+            result = reply.read(**outFence);
+            if (result != NO_ERROR) {
+                outFence->clear();
+                return result;
+            }
+            uint64_t bufferAge = 0;
+            result = reply.readUint64(&bufferAge);
+            if (result != NO_ERROR) {
+                return result;
+            }
+            if (outBufferAge) {
+                *outBufferAge = bufferAge;
+            }
+        } else {
+            *outFence = Fence::NO_FENCE;
+        }
+        return NO_ERROR;
+    }
+
+    virtual status_t getFrameTimestampsRing(sp<IMemory>* outRing) {
+        Parcel data, reply;
+        data.writeInterfaceToken(IGraphicBufferProducer::getInterfaceDescriptor());
+        status_t result = remote()->transact(GET_FRAME_TIMESTAMPS_RING, data, &reply);
+        if (result != NO_ERROR) {
+            return result;
+        }
+        result = reply.readInt32();
+        if (result != NO_ERROR) {
+            return result;
+        }
+        sp<IBinder> binder;
+        result = reply.readNullableStrongBinder(&binder);
+        if (result != NO_ERROR) {
+            return result;
+        }
+        *outRing = interface_cast<IMemory>(binder);
+        return *outRing != nullptr ? NO_ERROR : INVALID_OPERATION;
+    }
+
     virtual status_t cancelBuffer(int buf, const sp<Fence>& fence) {
         Parcel data, reply;
         data.writeInterfaceToken(IGraphicBufferProducer::getInterfaceDescriptor());
@@ -688,6 +768,29 @@ status_t IGraphicBufferProducer::setLegacyBufferDrop(bool drop) {
     return INVALID_OPERATION;
 }
 
+status_t IGraphicBufferProducer::queueAndDequeueBuffer(int slot, const QueueBufferInput& input,
+                                                       QueueBufferOutput* output, uint32_t width,
+                                                       uint32_t height, PixelFormat format,
+                                                       uint64_t usage, uint64_t* outBufferAge,
+                                                       int* outSlot, sp<Fence>* outFence) {
+    // Default for implementations that don't fuse: queue without
+    // prefetching; the caller dequeues normally later.
+    (void) width;
+    (void) height;
+    (void) format;
+    (void) usage;
+    (void) outBufferAge;
+    *outSlot = -1; // INVALID_BUFFER_SLOT: no prefetch
+    *outFence = Fence::NO_FENCE;
+    return queueBuffer(slot, input, output);
+}
+status_t IGraphicBufferProducer::getFrameTimestampsRing(sp<IMemory>* outRing) {
+    // No shared ring on implementations that don't publish one; callers
+    // fall back to getFrameTimestamps().
+    *outRing = nullptr;
+    return INVALID_OPERATION;
+}
+
 status_t IGraphicBufferProducer::exportToParcel(Parcel* parcel) {
     status_t res = OK;
     res = parcel->writeUint32(USE_BUFFER_QUEUE);
@@ -868,6 +971,39 @@ status_t BnGraphicBufferProducer::onTransact(
 
             return NO_ERROR;
         }
+        case QUEUE_AND_DEQUEUE_BUFFER: {
+            CHECK_INTERFACE(IGraphicBufferProducer, data, reply);
+
+            int buf = data.readInt32();
+            QueueBufferInput input(data);
+            uint32_t width = data.readUint32();
+            uint32_t height = data.readUint32();
+            PixelFormat format = static_cast<PixelFormat>(data.readInt32());
+            uint64_t usage = data.readUint64();
+
+            QueueBufferOutput output;
+            uint64_t bufferAge = 0;
+            int outSlot = -1;
+            sp<Fence> outFence(Fence::NO_FENCE);
+            status_t result = queueAndDequeueBuffer(buf, input, &output, width, height, format,
+                                                    usage, &bufferAge, &outSlot, &outFence);
+            reply->write(output);
+            reply->writeInt32(result);
+            reply->writeInt32(outSlot);
+            if (outSlot >= 0) {
+                reply->write(*outFence);
+                reply->writeUint64(bufferAge);
+            }
+            return NO_ERROR;
+        }
+        case GET_FRAME_TIMESTAMPS_RING: {
+            CHECK_INTERFACE(IGraphicBufferProducer, data, reply);
+            sp<IMemory> ring;
+            status_t result = getFrameTimestampsRing(&ring);
+            reply->writeInt32(result);
+            reply->writeStrongBinder(IInterface::asBinder(ring));
+            return NO_ERROR;
+        }
         case CANCEL_BUFFER: {
             CHECK_INTERFACE(IGraphicBufferProducer, data, reply);
             int buf = data.readInt32();
@@ -72,6 +72,16 @@ public:
                                      const client_cache_t& uncacheBuffer,
                                      const std::vector<ListenerCallbacks>& listenerCallbacks) {
         Parcel data, reply;
+
+        // This is every app's per-frame call; reserve a realistic capacity up
+        // front so marshalling a large transaction doesn't regrow (and
+        // recopy) the parcel several times.  layer_state_t dominates and is
+        // mostly fixed-size; the slack per state covers its variable tails
+        // (region rects, strings).  Over-reserving is transient and cheap,
+        // growth is not.
+        data.setDataCapacity(256 + state.size() * (sizeof(layer_state_t) + 128) +
+                             displays.size() * (sizeof(DisplayState) + 32));
+
         data.writeInterfaceToken(ISurfaceComposer::getInterfaceDescriptor());
 
         data.writeUint32(static_cast<uint32_t>(state.size()));
@@ -33,6 +33,9 @@
 
 #include <system/window.h>
 
+#include <future>
+#include <vector>
+
 namespace android {
 
 status_t StreamSplitter::createSplitter(
@@ -148,26 +151,36 @@ void StreamSplitter::onFrameAvailable(const BufferItem& /* item */) {
             static_cast<int32_t>(bufferItem.mScalingMode),
             bufferItem.mTransform, bufferItem.mFence);
 
-    // Attach and queue the buffer to each of the outputs
-    Vector<sp<IGraphicBufferProducer> >::iterator output = mOutputs.begin();
-    for (; output != mOutputs.end(); ++output) {
+    // Attach and queue the buffer to each of the outputs.  Each output's
+    // attach+queue pair is an independent (usually remote) call, so with more
+    // than one output the pairs are issued concurrently and the per-frame cost
+    // is the slowest output rather than the sum of all of them.  The workers
+    // touch no splitter state; abandonment is folded back in on this thread,
+    // which still holds mMutex.
+    auto attachAndQueue = [&queueInput](const sp<IGraphicBufferProducer>& output,
+            const sp<GraphicBuffer>& buffer) -> status_t {
         int slot;
-        status = (*output)->attachBuffer(&slot, bufferItem.mGraphicBuffer);
-        if (status == NO_INIT) {
-            // If we just discovered that this output has been abandoned, note
-            // that, increment the release count so that we still release this
-            // buffer eventually, and move on to the next output
-            onAbandonedLocked();
-            mBuffers.editValueFor(bufferItem.mGraphicBuffer->getId())->
-                    incrementReleaseCountLocked();
-            continue;
-        } else {
-            LOG_ALWAYS_FATAL_IF(status != NO_ERROR,
-                    "attaching buffer to output failed (%d)", status);
+        status_t status = output->attachBuffer(&slot, buffer);
+        if (status != NO_ERROR) {
+            return status;
         }
-
         IGraphicBufferProducer::QueueBufferOutput queueOutput;
-        status = (*output)->queueBuffer(slot, queueInput, &queueOutput);
+        return output->queueBuffer(slot, queueInput, &queueOutput);
+    };
+
+    std::vector<std::future<status_t>> pending;
+    if (mOutputs.size() > 1) {
+        pending.reserve(mOutputs.size());
+        for (const sp<IGraphicBufferProducer>& output : mOutputs) {
+            pending.push_back(std::async(std::launch::async, attachAndQueue,
+                    output, bufferItem.mGraphicBuffer));
+        }
+    }
+
+    for (size_t i = 0; i < mOutputs.size(); ++i) {
+        status = !pending.empty()
+                ? pending[i].get()
+                : attachAndQueue(mOutputs[i], bufferItem.mGraphicBuffer);
         if (status == NO_INIT) {
             // If we just discovered that this output has been abandoned, note
             // that, increment the release count so that we still release this
@@ -178,11 +191,11 @@ void StreamSplitter::onFrameAvailable(const BufferItem& /* item */) {
             continue;
         } else {
             LOG_ALWAYS_FATAL_IF(status != NO_ERROR,
-                    "queueing buffer to output failed (%d)", status);
+                    "attaching/queueing buffer to output failed (%d)", status);
         }
 
         ALOGV("queued buffer %#" PRIx64 " to output %p",
-                bufferItem.mGraphicBuffer->getId(), output->get());
+                bufferItem.mGraphicBuffer->getId(), mOutputs[i].get());
     }
 }
 
@@ -18,6 +18,7 @@
 #define ATRACE_TAG ATRACE_TAG_GRAPHICS
 //#define LOG_NDEBUG 0
 
+#include <binder/IMemory.h>
 #include <gui/Surface.h>
 
 #include <condition_variable>
@@ -50,6 +51,12 @@ namespace android {
 using ui::ColorMode;
 using ui::Dataspace;
 
+// Note on in-process producers: when bufferProducer refers to an object living
+// in this process (IInterface::asBinder(...)->localBinder() != nullptr), every
+// call below is already a direct virtual call into BufferQueueProducer -- the
+// binder framework only inserts Parcel marshalling for remote proxies
+// (BpGraphicBufferProducer).  No additional short-circuiting is needed or
+// possible here.
 Surface::Surface(const sp<IGraphicBufferProducer>& bufferProducer, bool controlledByApp)
       : mGraphicBufferProducer(bufferProducer),
         mCrop(Rect::EMPTY_RECT),
@@ -128,6 +135,11 @@ void Surface::allocateBuffers() {
             mReqFormat, mReqUsage);
 }
 
+void Surface::allocateBuffers(uint32_t width, uint32_t height) {
+    // resize hint: warm the free list at the destination size
+    mGraphicBufferProducer->allocateBuffers(width, height, mReqFormat, mReqUsage);
+}
+
 status_t Surface::setGenerationNumber(uint32_t generation) {
     status_t result = mGraphicBufferProducer->setGenerationNumber(generation);
     if (result == NO_ERROR) {
@@ -261,6 +273,75 @@ static void getFrameTimestampFence(nsecs_t *dst,
     }
 }
 
+bool Surface::getFrameTimestampsFromRingLocked(
+        uint64_t frameNumber, nsecs_t* outLatchTime, nsecs_t* outFirstRefreshStartTime,
+        nsecs_t* outLastRefreshStartTime, nsecs_t* outGpuCompositionDoneTime,
+        nsecs_t* outDisplayPresentTime, nsecs_t* outDequeueReadyTime, nsecs_t* outReleaseTime) {
+    if (mFrameTimestampsRing == nullptr) {
+        if (mFrameTimestampsRingFetched) {
+            return false;
+        }
+        mFrameTimestampsRingFetched = true;
+        sp<IMemory> memory;
+        if (mGraphicBufferProducer->getFrameTimestampsRing(&memory) != NO_ERROR ||
+            memory == nullptr || memory->pointer() == nullptr ||
+            memory->size() < sizeof(FrameTimestampsRing)) {
+            return false;
+        }
+        mFrameTimestampsRingMemory = memory;
+        mFrameTimestampsRing = static_cast<FrameTimestampsRing*>(memory->pointer());
+    }
+
+    const FrameTimestampsRing::Entry& entry =
+            mFrameTimestampsRing->entries[frameNumber % FrameTimestampsRing::kEntryCount];
+
+    // Seqlock read, bounded so a publisher dying mid-write cannot spin us.
+    uint64_t entryFrameNumber = 0;
+    int64_t latch = 0, firstRefresh = 0, lastRefresh = 0, gpuDone = 0, present = 0,
+            dequeueReady = 0, release = 0;
+    constexpr int kMaxRetries = 1000;
+    int retry = 0;
+    for (; retry < kMaxRetries; retry++) {
+        const uint32_t before = entry.seq.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        entryFrameNumber = entry.frameNumber;
+        latch = entry.latchTime;
+        firstRefresh = entry.firstRefreshStartTime;
+        lastRefresh = entry.lastRefreshStartTime;
+        gpuDone = entry.gpuCompositionDoneTime;
+        present = entry.displayPresentTime;
+        dequeueReady = entry.dequeueReadyTime;
+        release = entry.releaseTime;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (entry.seq.load(std::memory_order_relaxed) == before) {
+            break;
+        }
+    }
+    if (retry == kMaxRetries || entryFrameNumber != frameNumber) {
+        return false;
+    }
+
+    // The ring only wins if it can satisfy every requested consumer-side
+    // timestamp; 0 means the consumer hasn't resolved that time yet.
+    if ((outLatchTime && latch == 0) || (outFirstRefreshStartTime && firstRefresh == 0) ||
+        (outLastRefreshStartTime && lastRefresh == 0) ||
+        (outGpuCompositionDoneTime && gpuDone == 0) || (outDisplayPresentTime && present == 0) ||
+        (outDequeueReadyTime && dequeueReady == 0) || (outReleaseTime && release == 0)) {
+        return false;
+    }
+
+    if (outLatchTime) *outLatchTime = latch;
+    if (outFirstRefreshStartTime) *outFirstRefreshStartTime = firstRefresh;
+    if (outLastRefreshStartTime) *outLastRefreshStartTime = lastRefresh;
+    if (outGpuCompositionDoneTime) *outGpuCompositionDoneTime = gpuDone;
+    if (outDisplayPresentTime) *outDisplayPresentTime = present;
+    if (outDequeueReadyTime) *outDequeueReadyTime = dequeueReady;
+    if (outReleaseTime) *outReleaseTime = release;
+    return true;
+}
+
 status_t Surface::getFrameTimestamps(uint64_t frameNumber,
         nsecs_t* outRequestedPresentTime, nsecs_t* outAcquireTime,
         nsecs_t* outLatchTime, nsecs_t* outFirstRefreshStartTime,
@@ -293,10 +374,26 @@ status_t Surface::getFrameTimestamps(uint64_t frameNumber,
             outLatchTime, outFirstRefreshStartTime, outLastRefreshStartTime,
             outGpuCompositionDoneTime, outDisplayPresentTime,
             outDequeueReadyTime, outReleaseTime)) {
-        FrameEventHistoryDelta delta;
-        mGraphicBufferProducer->getFrameTimestamps(&delta);
-        mFrameEventHistory->applyDelta(delta);
-        events = mFrameEventHistory->getFrame(frameNumber);
+        if (getFrameTimestampsFromRingLocked(frameNumber, outLatchTime, outFirstRefreshStartTime,
+                                             outLastRefreshStartTime, outGpuCompositionDoneTime,
+                                             outDisplayPresentTime, outDequeueReadyTime,
+                                             outReleaseTime)) {
+            // Every requested consumer-side timestamp came from the
+            // shared ring with no IPC; only the producer-side values
+            // below are still read from the local history.
+            outLatchTime = nullptr;
+            outFirstRefreshStartTime = nullptr;
+            outLastRefreshStartTime = nullptr;
+            outGpuCompositionDoneTime = nullptr;
+            outDisplayPresentTime = nullptr;
+            outDequeueReadyTime = nullptr;
+            outReleaseTime = nullptr;
+        } else {
+            FrameEventHistoryDelta delta;
+            mGraphicBufferProducer->getFrameTimestamps(&delta);
+            mFrameEventHistory->applyDelta(delta);
+            events = mFrameEventHistory->getFrame(frameNumber);
+        }
     }
 
     if (events == nullptr) {
@@ -565,6 +662,33 @@ int Surface::dequeueBuffer(android_native_buffer_t** buffer, int* fenceFd) {
                 return OK;
             }
         }
+
+        if (mPrefetchedSlot != BufferItem::INVALID_BUFFER_SLOT) {
+            // A buffer was prefetched by the fused queue call; use it if
+            // the request parameters haven't changed and the buffer is in
+            // the client-side cache (so no requestBuffer trip is needed).
+            if (reqWidth == mPrefetchedWidth && reqHeight == mPrefetchedHeight &&
+                reqFormat == mPrefetchedFormat && reqUsage == mPrefetchedUsage &&
+                mSlots[mPrefetchedSlot].buffer != nullptr) {
+                const int buf = mPrefetchedSlot;
+                sp<Fence> fence(std::move(mPrefetchedFence));
+                mPrefetchedSlot = BufferItem::INVALID_BUFFER_SLOT;
+                mPrefetchedFence.clear();
+                mBufferAge = mPrefetchedBufferAge;
+
+                if (CC_UNLIKELY(atrace_is_tag_enabled(ATRACE_TAG_GRAPHICS))) {
+                    static FenceMonitor hwcReleaseThread("HWC release");
+                    hwcReleaseThread.queueFence(fence);
+                }
+
+                *fenceFd = (fence != nullptr && fence->isValid()) ? fence->dup() : -1;
+                *buffer = mSlots[buf].buffer.get();
+                return OK;
+            }
+            mGraphicBufferProducer->cancelBuffer(mPrefetchedSlot, mPrefetchedFence);
+            mPrefetchedSlot = BufferItem::INVALID_BUFFER_SLOT;
+            mPrefetchedFence.clear();
+        }
     } // Drop the lock so that we can still touch the Surface while blocking in IGBP::dequeueBuffer
 
     int buf = -1;
@@ -805,7 +929,31 @@ int Surface::queueBuffer(android_native_buffer_t* buffer, int fenceFd) {
     }
 
     nsecs_t now = systemTime();
-    status_t err = mGraphicBufferProducer->queueBuffer(i, input, &output);
+    status_t err;
+    if (!mSharedBufferMode && mPrefetchedSlot == BufferItem::INVALID_BUFFER_SLOT) {
+        // Fused call: the reply opportunistically carries the next free
+        // buffer, saving the dequeue round trip in steady state.
+        const uint32_t reqWidth = mReqWidth ? mReqWidth : mUserWidth;
+        const uint32_t reqHeight = mReqHeight ? mReqHeight : mUserHeight;
+        int prefetchedSlot = BufferItem::INVALID_BUFFER_SLOT;
+        sp<Fence> prefetchedFence;
+        uint64_t prefetchedAge = 0;
+        err = mGraphicBufferProducer->queueAndDequeueBuffer(i, input, &output, reqWidth,
+                                                            reqHeight, mReqFormat, mReqUsage,
+                                                            &prefetchedAge, &prefetchedSlot,
+                                                            &prefetchedFence);
+        if (err == OK && prefetchedSlot != BufferItem::INVALID_BUFFER_SLOT) {
+            mPrefetchedSlot = prefetchedSlot;
+            mPrefetchedFence = std::move(prefetchedFence);
+            mPrefetchedWidth = reqWidth;
+            mPrefetchedHeight = reqHeight;
+            mPrefetchedFormat = mReqFormat;
+            mPrefetchedUsage = mReqUsage;
+            mPrefetchedBufferAge = prefetchedAge;
+        }
+    } else {
+        err = mGraphicBufferProducer->queueBuffer(i, input, &output);
+    }
     mLastQueueDuration = systemTime() - now;
     if (err != OK)  {
         ALOGE("queueBuffer: error queuing buffer to SurfaceTexture, %d", err);
@@ -1337,6 +1485,11 @@ int Surface::disconnect(int api, IGraphicBufferProducer::DisconnectMode mode) {
     mRemovedBuffers.clear();
     mSharedBufferSlot = BufferItem::INVALID_BUFFER_SLOT;
     mSharedBufferHasBeenQueued = false;
+    if (mPrefetchedSlot != BufferItem::INVALID_BUFFER_SLOT) {
+        mGraphicBufferProducer->cancelBuffer(mPrefetchedSlot, mPrefetchedFence);
+        mPrefetchedSlot = BufferItem::INVALID_BUFFER_SLOT;
+        mPrefetchedFence.clear();
+    }
     freeAllBuffers();
     int err = mGraphicBufferProducer->disconnect(api, mode);
     if (!err) {
@@ -1511,6 +1664,14 @@ int Surface::setSharedBufferMode(bool sharedBufferMode) {
     ALOGV("Surface::setSharedBufferMode (%d)", sharedBufferMode);
     Mutex::Autolock lock(mMutex);
 
+    if (sharedBufferMode && mPrefetchedSlot != BufferItem::INVALID_BUFFER_SLOT) {
+        // Don't let a prefetched buffer sit dequeued under shared-buffer
+        // mode; give it back first.
+        mGraphicBufferProducer->cancelBuffer(mPrefetchedSlot, mPrefetchedFence);
+        mPrefetchedSlot = BufferItem::INVALID_BUFFER_SLOT;
+        mPrefetchedFence.clear();
+    }
+
     status_t err = mGraphicBufferProducer->setSharedBufferMode(
             sharedBufferMode);
     if (err == NO_ERROR) {
@@ -477,6 +477,7 @@ status_t SurfaceComposerClient::Transaction::apply(bool synchronous) {
 
     mForceSynchronous |= synchronous;
 
+    composerStates.setCapacity(mComposerStates.size());
     for (auto const& kv : mComposerStates){
         composerStates.add(kv.second);
     }
@@ -546,15 +547,19 @@ void SurfaceComposerClient::Transaction::setEarlyWakeup() {
 }
 
 layer_state_t* SurfaceComposerClient::Transaction::getLayerState(const sp<SurfaceControl>& sc) {
-    if (mComposerStates.count(sc) == 0) {
+    // Every set*() funnels through here; keep it to one hash lookup
+    // instead of a count() plus two operator[] probes with a full
+    // layer_state_t copy on first touch.
+    auto it = mComposerStates.find(sc);
+    if (it == mComposerStates.end()) {
         // we don't have it, add an initialized layer_state to our list
         ComposerState s;
         s.client = sc->getClient()->mClient;
         s.state.surface = sc->getHandle();
-        mComposerStates[sc] = s;
+        it = mComposerStates.emplace(sc, std::move(s)).first;
     }
 
-    return &(mComposerStates[sc].state);
+    return &(it->second.state);
 }
 
 void SurfaceComposerClient::Transaction::registerSurfaceControlForCallback(
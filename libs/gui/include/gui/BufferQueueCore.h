@@ -23,6 +23,7 @@
 #include <gui/OccupancyTracker.h>
 
 #include <utils/NativeHandle.h>
+#include <utils/Timers.h>
 #include <utils/RefBase.h>
 #include <utils/String8.h>
 #include <utils/StrongPointer.h>
@@ -283,6 +284,14 @@ private:
     // successful queueBuffer call and buffer allocation.
     uint64_t mFrameCounter;
 
+    // Queue-depth health accounting for dumpsys: total time producers spent
+    // blocked in dequeueBuffer waiting for a slot (and how often), and how
+    // many acquireBuffer calls found nothing queued.  Together these say
+    // whether this queue is under- or over-provisioned.
+    nsecs_t mDequeueBlockedNs;
+    uint64_t mDequeueBlockedCount;
+    uint64_t mAcquireStarvedCount;
+
     // mTransformHint is used to optimize for screen rotations.
     uint32_t mTransformHint;
 
@@ -114,6 +114,17 @@ public:
     virtual status_t queueBuffer(int slot,
             const QueueBufferInput& input, QueueBufferOutput* output);
 
+    // Fused queueBuffer plus an opportunistic, never-blocking dequeue of
+    // the next free buffer; see IGraphicBufferProducer.
+    virtual status_t queueAndDequeueBuffer(int slot, const QueueBufferInput& input,
+                                           QueueBufferOutput* output, uint32_t width,
+                                           uint32_t height, PixelFormat format, uint64_t usage,
+                                           uint64_t* outBufferAge, int* outSlot,
+                                           sp<Fence>* outFence);
+
+    // See IGraphicBufferProducer::getFrameTimestampsRing
+    virtual status_t getFrameTimestampsRing(sp<IMemory>* outRing);
+
     // cancelBuffer returns a dequeued buffer to the BufferQueue, but doesn't
     // queue it for use by the consumer.
     //
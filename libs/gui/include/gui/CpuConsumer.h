@@ -24,6 +24,9 @@
 
 #include <utils/Vector.h>
 
+#include <deque>
+#include <thread>
+
 
 namespace android {
 
@@ -111,7 +114,19 @@ class CpuConsumer : public ConsumerBase
     // lockNextBuffer.
     status_t unlockBuffer(const LockedBuffer &nativeBuffer);
 
+    // When enabled, newly arrived buffers are acquired and gralloc-locked on
+    // an internal thread as they become available (bounded by
+    // maxLockedBuffers), so lockNextBuffer typically hands back an
+    // already-mapped buffer instead of paying the mapping cost inline.
+    // Frames are still delivered strictly in queue order.
+    void setBufferPrefetchEnabled(bool enabled);
+
+  protected:
+    virtual void onFrameAvailable(const BufferItem& item) override;
+
   private:
+    virtual ~CpuConsumer();
+
     // Maximum number of buffers that can be locked at a time
     const size_t mMaxLockedBuffers;
 
@@ -146,6 +161,25 @@ class CpuConsumer : public ConsumerBase
 
     // Count of currently locked buffers
     size_t mCurrentLockedBuffers;
+
+    // Prefetch pipeline (see setBufferPrefetchEnabled).  All fields below are
+    // guarded by ConsumerBase::mMutex; the worker drops the mutex only for
+    // the gralloc lock call itself, with mPrefetchInFlight marking that
+    // window so lockNextBuffer cannot acquire a newer frame past it.
+    struct PrefetchedBuffer {
+        BufferItem item;
+        LockedBuffer buffer;
+    };
+    void prefetchLoop();
+    void drainPrefetchedLocked();
+    bool mPrefetchEnabled = false;
+    bool mPrefetchExit = false;
+    bool mPrefetchInFlight = false;
+    size_t mPrefetchPending = 0;
+    std::deque<PrefetchedBuffer> mPrefetched;
+    Condition mPrefetchWork;
+    Condition mPrefetchDone;
+    std::thread mPrefetchThread;
 };
 
 } // namespace android
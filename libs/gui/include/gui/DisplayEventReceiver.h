@@ -20,6 +20,8 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <atomic>
+
 #include <utils/Errors.h>
 #include <utils/RefBase.h>
 #include <utils/Timers.h>
@@ -35,6 +37,8 @@ namespace android {
 
 class IDisplayEventConnection;
 
+class IMemory;
+
 namespace gui {
 class BitTube;
 } // namespace gui
@@ -83,6 +87,17 @@ public:
         };
     };
 
+    /*
+     * Layout of the shared page into which the event thread publishes the
+     * latest vsync event.  seq is odd while the producer is mid-write;
+     * readers retry until they observe the same even value before and
+     * after copying the event.
+     */
+    struct VsyncEventRing {
+        std::atomic<uint32_t> seq;
+        Event event;
+    };
+
 public:
     /*
      * DisplayEventReceiver creates and registers an event connection with
@@ -138,15 +153,34 @@ public:
      */
     status_t setVsyncRate(uint32_t count);
 
+    /*
+     * setVsyncPhase() selects which event within the setVsyncRate() period
+     * is delivered: with a rate of N and a phase of P, vsyncs whose count is
+     * congruent to P modulo N are sent.  This lets a subsampled consumer
+     * align its wakeups to content updates instead of shifting them in
+     * userspace.
+     */
+    status_t setVsyncPhase(uint32_t phase);
+
     /*
      * requestNextVsync() schedules the next Event::VSync. It has no effect
      * if the vsync rate is > 0.
      */
     status_t requestNextVsync();
 
+    /*
+     * getLatestVsyncEvent() reads the most recently published vsync event
+     * from the shared ring without any IPC, mapping the ring on first
+     * use.  Returns NAME_NOT_FOUND until the first vsync has been
+     * published, or the error from fetching the ring.
+     */
+    status_t getLatestVsyncEvent(Event* outEvent);
+
 private:
     sp<IDisplayEventConnection> mEventConnection;
     std::unique_ptr<gui::BitTube> mDataChannel;
+    sp<IMemory> mVsyncRingMemory;
+    VsyncEventRing* mVsyncRing = nullptr;
 };
 
 // ----------------------------------------------------------------------------
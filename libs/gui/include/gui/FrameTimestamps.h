@@ -17,6 +17,8 @@
 #ifndef ANDROID_GUI_FRAMETIMESTAMPS_H
 #define ANDROID_GUI_FRAMETIMESTAMPS_H
 
+#include <atomic>
+
 #include <ui/FenceTime.h>
 #include <utils/Flattenable.h>
 #include <utils/StrongPointer.h>
@@ -29,6 +31,30 @@
 namespace android {
 
 struct FrameEvents;
+
+// Shared-memory ring through which the consumer (SurfaceFlinger) publishes
+// resolved consumer-side frame timestamps, letting clients poll
+// present/latch/GPU-done times with zero IPC.  Entries are keyed by
+// frameNumber % kEntryCount and stamped with a per-entry seqlock (odd
+// while the producer is mid-write).  A published value of 0 means "not
+// available yet"; readers fall back to the binder query.
+struct FrameTimestampsRing {
+    static constexpr size_t kEntryCount = 8;
+
+    struct Entry {
+        std::atomic<uint32_t> seq;
+        uint64_t frameNumber;
+        int64_t latchTime;
+        int64_t firstRefreshStartTime;
+        int64_t lastRefreshStartTime;
+        int64_t gpuCompositionDoneTime;
+        int64_t displayPresentTime;
+        int64_t dequeueReadyTime;
+        int64_t releaseTime;
+    };
+
+    Entry entries[kEntryCount];
+};
 class FrameEventHistoryDelta;
 
 
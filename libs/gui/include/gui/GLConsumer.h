@@ -20,6 +20,8 @@
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
 
+#include <list>
+
 #include <gui/BufferQueueDefs.h>
 #include <gui/ConsumerBase.h>
 
@@ -480,6 +482,11 @@ private:
     // of the buffer allocated to a slot.
     EglSlot mEglSlots[BufferQueueDefs::NUM_BUFFER_SLOTS];
 
+    // Images for recently seen buffers, keyed by buffer id so they
+    // survive slot recycling; see getImageForBufferLocked().
+    static constexpr size_t kEglImageCacheSize = 32;
+    std::list<std::pair<uint64_t, sp<EglImage>>> mEglImageCache;
+
     // mCurrentTexture is the buffer slot index of the buffer that is currently
     // bound to the OpenGL texture. It is initialized to INVALID_BUFFER_SLOT,
     // indicating that no buffer slot is currently bound to the texture. Note,
@@ -26,6 +26,8 @@
 
 namespace android {
 
+class IMemory;
+
 class BufferItem;
 class FrameEventHistoryDelta;
 struct NewFrameEventsEntry;
@@ -79,6 +81,12 @@ public:
     // WARNING: This method can only be called when the BufferQueue is in the consumer's process.
     virtual void addAndGetFrameTimestamps(const NewFrameEventsEntry* /*newTimestamps*/,
                                           FrameEventHistoryDelta* /*outDelta*/) {}
+
+    // Returns the shared-memory frame-timestamps ring published by the
+    // consumer, or nullptr when unsupported.
+    //
+    // WARNING: This method can only be called when the BufferQueue is in the consumer's process.
+    virtual sp<IMemory> getFrameTimestampsRing();
 };
 
 class IConsumerListener : public ConsumerListener, public IInterface {
@@ -25,6 +25,8 @@
 
 namespace android {
 
+class IMemory;
+
 namespace gui {
 class BitTube;
 } // namespace gui
@@ -47,10 +49,26 @@ public:
      */
     virtual status_t setVsyncRate(uint32_t count) = 0;
 
+    /*
+     * setVsyncPhase() selects which event within the setVsyncRate() period is delivered.
+     * With a rate of N, a phase of P (0 <= P < N) delivers the vsyncs whose count is congruent
+     * to P modulo N, letting subsampled consumers align their wakeups to content updates.
+     * Has no effect while the rate is 0 or 1.
+     */
+    virtual status_t setVsyncPhase(uint32_t phase) = 0;
+
     /*
      * requestNextVsync() schedules the next vsync event. It has no effect if the vsync rate is > 0.
      */
     virtual void requestNextVsync() = 0; // Asynchronous
+
+    /*
+     * getLatestVsyncRing() returns a read-only shared memory region into which the event thread
+     * continuously publishes the latest vsync event under a seqlock (see
+     * DisplayEventReceiver::VsyncEventRing).  Clients can poll the latest vsync without a socket
+     * round trip; the BitTube remains the doorbell for sleeping clients.
+     */
+    virtual status_t getLatestVsyncRing(sp<IMemory>* outRing) = 0;
 };
 
 class BnDisplayEventConnection : public SafeBnInterface<IDisplayEventConnection> {
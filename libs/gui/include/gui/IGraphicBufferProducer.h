@@ -41,6 +41,7 @@
 namespace android {
 // ----------------------------------------------------------------------------
 
+class IMemory;
 class IProducerListener;
 class NativeHandle;
 class Surface;
@@ -417,6 +418,28 @@ public:
     virtual status_t queueBuffer(int slot, const QueueBufferInput& input,
             QueueBufferOutput* output) = 0;
 
+    // queueAndDequeueBuffer fuses queueBuffer with an opportunistic dequeue
+    // of the next buffer in the same transaction, halving steady-state IPC
+    // on the queue/dequeue cycle.  On success *outSlot holds the
+    // prefetched slot, or INVALID_BUFFER_SLOT (-1) when no buffer was
+    // immediately free (or the implementation does not fuse), in which
+    // case the caller simply dequeues normally later.  A prefetched slot
+    // never carries dequeue return flags: implementations cancel and
+    // report no prefetch instead of returning BUFFER_NEEDS_REALLOCATION.
+    //
+    // The default implementation queues without prefetching.
+    virtual status_t queueAndDequeueBuffer(int slot, const QueueBufferInput& input,
+                                           QueueBufferOutput* output, uint32_t width,
+                                           uint32_t height, PixelFormat format, uint64_t usage,
+                                           uint64_t* outBufferAge, int* outSlot,
+                                           sp<Fence>* outFence);
+
+    // Returns the consumer's shared-memory frame-timestamps ring (see
+    // FrameTimestampsRing), letting clients poll resolved consumer-side
+    // timestamps with no IPC.  The default implementation returns
+    // INVALID_OPERATION; callers fall back to getFrameTimestamps().
+    virtual status_t getFrameTimestampsRing(sp<IMemory>* outRing);
+
     // cancelBuffer indicates that the client does not wish to fill in the
     // buffer associated with slot and transfers ownership of the slot back to
     // the server.
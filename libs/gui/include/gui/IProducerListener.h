@@ -45,6 +45,14 @@ public:
     // This is called without any lock held and can be called concurrently by
     // multiple threads.
     virtual void onBufferReleased() = 0; // Asynchronous
+    // Returns true if the producer actually wants onBufferReleased()
+    // callbacks.  The consumer side queries this once at connect and
+    // skips the callback entirely when false -- which is the default for
+    // plain Surface::connect(api) users (DummyProducerListener), so
+    // steady-state queues without an interested producer pay no
+    // per-release IPC at all.  Same-process listeners are invoked as
+    // direct virtual calls, and the consumer fires the callback outside
+    // the queue lock in both directions.
     virtual bool needsReleaseNotify() = 0;
     // onBuffersFreed is called from IGraphicBufferConsumer::discardFreeBuffers
     // to notify the producer that certain free buffers are discarded by the consumer.
@@ -34,7 +34,10 @@
 
 namespace android {
 
+class IMemory;
+
 class ISurfaceComposer;
+struct FrameTimestampsRing;
 
 /* This is the same as ProducerListener except that onBuffersDiscarded is
  * called with a vector of graphic buffers instead of buffer slots.
@@ -122,6 +125,15 @@ public:
      */
     void allocateBuffers();
 
+    /* Pre-allocates buffers at an explicit size, ahead of the producer
+     * actually rendering at it.  A window animating toward a known final
+     * size can call this with the end state so the dequeueBuffer() at that
+     * size finds matching free buffers instead of blocking the render
+     * thread on gralloc mid-animation.  Like allocateBuffers(), the call is
+     * a oneway binder transaction: allocation proceeds off the caller's
+     * thread. */
+    void allocateBuffers(uint32_t width, uint32_t height);
+
     /* Sets the generation number on the IGraphicBufferProducer and updates the
      * generation number on any buffers attached to the Surface after this call.
      * See IGBP::setGenerationNumber for more information. */
@@ -500,6 +512,31 @@ protected:
     mutable bool mQueriedSupportedTimestamps;
     mutable bool mFrameTimestampsSupportsPresent;
 
+    // Buffer prefetched by the fused queueAndDequeueBuffer() call, and the
+    // request parameters it was dequeued with; consumed by the next
+    // dequeueBuffer() when the parameters still match, cancelled
+    // otherwise.  Protected by mMutex.
+    int mPrefetchedSlot{-1};
+    sp<Fence> mPrefetchedFence;
+    uint32_t mPrefetchedWidth{0};
+    uint32_t mPrefetchedHeight{0};
+    PixelFormat mPrefetchedFormat{0};
+    uint64_t mPrefetchedUsage{0};
+    uint64_t mPrefetchedBufferAge{0};
+
+    // Shared-memory frame-timestamps ring published by the consumer;
+    // fetched lazily, read by getFrameTimestamps() before falling back to
+    // the binder query.
+    bool getFrameTimestampsFromRingLocked(uint64_t frameNumber, nsecs_t* outLatchTime,
+                                          nsecs_t* outFirstRefreshStartTime,
+                                          nsecs_t* outLastRefreshStartTime,
+                                          nsecs_t* outGpuCompositionDoneTime,
+                                          nsecs_t* outDisplayPresentTime,
+                                          nsecs_t* outDequeueReadyTime, nsecs_t* outReleaseTime);
+    sp<IMemory> mFrameTimestampsRingMemory;
+    FrameTimestampsRing* mFrameTimestampsRing{nullptr};
+    bool mFrameTimestampsRingFetched{false};
+
     // A cached copy of the FrameEventHistory maintained by the consumer.
     bool mEnableFrameTimestamps = false;
     std::unique_ptr<ProducerFrameEventHistory> mFrameEventHistory;
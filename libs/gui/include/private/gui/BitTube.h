@@ -17,6 +17,8 @@
 #pragma once
 
 #include <android-base/unique_fd.h>
+#include <atomic>
+
 #include <binder/Parcelable.h>
 #include <utils/Errors.h>
 
@@ -58,6 +60,11 @@ public:
     // resets this BitTube's receive file descriptor to receiveFd
     void setReceiveFd(base::unique_fd&& receiveFd);
 
+    // Number of sendObjects() calls this tube failed with a full socket
+    // (objects dropped by the caller); lets consumers like EventThread
+    // surface sustained overruns in dumps instead of losing them to logs.
+    uint32_t getDroppedSendCount() const { return mDroppedSends.load(std::memory_order_relaxed); }
+
     // send objects (sized blobs). All objects are guaranteed to be written or the call fails.
     template <typename T>
     static ssize_t sendObjects(BitTube* tube, T const* events, size_t count) {
@@ -87,6 +94,7 @@ private:
 
     base::unique_fd mSendFd;
     mutable base::unique_fd mReceiveFd;
+    mutable std::atomic<uint32_t> mDroppedSends{0};
 
     static ssize_t sendObjects(BitTube* tube, void const* events, size_t count, size_t objSize);
 
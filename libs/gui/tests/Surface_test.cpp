@@ -519,6 +519,44 @@ TEST_F(SurfaceTest, DynamicSetBufferCount) {
     ASSERT_EQ(NO_ERROR, window->queueBuffer(window.get(), buffer, fence));
 }
 
+// An IGraphicBufferProducer created in-process is a local binder object;
+// Surface's calls on it dispatch directly into BufferQueueProducer with no
+// Parcel marshalling, and therefore keep strict call ordering.  Pin that down
+// so a regression to proxy-based dispatch (which would add a marshalling copy
+// per queueBuffer) is caught.
+TEST_F(SurfaceTest, LocalProducerDispatchesWithoutBinder) {
+    sp<IGraphicBufferProducer> producer;
+    sp<IGraphicBufferConsumer> consumer;
+    BufferQueue::createBufferQueue(&producer, &consumer);
+
+    sp<DummyConsumer> dummyConsumer(new DummyConsumer);
+    consumer->consumerConnect(dummyConsumer, false);
+    consumer->setConsumerName(String8("TestConsumer"));
+
+    sp<Surface> surface = new Surface(producer);
+    sp<IBinder> producerBinder = IInterface::asBinder(surface->getIGraphicBufferProducer());
+    ASSERT_NE(nullptr, producerBinder->localBinder());
+    ASSERT_EQ(nullptr, producerBinder->remoteBinder());
+
+    // The direct path must preserve dequeue/queue ordering: buffers come back
+    // in the order they were queued.
+    sp<ANativeWindow> window(surface);
+    ASSERT_EQ(NO_ERROR, native_window_api_connect(window.get(), NATIVE_WINDOW_API_CPU));
+    ASSERT_EQ(NO_ERROR, native_window_set_buffer_count(window.get(), 3));
+
+    int fence;
+    ANativeWindowBuffer* buffer;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(NO_ERROR, window->dequeueBuffer(window.get(), &buffer, &fence));
+        ASSERT_EQ(NO_ERROR, window->queueBuffer(window.get(), buffer, fence));
+        BufferItem item;
+        ASSERT_EQ(NO_ERROR, consumer->acquireBuffer(&item, 0));
+        EXPECT_EQ(i, static_cast<int>(item.mFrameNumber - 1));
+        ASSERT_EQ(NO_ERROR, consumer->releaseBuffer(item.mSlot, item.mFrameNumber,
+                EGL_NO_DISPLAY, EGL_NO_SYNC_KHR, item.mFence));
+    }
+}
+
 TEST_F(SurfaceTest, GetAndFlushRemovedBuffers) {
     sp<IGraphicBufferProducer> producer;
     sp<IGraphicBufferConsumer> consumer;
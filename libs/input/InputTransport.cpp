@@ -49,8 +49,21 @@ static const size_t SOCKET_BUFFER_SIZE = 32 * 1024;
 static const nsecs_t NANOS_PER_MS = 1000000;
 
 // Latency added during resampling.  A few milliseconds doesn't hurt much but
-// reduces the impact of mispredicted touch positions.
-static const nsecs_t RESAMPLE_LATENCY = 5 * NANOS_PER_MS;
+// reduces the impact of mispredicted touch positions.  Tunable via
+// ro.input.resampling.latency_ms (stylus-latency experiments trade this
+// against extrapolation overshoot); clamped to [0, 20] ms.
+static const nsecs_t RESAMPLE_LATENCY_DEFAULT_MS = 5;
+
+static nsecs_t resampleLatency() {
+    static const nsecs_t latency = [] {
+        int64_t ms = property_get_int64("ro.input.resampling.latency_ms",
+                                        RESAMPLE_LATENCY_DEFAULT_MS);
+        if (ms < 0) ms = 0;
+        if (ms > 20) ms = 20;
+        return ms * NANOS_PER_MS;
+    }();
+    return latency;
+}
 
 // Minimum time difference between consecutive samples before attempting to resample.
 static const nsecs_t RESAMPLE_MIN_DELTA = 2 * NANOS_PER_MS;
@@ -285,16 +298,45 @@ status_t InputChannel::sendMessage(const InputMessage* msg) {
     const size_t msgLength = msg->size();
     InputMessage cleanMsg;
     msg->getSanitizedCopy(&cleanMsg);
+
+    if (!mBatchingSends && !mSendBatch.empty()) {
+        // A previous batch is still parked (its flush returned
+        // WOULD_BLOCK); it must go out first to keep ordering.
+        status_t result = flushMessageBatch();
+        if (result != OK) {
+            return result;
+        }
+    }
+
+    if (mBatchingSends) {
+        // Stage the message; it goes out with the next flush as part of a
+        // single datagram.  Flush eagerly once the batch is full.
+        if (mSendBatch.size() + msgLength >
+            kMaxBatchedMessages * sizeof(InputMessage)) {
+            status_t result = flushMessageBatch();
+            if (result != OK) {
+                return result;
+            }
+            mBatchingSends = true;
+        }
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&cleanMsg);
+        mSendBatch.insert(mSendBatch.end(), bytes, bytes + msgLength);
+        return OK;
+    }
+
+    return sendBytes(&cleanMsg, msgLength);
+}
+
+status_t InputChannel::sendBytes(const void* data, size_t size) {
     ssize_t nWrite;
     do {
-        nWrite = ::send(mFd, &cleanMsg, msgLength, MSG_DONTWAIT | MSG_NOSIGNAL);
+        nWrite = ::send(mFd, data, size, MSG_DONTWAIT | MSG_NOSIGNAL);
     } while (nWrite == -1 && errno == EINTR);
 
     if (nWrite < 0) {
         int error = errno;
 #if DEBUG_CHANNEL_MESSAGES
-        ALOGD("channel '%s' ~ error sending message of type %d, errno=%d", mName.c_str(),
-                msg->header.type, error);
+        ALOGD("channel '%s' ~ error sending message, errno=%d", mName.c_str(), error);
 #endif
         if (error == EAGAIN || error == EWOULDBLOCK) {
             return WOULD_BLOCK;
@@ -305,24 +347,67 @@ status_t InputChannel::sendMessage(const InputMessage* msg) {
         return -error;
     }
 
-    if (size_t(nWrite) != msgLength) {
+    if (size_t(nWrite) != size) {
 #if DEBUG_CHANNEL_MESSAGES
-        ALOGD("channel '%s' ~ error sending message type %d, send was incomplete",
-                mName.c_str(), msg->header.type);
+        ALOGD("channel '%s' ~ error sending message, send was incomplete", mName.c_str());
 #endif
         return DEAD_OBJECT;
     }
 
 #if DEBUG_CHANNEL_MESSAGES
-    ALOGD("channel '%s' ~ sent message of type %d", mName.c_str(), msg->header.type);
+    ALOGD("channel '%s' ~ sent %zu bytes", mName.c_str(), size);
 #endif
     return OK;
 }
 
+void InputChannel::startMessageBatch() {
+    mBatchingSends = true;
+}
+
+status_t InputChannel::flushMessageBatch() {
+    mBatchingSends = false;
+    if (mSendBatch.empty()) {
+        return OK;
+    }
+    status_t result = sendBytes(mSendBatch.data(), mSendBatch.size());
+    if (result == WOULD_BLOCK) {
+        // Keep the staged bytes; the next flush retries them ahead of any
+        // newly staged messages, preserving ordering.
+        return WOULD_BLOCK;
+    }
+    mSendBatch.clear();
+    return result;
+}
+
 status_t InputChannel::receiveMessage(InputMessage* msg) {
+    // Hand out any messages left over from a previously received batched
+    // datagram first.
+    if (mPendingReceivedOffset < mPendingReceived.size()) {
+        const size_t remaining = mPendingReceived.size() - mPendingReceivedOffset;
+        const InputMessage* pending = reinterpret_cast<const InputMessage*>(
+                mPendingReceived.data() + mPendingReceivedOffset);
+        const size_t pendingSize = remaining >= sizeof(InputMessage::Header)
+                ? pending->size()
+                : 0;
+        if (pendingSize == 0 || pendingSize > remaining || !pending->isValid(pendingSize)) {
+            mPendingReceived.clear();
+            mPendingReceivedOffset = 0;
+            return BAD_VALUE;
+        }
+        memcpy(msg, pending, pendingSize);
+        mPendingReceivedOffset += pendingSize;
+        if (mPendingReceivedOffset >= mPendingReceived.size()) {
+            mPendingReceived.clear();
+            mPendingReceivedOffset = 0;
+        }
+        return OK;
+    }
+
+    uint8_t buffer[kMaxBatchedMessages * sizeof(InputMessage)]
+            __attribute__((aligned(alignof(InputMessage))));
     ssize_t nRead;
     do {
-        nRead = ::recv(mFd, msg, sizeof(InputMessage), MSG_DONTWAIT);
+        nRead = ::recv(mFd, buffer, sizeof(buffer), MSG_DONTWAIT);
     } while (nRead == -1 && errno == EINTR);
 
     if (nRead < 0) {
@@ -346,12 +431,23 @@ status_t InputChannel::receiveMessage(InputMessage* msg) {
         return DEAD_OBJECT;
     }
 
-    if (!msg->isValid(nRead)) {
+    const InputMessage* first = reinterpret_cast<const InputMessage*>(buffer);
+    const size_t firstSize =
+            size_t(nRead) >= sizeof(InputMessage::Header) ? first->size() : 0;
+    if (firstSize == 0 || firstSize > size_t(nRead) || !first->isValid(firstSize)) {
 #if DEBUG_CHANNEL_MESSAGES
         ALOGD("channel '%s' ~ received invalid message", mName.c_str());
 #endif
         return BAD_VALUE;
     }
+    memcpy(msg, buffer, firstSize);
+
+    // A batched datagram carries several messages; park the rest for the
+    // following receiveMessage() calls.
+    if (size_t(nRead) > firstSize) {
+        mPendingReceived.assign(buffer + firstSize, buffer + nRead);
+        mPendingReceivedOffset = 0;
+    }
 
 #if DEBUG_CHANNEL_MESSAGES
     ALOGD("channel '%s' ~ received message of type %d", mName.c_str(), msg->header.type);
@@ -721,7 +817,7 @@ status_t InputConsumer::consumeBatch(InputEventFactoryInterface* factory,
 
         nsecs_t sampleTime = frameTime;
         if (mResampleTouch) {
-            sampleTime -= RESAMPLE_LATENCY;
+            sampleTime -= resampleLatency();
         }
         ssize_t split = findSampleNoLaterThan(batch, sampleTime);
         if (split < 0) {
@@ -1051,12 +1147,18 @@ status_t InputConsumer::sendFinishedSignal(uint32_t seq, bool handled) {
                  mSeqChains.removeAt(i);
              }
         }
+        // The whole chain of acks leaves as one (or a few) datagrams
+        // instead of one syscall per consumed sample.
+        mChannel->startMessageBatch();
         status_t status = OK;
         while (!status && chainIndex > 0) {
             chainIndex--;
             status = sendUnchainedFinishedSignal(chainSeqs[chainIndex], handled);
         }
         if (status) {
+            // Best effort; bytes staged so far are retried by a later
+            // flush, ahead of any newer message.
+            mChannel->flushMessageBatch();
             // An error occurred so at least one signal was not sent, reconstruct the chain.
             for (;;) {
                 SeqChain seqChain;
@@ -1068,6 +1170,11 @@ status_t InputConsumer::sendFinishedSignal(uint32_t seq, bool handled) {
             }
             return status;
         }
+
+        // Stage the final ack into the same datagram and flush.
+        status = sendUnchainedFinishedSignal(seq, handled);
+        const status_t flushStatus = mChannel->flushMessageBatch();
+        return status ? status : flushStatus;
     }
 
     // Send finished signal for the last message in the batch.
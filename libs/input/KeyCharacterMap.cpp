@@ -18,6 +18,10 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+
+#include <mutex>
+#include <unordered_map>
 
 #ifdef __ANDROID__
 #include <binder/Parcel.h>
@@ -106,10 +110,36 @@ KeyCharacterMap::~KeyCharacterMap() {
     }
 }
 
+// In-process cache of parsed maps, keyed by filename and load format.  Key character maps are
+// immutable once loaded (combine() copies), so devices that share a .kcm file -- virtual
+// keyboards and rehotplugged peripherals especially -- can share the parsed representation.
+// Entries are revalidated against the file's identity and modification time.
+struct CachedCharacterMap {
+    ino_t inode;
+    off_t size;
+    time_t modifiedTime;
+    sp<KeyCharacterMap> map;
+};
+static std::mutex gCachedCharacterMapsLock;
+static std::unordered_map<std::string, CachedCharacterMap> gCachedCharacterMaps;
+
 status_t KeyCharacterMap::load(const std::string& filename,
         Format format, sp<KeyCharacterMap>* outMap) {
     outMap->clear();
 
+    const std::string cacheKey = filename + "|" + std::to_string(format);
+    struct stat st;
+    const bool haveStat = !stat(filename.c_str(), &st);
+    if (haveStat) {
+        std::lock_guard<std::mutex> lock(gCachedCharacterMapsLock);
+        auto it = gCachedCharacterMaps.find(cacheKey);
+        if (it != gCachedCharacterMaps.end() && it->second.inode == st.st_ino
+                && it->second.size == st.st_size && it->second.modifiedTime == st.st_mtime) {
+            *outMap = it->second.map;
+            return NO_ERROR;
+        }
+    }
+
     Tokenizer* tokenizer;
     status_t status = Tokenizer::open(String8(filename.c_str()), &tokenizer);
     if (status) {
@@ -117,6 +147,10 @@ status_t KeyCharacterMap::load(const std::string& filename,
     } else {
         status = load(tokenizer, format, outMap);
         delete tokenizer;
+        if (!status && haveStat) {
+            std::lock_guard<std::mutex> lock(gCachedCharacterMapsLock);
+            gCachedCharacterMaps[cacheKey] = {st.st_ino, st.st_size, st.st_mtime, *outMap};
+        }
     }
     return status;
 }
@@ -17,6 +17,10 @@
 #define LOG_TAG "KeyLayoutMap"
 
 #include <stdlib.h>
+#include <sys/stat.h>
+
+#include <mutex>
+#include <unordered_map>
 
 #include <android/keycodes.h>
 #include <input/InputEventLabels.h>
@@ -41,6 +45,20 @@ namespace android {
 
 static const char* WHITESPACE = " \t\r";
 
+// In-process cache of parsed layouts.  The maps are immutable once loaded and the same handful
+// of .kl files back most devices, so re-opens (boot enumeration, USB hotplug) can share the
+// parsed representation instead of tokenizing the file again.  Entries are revalidated against
+// the file's identity and modification time so a pushed .kl during development still takes
+// effect on the next device add.
+struct CachedLayout {
+    ino_t inode;
+    off_t size;
+    time_t modifiedTime;
+    sp<KeyLayoutMap> map;
+};
+static std::mutex gCachedLayoutsLock;
+static std::unordered_map<std::string, CachedLayout> gCachedLayouts;
+
 // --- KeyLayoutMap ---
 
 KeyLayoutMap::KeyLayoutMap() {
@@ -52,6 +70,18 @@ KeyLayoutMap::~KeyLayoutMap() {
 status_t KeyLayoutMap::load(const std::string& filename, sp<KeyLayoutMap>* outMap) {
     outMap->clear();
 
+    struct stat st;
+    const bool haveStat = !stat(filename.c_str(), &st);
+    if (haveStat) {
+        std::lock_guard<std::mutex> lock(gCachedLayoutsLock);
+        auto it = gCachedLayouts.find(filename);
+        if (it != gCachedLayouts.end() && it->second.inode == st.st_ino
+                && it->second.size == st.st_size && it->second.modifiedTime == st.st_mtime) {
+            *outMap = it->second.map;
+            return NO_ERROR;
+        }
+    }
+
     Tokenizer* tokenizer;
     status_t status = Tokenizer::open(String8(filename.c_str()), &tokenizer);
     if (status) {
@@ -75,6 +105,10 @@ status_t KeyLayoutMap::load(const std::string& filename, sp<KeyLayoutMap>* outMa
 #endif
             if (!status) {
                 *outMap = map;
+                if (haveStat) {
+                    std::lock_guard<std::mutex> lock(gCachedLayoutsLock);
+                    gCachedLayouts[filename] = {st.st_ino, st.st_size, st.st_mtime, map};
+                }
             }
         }
         delete tokenizer;
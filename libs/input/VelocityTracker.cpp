@@ -47,23 +47,6 @@ static const nsecs_t NANOS_PER_MS = 1000000;
 static const nsecs_t ASSUME_POINTER_STOPPED_TIME = 40 * NANOS_PER_MS;
 
 
-static float vectorDot(const float* a, const float* b, uint32_t m) {
-    float r = 0;
-    for (size_t i = 0; i < m; i++) {
-        r += *(a++) * *(b++);
-    }
-    return r;
-}
-
-static float vectorNorm(const float* a, uint32_t m) {
-    float r = 0;
-    for (size_t i = 0; i < m; i++) {
-        float t = *(a++);
-        r += t * t;
-    }
-    return sqrtf(r);
-}
-
 #if DEBUG_STRATEGY || DEBUG_VELOCITY
 static std::string vectorToString(const float* a, uint32_t m) {
     std::string str;
@@ -461,79 +444,74 @@ static bool solveLeastSquares(const float* x, const float* y,
             vectorToString(w, m).c_str());
 #endif
 
-    // Expand the X vector to a matrix A, pre-multiplied by the weights.
-    float a[n][m]; // column-major order
+    // Solve the weighted normal equations (At W2 A) B = At W2 Y instead of
+    // factoring the m x n design matrix: the columns of A are powers of x,
+    // so the Gram matrix entries are weighted power sums that accumulate in
+    // O(degree) per sample, and the remaining solve is a tiny n x n
+    // elimination.  Accumulation runs in double to make up for the squared
+    // conditioning of the normal equations; with the sub-second ages and
+    // low degrees used here that leaves ample precision.
+    double s[2 * VelocityTracker::Estimator::MAX_DEGREE + 1] = {};
+    double t[VelocityTracker::Estimator::MAX_DEGREE + 1] = {};
     for (uint32_t h = 0; h < m; h++) {
-        a[0][h] = w[h];
-        for (uint32_t i = 1; i < n; i++) {
-            a[i][h] = a[i - 1][h] * x[h];
+        const double ww = double(w[h]) * double(w[h]);
+        const double xv = x[h];
+        const double yv = y[h];
+        double xk = ww;
+        for (uint32_t k = 0; k <= 2 * (n - 1); k++) {
+            s[k] += xk;
+            if (k < n) {
+                t[k] += xk * yv;
+            }
+            xk *= xv;
         }
     }
-#if DEBUG_STRATEGY
-    ALOGD("  - a=%s", matrixToString(&a[0][0], m, n, false /*rowMajor*/).c_str());
-#endif
 
-    // Apply the Gram-Schmidt process to A to obtain its QR decomposition.
-    float q[n][m]; // orthonormal basis, column-major order
-    float r[n][n]; // upper triangular matrix, row-major order
-    for (uint32_t j = 0; j < n; j++) {
-        for (uint32_t h = 0; h < m; h++) {
-            q[j][h] = a[j][h];
+    // Gaussian elimination with partial pivoting on the augmented system.
+    double g[VelocityTracker::Estimator::MAX_DEGREE + 1]
+            [VelocityTracker::Estimator::MAX_DEGREE + 2];
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint32_t j = 0; j < n; j++) {
+            g[i][j] = s[i + j];
         }
-        for (uint32_t i = 0; i < j; i++) {
-            float dot = vectorDot(&q[j][0], &q[i][0], m);
-            for (uint32_t h = 0; h < m; h++) {
-                q[j][h] -= dot * q[i][h];
+        g[i][n] = t[i];
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t pivot = i;
+        for (uint32_t k = i + 1; k < n; k++) {
+            if (fabs(g[k][i]) > fabs(g[pivot][i])) {
+                pivot = k;
             }
         }
-
-        float norm = vectorNorm(&q[j][0], m);
-        if (norm < 0.000001f) {
-            // vectors are linearly dependent or zero so no solution
+        if (fabs(g[pivot][i]) < 1e-12) {
+            // The samples are linearly dependent (e.g. duplicated times);
+            // no solution.
 #if DEBUG_STRATEGY
-            ALOGD("  - no solution, norm=%f", norm);
+            ALOGD("  - no solution, pivot=%f", fabs(g[pivot][i]));
 #endif
             return false;
         }
-
-        float invNorm = 1.0f / norm;
-        for (uint32_t h = 0; h < m; h++) {
-            q[j][h] *= invNorm;
-        }
-        for (uint32_t i = 0; i < n; i++) {
-            r[j][i] = i < j ? 0 : vectorDot(&q[j][0], &a[i][0], m);
+        if (pivot != i) {
+            for (uint32_t j = 0; j <= n; j++) {
+                const double tmp = g[i][j];
+                g[i][j] = g[pivot][j];
+                g[pivot][j] = tmp;
+            }
         }
-    }
-#if DEBUG_STRATEGY
-    ALOGD("  - q=%s", matrixToString(&q[0][0], m, n, false /*rowMajor*/).c_str());
-    ALOGD("  - r=%s", matrixToString(&r[0][0], n, n, true /*rowMajor*/).c_str());
-
-    // calculate QR, if we factored A correctly then QR should equal A
-    float qr[n][m];
-    for (uint32_t h = 0; h < m; h++) {
-        for (uint32_t i = 0; i < n; i++) {
-            qr[i][h] = 0;
-            for (uint32_t j = 0; j < n; j++) {
-                qr[i][h] += q[j][h] * r[j][i];
+        for (uint32_t k = i + 1; k < n; k++) {
+            const double f = g[k][i] / g[i][i];
+            for (uint32_t j = i; j <= n; j++) {
+                g[k][j] -= f * g[i][j];
             }
         }
     }
-    ALOGD("  - qr=%s", matrixToString(&qr[0][0], m, n, false /*rowMajor*/).c_str());
-#endif
-
-    // Solve R B = Qt W Y to find B.  This is easy because R is upper triangular.
-    // We just work from bottom-right to top-left calculating B's coefficients.
-    float wy[m];
-    for (uint32_t h = 0; h < m; h++) {
-        wy[h] = y[h] * w[h];
-    }
     for (uint32_t i = n; i != 0; ) {
         i--;
-        outB[i] = vectorDot(&q[i][0], wy, m);
-        for (uint32_t j = n - 1; j > i; j--) {
-            outB[i] -= r[i][j] * outB[j];
+        double b = g[i][n];
+        for (uint32_t j = i + 1; j < n; j++) {
+            b -= g[i][j] * outB[j];
         }
-        outB[i] /= r[i][i];
+        outB[i] = float(b / g[i][i]);
     }
 #if DEBUG_STRATEGY
     ALOGD("  - b=%s", vectorToString(outB, n).c_str());
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <iosfwd>
 #include <limits>
@@ -154,6 +155,45 @@ inline CONSTEXPR android::half operator"" _hf(long double v) {
     return android::half(android::half::binary, android::half::ftoh(static_cast<float>(v)).bits);
 }
 
+/*
+ * Bulk span conversions, for pixel data (FP16 render targets, HDR
+ * screenshots) where converting element-by-element through the scalar
+ * bit manipulation above costs milliseconds per frame.  On targets with
+ * IEEE half-precision hardware (AArch64, and AArch32 with the FP16
+ * extension) the loops below compile to vectorized vcvt sequences.
+ *
+ * Note the hardware path is slightly better behaved than the scalar
+ * fallback: it honors denormals and rounds to nearest-even, where
+ * ftoh()/htof() flush denormals and round halfway cases up.
+ */
+inline void halfToFloat(float* out, const half* in, size_t count) noexcept {
+    static_assert(sizeof(half) == sizeof(uint16_t), "half must be its bit pattern");
+#if defined(__ARM_FP16_FORMAT_IEEE)
+    const __fp16* src = reinterpret_cast<const __fp16*>(in);
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(src[i]);
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]);
+    }
+#endif
+}
+
+inline void floatToHalf(half* out, const float* in, size_t count) noexcept {
+    static_assert(sizeof(half) == sizeof(uint16_t), "half must be its bit pattern");
+#if defined(__ARM_FP16_FORMAT_IEEE)
+    __fp16* dst = reinterpret_cast<__fp16*>(out);
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<__fp16>(in[i]);
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = half(in[i]);
+    }
+#endif
+}
+
 } // namespace android
 
 namespace std {
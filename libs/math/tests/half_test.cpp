@@ -19,6 +19,8 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include <vector>
+
 #include <math/half.h>
 #include <math/vec4.h>
 
@@ -82,6 +84,27 @@ TEST_F(HalfTest, Literals) {
 }
 
 
+TEST_F(HalfTest, SpanConversions) {
+    // Round-trip a span of representable values through the bulk API and
+    // check against the scalar conversions.
+    float values[64];
+    for (int i = 0; i < 64; ++i) {
+        values[i] = (i - 32) * 0.25f;
+    }
+
+    std::vector<half> halves(64, half(0.0f));
+    floatToHalf(halves.data(), values, 64);
+    for (int i = 0; i < 64; ++i) {
+        EXPECT_EQ(half(values[i]).getBits(), halves[i].getBits()) << "at " << i;
+    }
+
+    float floats[64];
+    halfToFloat(floats, halves.data(), 64);
+    for (int i = 0; i < 64; ++i) {
+        EXPECT_EQ(values[i], floats[i]) << "at " << i;
+    }
+}
+
 TEST_F(HalfTest, Vec) {
     float4 f4(1,2,3,4);
     half4 h4(f4);
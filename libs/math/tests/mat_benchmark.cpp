@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <math/mat4.h>
+#include <math/vec4.h>
+
+#include <vector>
+
+using namespace android;
+
+// The compositor's hot pattern: one color/projection matrix combined per
+// layer per frame.  Guards against the template expansion in TMatHelpers
+// regressing below what the compiler can auto-vectorize.
+static void BM_mat4_multiply(benchmark::State& state) {
+    mat4 a = mat4::translate(vec4(1.f, 2.f, 3.f, 1.f));
+    mat4 b = mat4::rotate(0.5f, vec3(0.f, 0.f, 1.f));
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(a * b);
+    }
+}
+BENCHMARK(BM_mat4_multiply);
+
+static void BM_mat4_inverse(benchmark::State& state) {
+    mat4 m = mat4::translate(vec4(1.f, 2.f, 3.f, 1.f)) *
+            mat4::rotate(0.5f, vec3(0.f, 1.f, 0.f));
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(inverse(m));
+    }
+}
+BENCHMARK(BM_mat4_inverse);
+
+// A span of vertices through one matrix, the Mesh-style batch case.
+static void BM_mat4_vec4_batch(benchmark::State& state) {
+    mat4 m = mat4::rotate(0.25f, vec3(0.f, 0.f, 1.f));
+    std::vector<vec4> vertices(1024);
+    for (size_t i = 0; i < vertices.size(); i++) {
+        vertices[i] = vec4(float(i), float(i) * 0.5f, 0.f, 1.f);
+    }
+    while (state.KeepRunning()) {
+        for (auto& v : vertices) {
+            v = m * v;
+        }
+        benchmark::DoNotOptimize(vertices.data());
+    }
+}
+BENCHMARK(BM_mat4_vec4_batch);
+
+BENCHMARK_MAIN();
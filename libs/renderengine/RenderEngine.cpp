@@ -32,6 +32,13 @@ std::unique_ptr<impl::RenderEngine> RenderEngine::create(int hwcFormat, uint32_t
         ALOGD("RenderEngine GLES Backend");
         return renderengine::gl::GLESRenderEngine::create(hwcFormat, featureFlags, imageCacheSize);
     }
+    if (strcmp(prop, "vk") == 0 || strcmp(prop, "vulkan") == 0) {
+        // Reserved for a vulkan::VkRenderEngine behind this same interface.
+        // No such backend is built in this tree yet; make the selection loud
+        // instead of indistinguishable from a typo, and run on GLES.
+        ALOGE("RenderEngine Vulkan backend requested but not implemented; using GLES.");
+        return renderengine::gl::GLESRenderEngine::create(hwcFormat, featureFlags, imageCacheSize);
+    }
     ALOGE("UNKNOWN BackendType: %s, create GLES RenderEngine.", prop);
     return renderengine::gl::GLESRenderEngine::create(hwcFormat, featureFlags, imageCacheSize);
 }
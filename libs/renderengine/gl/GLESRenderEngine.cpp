@@ -360,7 +360,8 @@ GLESRenderEngine::GLESRenderEngine(uint32_t featureFlags, EGLDisplay display, EG
         mVpWidth(0),
         mVpHeight(0),
         mFramebufferImageCacheSize(imageCacheSize),
-        mUseColorManagement(featureFlags & USE_COLOR_MANAGEMENT) {
+        mUseColorManagement(featureFlags & USE_COLOR_MANAGEMENT),
+        mUseMeshVbo(property_get_bool("debug.renderengine.use_vbo", false)) {
     glGetIntegerv(GL_MAX_TEXTURE_SIZE, &mMaxTextureSize);
     glGetIntegerv(GL_MAX_VIEWPORT_DIMS, mMaxViewportDims);
 
@@ -428,6 +429,10 @@ GLESRenderEngine::GLESRenderEngine(uint32_t featureFlags, EGLDisplay display, EG
 }
 
 GLESRenderEngine::~GLESRenderEngine() {
+    // Wait for the cache priming worker before tearing down EGL.
+    if (mPrimeCacheThread.joinable()) {
+        mPrimeCacheThread.join();
+    }
     // Destroy the image manager first.
     mImageManager = nullptr;
     std::lock_guard<std::mutex> lock(mRenderingMutex);
@@ -440,6 +445,9 @@ GLESRenderEngine::~GLESRenderEngine() {
         DEBUG_EGL_IMAGE_TRACKER_DESTROY();
     }
     mImageCache.clear();
+    if (mMeshVbo != 0) {
+        glDeleteBuffers(1, &mMeshVbo);
+    }
     eglMakeCurrent(mEGLDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
     eglTerminate(mEGLDisplay);
 }
@@ -457,8 +465,55 @@ Framebuffer* GLESRenderEngine::getFramebufferForDrawing() {
 }
 
 void GLESRenderEngine::primeCache() const {
-    ProgramCache::getInstance().primeCache(mInProtectedContext ? mProtectedEGLContext : mEGLContext,
-                                           mFeatureFlags & USE_COLOR_MANAGEMENT);
+    if (mPrimeCacheThread.joinable()) {
+        mPrimeCacheThread.join();
+    }
+
+    // Compile the priming set on a worker thread with a context in the
+    // same share group as the main one: program objects are shared across
+    // shared contexts, so the programs land in the main context's cache
+    // while the first frame no longer waits for the full shader set.  A
+    // key that is needed before its background compile finishes is simply
+    // compiled inline by useProgram(), as before.
+    mPrimeCacheThread = std::thread([this] {
+        EGLContext context = createEglContext(mEGLDisplay, mEGLConfig, mEGLContext,
+                                              false /* useContextPriority */,
+                                              Protection::UNPROTECTED);
+        if (context == EGL_NO_CONTEXT) {
+            ALOGE("Can't create shader priming context; programs will compile on first use");
+            return;
+        }
+
+        EGLSurface surface = EGL_NO_SURFACE;
+        if (!GLExtensions::getInstance().hasSurfacelessContext()) {
+            surface = createDummyEglPbufferSurface(mEGLDisplay, mEGLConfig,
+                                                   HAL_PIXEL_FORMAT_RGBA_8888,
+                                                   Protection::UNPROTECTED);
+            if (surface == EGL_NO_SURFACE) {
+                ALOGE("Can't create shader priming pbuffer");
+                eglDestroyContext(mEGLDisplay, context);
+                return;
+            }
+        }
+
+        if (eglMakeCurrent(mEGLDisplay, surface, surface, context)) {
+            // Saved driver binaries let priming (and later first use)
+            // skip GLSL compilation entirely; any program that still had
+            // to compile from source is persisted for the next boot.
+            ProgramCache::getInstance().loadBinaryCache();
+            ProgramCache::getInstance().primeCache(mEGLContext,
+                                                   mFeatureFlags & USE_COLOR_MANAGEMENT);
+            ProgramCache::getInstance().saveBinaryCache(mEGLContext);
+            eglMakeCurrent(mEGLDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        } else {
+            ALOGE("Can't make shader priming context current");
+        }
+
+        if (surface != EGL_NO_SURFACE) {
+            eglDestroySurface(mEGLDisplay, surface);
+        }
+        eglDestroyContext(mEGLDisplay, context);
+    });
 }
 
 bool GLESRenderEngine::isCurrent() const {
@@ -823,19 +878,33 @@ void GLESRenderEngine::handleRoundedCorners(const DisplaySettings& display,
     // Finally, we cut the layer into 3 parts, with top and bottom parts having rounded corners
     // and the middle part without rounded corners.
     const int32_t radius = ceil(layer.geometry.roundedCornersRadius);
+    // With a partial update active, anything drawn outside the damage
+    // would blend over already-composed pixels; clip each part to it.
+    const auto scissorClipped = [this](const Rect& rect) {
+        Rect clipped(rect);
+        if (mPartialUpdateBounds.isValid() && !rect.intersect(mPartialUpdateBounds, &clipped)) {
+            return false;
+        }
+        setScissor(clipped);
+        return true;
+    };
+
     const Rect topRect(bounds.left, bounds.top, bounds.right, bounds.top + radius);
-    setScissor(topRect);
-    drawMesh(mesh);
+    if (scissorClipped(topRect)) {
+        drawMesh(mesh);
+    }
     const Rect bottomRect(bounds.left, bounds.bottom - radius, bounds.right, bounds.bottom);
-    setScissor(bottomRect);
-    drawMesh(mesh);
+    if (scissorClipped(bottomRect)) {
+        drawMesh(mesh);
+    }
 
     // The middle part of the layer can turn off blending.
     const Rect middleRect(bounds.left, bounds.top + radius, bounds.right, bounds.bottom - radius);
-    setScissor(middleRect);
     mState.cornerRadius = 0.0;
     disableBlending();
-    drawMesh(mesh);
+    if (scissorClipped(middleRect)) {
+        drawMesh(mesh);
+    }
     disableScissor();
 }
 
@@ -965,6 +1034,17 @@ status_t GLESRenderEngine::drawLayers(const DisplaySettings& display,
         return fbo.getStatus();
     }
 
+    // If the caller supplied the accumulated damage for this buffer,
+    // restrict clearing and drawing to it so the undamaged contents are
+    // preserved; rendering the full frame for a one-digit clock update
+    // wastes GPU and power on always-on displays.
+    mPartialUpdateBounds = Rect::INVALID_RECT;
+    if (!display.damageRegion.isEmpty() && display.damageRegion.getBounds().isValid() &&
+        !Region(display.physicalDisplay).subtract(display.damageRegion).isEmpty()) {
+        mPartialUpdateBounds = display.damageRegion.getBounds();
+        setScissor(mPartialUpdateBounds);
+    }
+
     // clear the entire buffer, sometimes when we reuse buffers we'd persist
     // ghost images otherwise.
     // we also require a full transparent framebuffer for overlays. This is
@@ -1044,6 +1124,11 @@ status_t GLESRenderEngine::drawLayers(const DisplaySettings& display,
         // usual way since it needs to turn on blending anyway.
         if (layer.geometry.roundedCornersRadius > 0.0 && color.a >= 1.0f && isOpaque) {
             handleRoundedCorners(display, layer, mesh);
+            // handleRoundedCorners() managed the scissor itself;
+            // re-establish the damage scissor for the remaining layers.
+            if (mPartialUpdateBounds.isValid()) {
+                setScissor(mPartialUpdateBounds);
+            }
         } else {
             drawMesh(mesh);
         }
@@ -1056,6 +1141,11 @@ status_t GLESRenderEngine::drawLayers(const DisplaySettings& display,
         }
     }
 
+    if (mPartialUpdateBounds.isValid()) {
+        mPartialUpdateBounds = Rect::INVALID_RECT;
+        disableScissor();
+    }
+
     if (drawFence != nullptr) {
         *drawFence = flush();
     }
@@ -1200,19 +1290,42 @@ void GLESRenderEngine::setupCornerRadiusCropSize(float width, float height) {
 
 void GLESRenderEngine::drawMesh(const Mesh& mesh) {
     ATRACE_CALL();
+
+    // With debug.renderengine.use_vbo, vertex data goes through a streaming
+    // buffer object (orphaned per draw so reuse never stalls on the GPU)
+    // instead of client-side arrays, which drivers must validate and copy at
+    // every draw call.
+    const GLvoid* positions = mesh.getPositions();
+    const GLvoid* texCoords = mesh.getTexCoords();
+    const GLvoid* cropCoords = mesh.getCropCoords();
+    const bool useVbo = mUseMeshVbo && mesh.getVertexCount() > 0;
+    if (useVbo) {
+        if (mMeshVbo == 0) {
+            glGenBuffers(1, &mMeshVbo);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, mMeshVbo);
+        const GLsizeiptr size = mesh.getByteStride() * mesh.getVertexCount();
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW); // orphan
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, mesh.getPositions());
+        positions = nullptr;
+        texCoords = reinterpret_cast<const GLvoid*>(mesh.getVertexSize() * sizeof(float));
+        cropCoords = reinterpret_cast<const GLvoid*>(
+                (mesh.getVertexSize() + mesh.getTexCoordsSize()) * sizeof(float));
+    }
+
     if (mesh.getTexCoordsSize()) {
         glEnableVertexAttribArray(Program::texCoords);
         glVertexAttribPointer(Program::texCoords, mesh.getTexCoordsSize(), GL_FLOAT, GL_FALSE,
-                              mesh.getByteStride(), mesh.getTexCoords());
+                              mesh.getByteStride(), texCoords);
     }
 
     glVertexAttribPointer(Program::position, mesh.getVertexSize(), GL_FLOAT, GL_FALSE,
-                          mesh.getByteStride(), mesh.getPositions());
+                          mesh.getByteStride(), positions);
 
     if (mState.cornerRadius > 0.0f) {
         glEnableVertexAttribArray(Program::cropCoords);
         glVertexAttribPointer(Program::cropCoords, mesh.getVertexSize(), GL_FLOAT, GL_FALSE,
-                              mesh.getByteStride(), mesh.getCropCoords());
+                              mesh.getByteStride(), cropCoords);
     }
 
     // By default, DISPLAY_P3 is the only supported wide color output. However,
@@ -1333,6 +1446,12 @@ void GLESRenderEngine::drawMesh(const Mesh& mesh) {
         glDrawArrays(mesh.getPrimitive(), 0, mesh.getVertexCount());
     }
 
+    if (useVbo) {
+        // leave no buffer bound: every other attribute setup in this file
+        // assumes client-side arrays
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
     if (mesh.getTexCoordsSize()) {
         glDisableVertexAttribArray(Program::texCoords);
     }
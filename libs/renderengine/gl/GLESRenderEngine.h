@@ -183,12 +183,18 @@ private:
     EGLSurface mDummySurface;
     EGLContext mProtectedEGLContext;
     EGLSurface mProtectedDummySurface;
+    // Worker compiling the shader priming set on a shared context; see
+    // primeCache().  mutable because priming is logically const.
+    mutable std::thread mPrimeCacheThread;
     GLuint mProtectedTexName;
     GLint mMaxViewportDims[2];
     GLint mMaxTextureSize;
     GLuint mVpWidth;
     GLuint mVpHeight;
     Description mState;
+    // Bounds of the damage scissor while a partial-update drawLayers()
+    // call is in flight; INVALID_RECT when rendering full frames.
+    Rect mPartialUpdateBounds = Rect::INVALID_RECT;
 
     mat4 mSrgbToXyz;
     mat4 mDisplayP3ToXyz;
@@ -227,6 +233,11 @@ private:
     // supports sRGB, DisplayP3 color spaces.
     const bool mUseColorManagement = false;
 
+    // Streaming VBO for drawMesh (debug.renderengine.use_vbo); orphaned per
+    // draw so reuse never waits on the previous draw's consumption.
+    const bool mUseMeshVbo;
+    uint32_t mMeshVbo = 0;
+
     // Cache of GL images that we'll store per GraphicBuffer ID
     std::unordered_map<uint64_t, std::unique_ptr<Image>> mImageCache GUARDED_BY(mRenderingMutex);
     // Mutex guarding rendering operations, so that:
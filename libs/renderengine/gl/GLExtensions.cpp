@@ -65,6 +65,9 @@ void GLExtensions::initWithGLStrings(GLubyte const* vendor, GLubyte const* rende
     if (extensionSet.hasExtension("GL_EXT_protected_textures")) {
         mHasProtectedTexture = true;
     }
+    if (extensionSet.hasExtension("GL_OES_get_program_binary")) {
+        mHasGetProgramBinary = true;
+    }
 }
 
 char const* GLExtensions::getVendor() const {
@@ -18,9 +18,11 @@
 
 #include <stdint.h>
 
+#include <GLES2/gl2ext.h>
 #include <log/log.h>
 #include <math/mat4.h>
 #include <utils/String8.h>
+#include "GLExtensions.h"
 #include "ProgramCache.h"
 
 namespace android {
@@ -56,27 +58,77 @@ Program::Program(const ProgramCache::Key& /*needs*/, const char* vertex, const c
         glDeleteShader(fragmentId);
         glDeleteProgram(programId);
     } else {
-        mProgram = programId;
-        mVertexShader = vertexId;
-        mFragmentShader = fragmentId;
-        mInitialized = true;
-        mProjectionMatrixLoc = glGetUniformLocation(programId, "projection");
-        mTextureMatrixLoc = glGetUniformLocation(programId, "texture");
-        mSamplerLoc = glGetUniformLocation(programId, "sampler");
-        mColorLoc = glGetUniformLocation(programId, "color");
-        mDisplayMaxLuminanceLoc = glGetUniformLocation(programId, "displayMaxLuminance");
-        mInputTransformMatrixLoc = glGetUniformLocation(programId, "inputTransformMatrix");
-        mOutputTransformMatrixLoc = glGetUniformLocation(programId, "outputTransformMatrix");
-        mCornerRadiusLoc = glGetUniformLocation(programId, "cornerRadius");
-        mCropCenterLoc = glGetUniformLocation(programId, "cropCenter");
-
-        // set-up the default values for our uniforms
-        glUseProgram(programId);
-        glUniformMatrix4fv(mProjectionMatrixLoc, 1, GL_FALSE, mat4().asArray());
-        glEnableVertexAttribArray(0);
+        initialize(programId, vertexId, fragmentId);
     }
 }
 
+Program::Program(const ProgramCache::Key& /*needs*/, const void* binary, GLsizei length,
+                 GLenum binaryFormat)
+      : mInitialized(false) {
+    if (!GLExtensions::getInstance().hasGetProgramBinary()) {
+        return;
+    }
+
+    GLuint programId = glCreateProgram();
+    glProgramBinaryOES(programId, binaryFormat, binary, length);
+
+    GLint status;
+    glGetProgramiv(programId, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        // Stale or foreign binary (driver update, different device);
+        // the caller falls back to compiling from source.
+        glDeleteProgram(programId);
+        return;
+    }
+
+    // Attribute bindings are baked into the binary, so only the uniform
+    // state needs to be rebuilt.
+    initialize(programId, 0, 0);
+}
+
+bool Program::getBinary(std::vector<uint8_t>* outBinary, GLenum* outFormat) const {
+    if (!mInitialized || !GLExtensions::getInstance().hasGetProgramBinary()) {
+        return false;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(mProgram, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+    if (length <= 0) {
+        return false;
+    }
+
+    outBinary->resize(length);
+    GLsizei written = 0;
+    glGetProgramBinaryOES(mProgram, length, &written, outFormat, outBinary->data());
+    if (written <= 0 || written > length) {
+        outBinary->clear();
+        return false;
+    }
+    outBinary->resize(written);
+    return true;
+}
+
+void Program::initialize(GLuint programId, GLuint vertexId, GLuint fragmentId) {
+    mProgram = programId;
+    mVertexShader = vertexId;
+    mFragmentShader = fragmentId;
+    mInitialized = true;
+    mProjectionMatrixLoc = glGetUniformLocation(programId, "projection");
+    mTextureMatrixLoc = glGetUniformLocation(programId, "texture");
+    mSamplerLoc = glGetUniformLocation(programId, "sampler");
+    mColorLoc = glGetUniformLocation(programId, "color");
+    mDisplayMaxLuminanceLoc = glGetUniformLocation(programId, "displayMaxLuminance");
+    mInputTransformMatrixLoc = glGetUniformLocation(programId, "inputTransformMatrix");
+    mOutputTransformMatrixLoc = glGetUniformLocation(programId, "outputTransformMatrix");
+    mCornerRadiusLoc = glGetUniformLocation(programId, "cornerRadius");
+    mCropCenterLoc = glGetUniformLocation(programId, "cropCenter");
+
+    // set-up the default values for our uniforms
+    glUseProgram(programId);
+    glUniformMatrix4fv(mProjectionMatrixLoc, 1, GL_FALSE, mat4().asArray());
+    glEnableVertexAttribArray(0);
+}
+
 bool Program::isValid() const {
     return mInitialized;
 }
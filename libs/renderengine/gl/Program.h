@@ -18,6 +18,7 @@
 #define SF_RENDER_ENGINE_PROGRAM_H
 
 #include <stdint.h>
+#include <vector>
 
 #include <GLES2/gl2.h>
 #include <renderengine/private/Description.h>
@@ -48,8 +49,17 @@ public:
     };
 
     Program(const ProgramCache::Key& needs, const char* vertex, const char* fragment);
+    // Builds the program from a driver binary previously retrieved with
+    // getBinary(); isValid() is false if the driver rejected the binary
+    // and the caller should fall back to compiling from source.
+    Program(const ProgramCache::Key& needs, const void* binary, GLsizei length,
+            GLenum binaryFormat);
     ~Program() = default;
 
+    // Retrieves the driver binary of a successfully linked program
+    // (requires GL_OES_get_program_binary); returns false otherwise.
+    bool getBinary(std::vector<uint8_t>* outBinary, GLenum* outFormat) const;
+
     /* whether this object is usable */
     bool isValid() const;
 
@@ -68,6 +78,10 @@ public:
 private:
     GLuint buildShader(const char* source, GLenum type);
 
+    // Queries uniform locations and sets up defaults once a program
+    // object has linked, from either source or a binary.
+    void initialize(GLuint programId, GLuint vertexId, GLuint fragmentId);
+
     // whether the initialization succeeded
     bool mInitialized;
 
@@ -18,12 +18,17 @@
 
 #include "ProgramCache.h"
 
+#include <cstdio>
+#include <functional>
+#include <string>
+
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
 #include <log/log.h>
 #include <renderengine/private/Description.h>
 #include <utils/String8.h>
 #include <utils/Trace.h>
+#include "GLExtensions.h"
 #include "Program.h"
 
 ANDROID_SINGLETON_STATIC_INSTANCE(android::renderengine::gl::ProgramCache)
@@ -77,8 +82,195 @@ Formatter& dedent(Formatter& f) {
     return f;
 }
 
+bool ProgramCache::primeUncachedProgram(ProgramMap& cache, const Key& key) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (cache.count(key) != 0) return false;
+    }
+    auto program = getProgramForKey(key);
+    std::lock_guard<std::mutex> lock(mMutex);
+    return cache.emplace(key, std::move(program)).second;
+}
+
+/*
+ * Persistent program-binary cache.  The file carries a hash of the GL
+ * driver identity so a driver or device change invalidates it wholesale;
+ * writes go through a temp file and rename so readers never see a torn
+ * file.
+ */
+static const char* const kBinaryCachePath = "/data/system/renderengine_program_cache";
+static const uint32_t kBinaryCacheMagic = 0x53467063;  // 'SFpc'
+static const uint32_t kBinaryCacheVersion = 1;
+// A full priming set is well under this; anything bigger is corrupt.
+static const long kBinaryCacheMaxSize = 8 * 1024 * 1024;
+
+struct BinaryCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t driverHash;
+    uint32_t count;
+};
+
+static uint32_t driverIdentityHash() {
+    auto& extensions = GLExtensions::getInstance();
+    std::string identity;
+    identity += extensions.getVendor();
+    identity += extensions.getRenderer();
+    identity += extensions.getVersion();
+    return static_cast<uint32_t>(std::hash<std::string>()(identity));
+}
+
+void ProgramCache::loadBinaryCache() {
+    if (!GLExtensions::getInstance().hasGetProgramBinary()) {
+        return;
+    }
+
+    std::FILE* file = std::fopen(kBinaryCachePath, "rb");
+    if (file == nullptr) {
+        return;
+    }
+    std::fseek(file, 0, SEEK_END);
+    const long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    if (size < static_cast<long>(sizeof(BinaryCacheHeader)) || size > kBinaryCacheMaxSize) {
+        std::fclose(file);
+        return;
+    }
+    std::vector<uint8_t> buffer(size);
+    const bool read = std::fread(buffer.data(), size, 1, file) == 1;
+    std::fclose(file);
+    if (!read) {
+        return;
+    }
+
+    BinaryCacheHeader header;
+    memcpy(&header, buffer.data(), sizeof(header));
+    if (header.magic != kBinaryCacheMagic || header.version != kBinaryCacheVersion ||
+        header.driverHash != driverIdentityHash()) {
+        return;
+    }
+
+    size_t offset = sizeof(header);
+    uint32_t loaded = 0;
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (uint32_t i = 0; i < header.count; i++) {
+        uint32_t entry[3];  // key, format, length
+        if (offset + sizeof(entry) > buffer.size()) break;
+        memcpy(entry, buffer.data() + offset, sizeof(entry));
+        offset += sizeof(entry);
+        const size_t length = entry[2];
+        if (length == 0 || offset + length > buffer.size()) break;
+
+        Key key;
+        key.mKey = entry[0];
+        SavedBinary& binary = mSavedBinaries[key];
+        binary.format = entry[1];
+        binary.data.assign(buffer.data() + offset, buffer.data() + offset + length);
+        offset += (length + 3) & ~static_cast<size_t>(3);
+        loaded++;
+    }
+    ALOGD("program binary cache loaded - %u binaries", loaded);
+}
+
+void ProgramCache::saveBinaryCache(EGLContext context) {
+    if (!GLExtensions::getInstance().hasGetProgramBinary()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mBinaryCacheDirty) {
+            return;
+        }
+        mBinaryCacheDirty = false;
+    }
+
+    // Snapshot the programs; entries are never erased so the pointers
+    // stay valid outside the lock.
+    std::vector<std::pair<uint32_t, Program*>> programs;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (const auto& entry : mCaches[context]) {
+            if (entry.second != nullptr && entry.second->isValid()) {
+                programs.emplace_back(entry.first.mKey, entry.second.get());
+            }
+        }
+    }
+
+    std::vector<uint8_t> buffer(sizeof(BinaryCacheHeader));
+    uint32_t count = 0;
+    for (const auto& [key, program] : programs) {
+        std::vector<uint8_t> binary;
+        GLenum format = 0;
+        if (!program->getBinary(&binary, &format)) {
+            continue;
+        }
+        const uint32_t entry[3] = {key, format, static_cast<uint32_t>(binary.size())};
+        const uint8_t* entryBytes = reinterpret_cast<const uint8_t*>(entry);
+        buffer.insert(buffer.end(), entryBytes, entryBytes + sizeof(entry));
+        buffer.insert(buffer.end(), binary.begin(), binary.end());
+        buffer.resize((buffer.size() + 3) & ~static_cast<size_t>(3), 0);
+        count++;
+    }
+
+    BinaryCacheHeader header;
+    header.magic = kBinaryCacheMagic;
+    header.version = kBinaryCacheVersion;
+    header.driverHash = driverIdentityHash();
+    header.count = count;
+    memcpy(buffer.data(), &header, sizeof(header));
+
+    const std::string tempPath = std::string(kBinaryCachePath) + ".tmp";
+    std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) {
+        ALOGV("can't write program binary cache to %s", tempPath.c_str());
+        return;
+    }
+    const bool written = std::fwrite(buffer.data(), buffer.size(), 1, file) == 1;
+    std::fclose(file);
+    if (!written || std::rename(tempPath.c_str(), kBinaryCachePath) != 0) {
+        ALOGW("failed to persist program binary cache");
+        std::remove(tempPath.c_str());
+        return;
+    }
+    ALOGD("program binary cache saved - %u binaries, %zu bytes", count, buffer.size());
+}
+
+std::unique_ptr<Program> ProgramCache::getProgramForKey(const Key& key) {
+    SavedBinary binary;
+    bool haveBinary = false;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mSavedBinaries.find(key);
+        if (it != mSavedBinaries.end()) {
+            binary = it->second;
+            haveBinary = true;
+        }
+    }
+
+    if (haveBinary) {
+        auto program = std::make_unique<Program>(key, binary.data.data(),
+                                                 static_cast<GLsizei>(binary.data.size()),
+                                                 binary.format);
+        if (program->isValid()) {
+            return program;
+        }
+        ALOGV("saved binary for key %08X rejected; recompiling", key.mKey);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mBinaryCacheDirty = true;
+    }
+    return generateProgram(key);
+}
+
 void ProgramCache::primeCache(EGLContext context, bool useColorManagement) {
-    auto& cache = mCaches[context];
+    ProgramMap* cachePtr;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        cachePtr = &mCaches[context];
+    }
+    ProgramMap& cache = *cachePtr;
     uint32_t shaderCount = 0;
     uint32_t keyMask = Key::BLEND_MASK | Key::OPACITY_MASK | Key::ALPHA_MASK | Key::TEXTURE_MASK
         | Key::ROUNDED_CORNERS_MASK;
@@ -93,8 +285,7 @@ void ProgramCache::primeCache(EGLContext context, bool useColorManagement) {
         if (tex != Key::TEXTURE_OFF && tex != Key::TEXTURE_EXT && tex != Key::TEXTURE_2D) {
             continue;
         }
-        if (cache.count(shaderKey) == 0) {
-            cache.emplace(shaderKey, generateProgram(shaderKey));
+        if (primeUncachedProgram(cache, shaderKey)) {
             shaderCount++;
         }
     }
@@ -117,8 +308,7 @@ void ProgramCache::primeCache(EGLContext context, bool useColorManagement) {
 
             // Cache texture off option for window transition
             shaderKey.set(Key::TEXTURE_MASK, (i & 8) ? Key::TEXTURE_EXT : Key::TEXTURE_OFF);
-            if (cache.count(shaderKey) == 0) {
-                cache.emplace(shaderKey, generateProgram(shaderKey));
+            if (primeUncachedProgram(cache, shaderKey)) {
                 shaderCount++;
             }
         }
@@ -712,20 +902,33 @@ void ProgramCache::useProgram(EGLContext context, const Description& description
     Key needs(computeKey(description));
 
     // look-up the program in the cache
-    auto& cache = mCaches[context];
-    auto it = cache.find(needs);
-    if (it == cache.end()) {
+    Program* program = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto& cache = mCaches[context];
+        auto it = cache.find(needs);
+        if (it != cache.end()) {
+            program = it->second.get();
+        }
+    }
+    if (program == nullptr) {
         // we didn't find our program, so generate one...
         nsecs_t time = systemTime();
-        it = cache.emplace(needs, generateProgram(needs)).first;
+        auto generated = getProgramForKey(needs);
         time = systemTime() - time;
 
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto& cache = mCaches[context];
+        // The priming thread may have raced us here; emplace keeps the
+        // first program and drops ours.
+        auto result = cache.emplace(needs, std::move(generated));
+        program = result.first->second.get();
+
         ALOGV(">>> generated new program for context %p: needs=%08X, time=%u ms (%zu programs)",
               context, needs.mKey, uint32_t(ns2ms(time)), cache.size());
     }
 
     // here we have a suitable program for this description
-    std::unique_ptr<Program>& program = it->second;
     if (program->isValid()) {
         program->use();
         program->setUniforms(description);
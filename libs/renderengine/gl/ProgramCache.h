@@ -18,7 +18,9 @@
 #define SF_RENDER_ENGINE_PROGRAMCACHE_H
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include <EGL/egl.h>
 #include <GLES2/gl2.h>
@@ -178,15 +180,29 @@ public:
     ProgramCache() = default;
     ~ProgramCache() = default;
 
-    // Generate shaders to populate the cache
+    // Generate shaders to populate the cache.  May be called from a worker
+    // thread whose EGL context is in the same share group as |context|;
+    // program objects are shared, so the programs are registered against
+    // |context| while compilation happens on the current one.
     void primeCache(const EGLContext context, bool useColorManagement);
 
-    size_t getSize(const EGLContext context) { return mCaches[context].size(); }
+    size_t getSize(const EGLContext context) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mCaches[context].size();
+    }
 
     // useProgram lookup a suitable program in the cache or generates one
     // if none can be found.
     void useProgram(const EGLContext context, const Description& description);
 
+    // Persistent program-binary cache (requires GL_OES_get_program_binary).
+    // loadBinaryCache() reads previously saved driver binaries so priming
+    // and first use skip GLSL compilation; saveBinaryCache() persists the
+    // binaries of any programs that had to be compiled from source.  Both
+    // are called on the priming thread with its shared context current.
+    void loadBinaryCache();
+    void saveBinaryCache(const EGLContext context);
+
 private:
     // compute a cache Key from a Description
     static Key computeKey(const Description& description);
@@ -205,10 +221,36 @@ private:
     // generates the fragment shader from the Key
     static String8 generateFragmentShader(const Key& needs);
 
+    using ProgramMap = std::unordered_map<Key, std::unique_ptr<Program>, Key::Hash>;
+
+    struct SavedBinary {
+        GLenum format;
+        std::vector<uint8_t> data;
+    };
+
+    // Returns a program for |key|, built from a saved driver binary when
+    // one is available and accepted, compiled from source otherwise.
+    std::unique_ptr<Program> getProgramForKey(const Key& key);
+
+    // Compiles |key| if it is not cached yet; returns true if a program
+    // was generated.  Compilation happens outside the lock so a priming
+    // thread never stalls rendering for more than a map lookup.
+    bool primeUncachedProgram(ProgramMap& cache, const Key& key);
+
+    // Protects mCaches, mSavedBinaries and mBinaryCacheDirty.  Entries are
+    // never erased, so Program pointers handed out under the lock stay
+    // valid after it is dropped.
+    std::mutex mMutex;
+
+    // Driver binaries loaded from disk, consumed by getProgramForKey().
+    std::unordered_map<Key, SavedBinary, Key::Hash> mSavedBinaries;
+    // Set when a program had to be compiled from source, meaning the
+    // on-disk cache is missing entries.
+    bool mBinaryCacheDirty = false;
+
     // Key/Value map used for caching Programs. Currently the cache
     // is never shrunk (and the GL program objects are never deleted).
-    std::unordered_map<EGLContext, std::unordered_map<Key, std::unique_ptr<Program>, Key::Hash>>
-            mCaches;
+    std::unordered_map<EGLContext, ProgramMap> mCaches;
 };
 
 } // namespace gl
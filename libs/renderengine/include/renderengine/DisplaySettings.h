@@ -58,6 +58,14 @@ struct DisplaySettings {
     // rendered layers.
     Region clearRegion = Region::INVALID_REGION;
 
+    // Accumulated damage of the output buffer being rendered to, in the
+    // same space as physicalDisplay: everything outside it is preserved
+    // from the buffer's previous contents, and clearing/drawing is
+    // restricted to it.  The caller is responsible for accumulating
+    // damage across however many frames old the buffer is.  An invalid
+    // (default) or empty region means the full frame is rendered.
+    Region damageRegion = Region::INVALID_REGION;
+
     // The orientation of the physical display.
     uint32_t orientation = ui::Transform::ROT_0;
 };
@@ -16,6 +16,8 @@
 
 #include <ui/ColorSpace.h>
 
+#include <algorithm>
+
 using namespace std::placeholders;
 
 namespace android {
@@ -386,6 +388,49 @@ static mat3 adaptation(const mat3& matrix, const float3& srcWhitePoint, const fl
     return inverse(matrix) * mat3{dstLMS / srcLMS} * matrix;
 }
 
+// Linearly-interpolated lookup over a [0..1]-domain table.
+static float sampleLUT(const std::vector<float>& lut, float v) noexcept {
+    const float x = clamp(v, 0.0f, 1.0f) * float(lut.size() - 1);
+    const size_t i = size_t(x);
+    const size_t j = std::min(i + 1, lut.size() - 1);
+    const float f = x - float(i);
+    return lut[i] + (lut[j] - lut[i]) * f;
+}
+
+void ColorSpaceConnector::bakeTransferFunctions(uint32_t size) {
+    size = clamp(size, 64u, 4096u);
+    mToLinearLUT.resize(size);
+    mFromLinearLUT.resize(size);
+    const float m = 1.0f / float(size - 1);
+    const ColorSpace::transfer_function& eotf = mSource.getEOTF();
+    const ColorSpace::transfer_function& oetf = mDestination.getOETF();
+    for (uint32_t i = 0; i < size; i++) {
+        mToLinearLUT[i] = eotf(i * m);
+        mFromLinearLUT[i] = oetf(i * m);
+    }
+}
+
+void ColorSpaceConnector::transformSpan(float3* data, size_t count) const noexcept {
+    if (mToLinearLUT.empty()) {
+        for (size_t i = 0; i < count; i++) {
+            data[i] = transform(data[i]);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const float3 v = apply(data[i], mSource.getClamper());
+        float3 linear(sampleLUT(mToLinearLUT, v.r),
+                      sampleLUT(mToLinearLUT, v.g),
+                      sampleLUT(mToLinearLUT, v.b));
+        linear = mTransform * linear;
+        data[i] = apply(float3(sampleLUT(mFromLinearLUT, linear.r),
+                               sampleLUT(mFromLinearLUT, linear.g),
+                               sampleLUT(mFromLinearLUT, linear.b)),
+                        mDestination.getClamper());
+    }
+}
+
 ColorSpaceConnector::ColorSpaceConnector(
         const ColorSpace& src,
         const ColorSpace& dst) noexcept
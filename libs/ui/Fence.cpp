@@ -24,7 +24,10 @@
 // this is effectively included from the Linux kernel
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wzero-length-array"
+#include <linux/sync_file.h>
+#include <string.h>
 #include <sync/sync.h>
+#include <sys/ioctl.h>
 #pragma clang diagnostic pop
 
 #include <sys/types.h>
@@ -109,6 +112,37 @@ nsecs_t Fence::getSignalTime() const {
         return SIGNAL_TIME_INVALID;
     }
 
+    // Fast path: a single ioctl with stack storage.  The libsync helper
+    // costs a counting ioctl, a heap allocation and a second ioctl per
+    // query, and SurfaceFlinger asks for many fence timestamps every
+    // frame (TimeStats, FrameTracker, DispSync all poll pending fences).
+    {
+        constexpr uint32_t kMaxFastPathFences = 4;
+        struct {
+            struct sync_file_info info;
+            struct sync_fence_info fences[kMaxFastPathFences];
+        } local;
+        memset(&local, 0, sizeof(local));
+        local.info.num_fences = kMaxFastPathFences;
+        local.info.sync_fence_info = static_cast<uint64_t>(
+                reinterpret_cast<uintptr_t>(local.fences));
+        if (TEMP_FAILURE_RETRY(ioctl(mFenceFd, SYNC_IOC_FILE_INFO, &local.info)) >= 0 &&
+            local.info.num_fences <= kMaxFastPathFences) {
+            if (local.info.status != 1) {
+                return SIGNAL_TIME_PENDING;
+            }
+            uint64_t timestamp = 0;
+            for (uint32_t i = 0; i < local.info.num_fences; i++) {
+                if (local.fences[i].timestamp_ns > timestamp) {
+                    timestamp = local.fences[i].timestamp_ns;
+                }
+            }
+            return nsecs_t(timestamp);
+        }
+        // More fence points than the fast path carries (or an old kernel):
+        // take the allocating helper below.
+    }
+
     struct sync_file_info* finfo = sync_file_info(mFenceFd);
     if (finfo == nullptr) {
         ALOGE("sync_file_info returned NULL for fd %d", mFenceFd.get());
@@ -14,8 +14,13 @@
 * limitations under the License.
 */
 
+#define ATRACE_TAG ATRACE_TAG_GRAPHICS
+
 #include <ui/FenceTime.h>
 
+#include <cutils/properties.h>
+#include <utils/Trace.h>
+
 #define LOG_TAG "FenceTime"
 
 #include <cutils/compiler.h>  // For CC_[UN]LIKELY
@@ -259,6 +264,34 @@ status_t FenceTime::Snapshot::unflatten(
 // ============================================================================
 // FenceTimeline
 // ============================================================================
+// Tracing is opt-in via debug.fence.trace, checked once; the per-call gate
+// after that is ATRACE_ENABLED.
+static bool fenceTraceRequested() {
+    static const bool requested = property_get_bool("debug.fence.trace", false);
+    return requested;
+}
+
+void FenceTimeline::setTraceName(std::string name) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mTraceName = std::move(name);
+}
+
+void FenceTimeline::traceFencePushedLocked(int32_t cookie) {
+    if (mTraceName.empty() || !fenceTraceRequested() || !ATRACE_ENABLED()) {
+        return;
+    }
+    ATRACE_ASYNC_BEGIN(mTraceName.c_str(), cookie);
+    ATRACE_INT(mTraceName.c_str(), static_cast<int32_t>(mQueue.size()));
+}
+
+void FenceTimeline::traceFenceSignaledLocked(int32_t cookie) {
+    if (mTraceName.empty() || !fenceTraceRequested() || !ATRACE_ENABLED()) {
+        return;
+    }
+    ATRACE_ASYNC_END(mTraceName.c_str(), cookie);
+    ATRACE_INT(mTraceName.c_str(), static_cast<int32_t>(mQueue.size()));
+}
+
 void FenceTimeline::push(const std::shared_ptr<FenceTime>& fence) {
     std::lock_guard<std::mutex> lock(mMutex);
     while (mQueue.size() >= MAX_ENTRIES) {
@@ -273,9 +306,14 @@ void FenceTimeline::push(const std::shared_ptr<FenceTime>& fence) {
             // we are removing it from the timeline.
             front->getSignalTime();
         }
+        traceFenceSignaledLocked(mTraceCookies.front());
+        mTraceCookies.pop();
         mQueue.pop();
     }
+    const int32_t cookie = static_cast<int32_t>(reinterpret_cast<uintptr_t>(fence.get()));
     mQueue.push(fence);
+    mTraceCookies.push(cookie);
+    traceFencePushedLocked(cookie);
 }
 
 void FenceTimeline::updateSignalTimes() {
@@ -285,10 +323,14 @@ void FenceTimeline::updateSignalTimes() {
         if (!fence) {
             // The shared_ptr no longer exists and no one cares about the
             // timestamp anymore.
+            traceFenceSignaledLocked(mTraceCookies.front());
+            mTraceCookies.pop();
             mQueue.pop();
             continue;
         } else if (fence->getSignalTime() != Fence::SIGNAL_TIME_PENDING) {
             // The fence has signaled and we've removed the sp<Fence> ref.
+            traceFenceSignaledLocked(mTraceCookies.front());
+            mTraceCookies.pop();
             mQueue.pop();
             continue;
         } else {
@@ -23,6 +23,8 @@
 
 #include <grallocusage/GrallocUsageConversion.h>
 
+#include <ui/Fence.h>
+
 #ifndef LIBUI_IN_VNDK
 #include <ui/BufferHubBuffer.h>
 #endif // LIBUI_IN_VNDK
@@ -131,6 +133,9 @@ GraphicBuffer::~GraphicBuffer()
 {
     ATRACE_CALL();
     if (handle) {
+        if (mPersistentlyMapped) {
+            getBufferMapper().unlock(handle);
+        }
         free_handle();
     }
     for (auto& [callback, context] : mDeathCallbacks) {
@@ -276,9 +281,27 @@ status_t GraphicBuffer::lock(uint32_t inUsage, const Rect& rect, void** vaddr,
         return BAD_VALUE;
     }
 
+    if (mPersistentMappingEnabled && mPersistentlyMapped && !mMappedYCbCrValid &&
+        inUsage == mMappedProducerUsage && inUsage == mMappedConsumerUsage &&
+        rect == mMappedRect) {
+        *vaddr = mMappedAddr;
+        if (outBytesPerPixel) *outBytesPerPixel = mMappedBytesPerPixel;
+        if (outBytesPerStride) *outBytesPerStride = mMappedBytesPerStride;
+        return NO_ERROR;
+    }
+
+    if (mPersistentMappingEnabled && mPersistentlyMapped) {
+        // Different usage or bounds than the cached mapping: release it
+        // first so the HAL never sees nested locks.
+        flushPersistentMapping();
+    }
+
     status_t res = getBufferMapper().lock(handle, inUsage, rect, vaddr, outBytesPerPixel,
                                           outBytesPerStride);
 
+    if (res == NO_ERROR && mPersistentMappingEnabled) {
+        rememberMapping(inUsage, inUsage, rect, *vaddr, outBytesPerPixel, outBytesPerStride);
+    }
     return res;
 }
 
@@ -299,12 +322,31 @@ status_t GraphicBuffer::lockYCbCr(uint32_t inUsage, const Rect& rect,
                 width, height);
         return BAD_VALUE;
     }
+    if (mPersistentMappingEnabled && mPersistentlyMapped && mMappedYCbCrValid &&
+        inUsage == mMappedProducerUsage && inUsage == mMappedConsumerUsage &&
+        rect == mMappedRect) {
+        *ycbcr = mMappedYCbCr;
+        return NO_ERROR;
+    }
+
+    if (mPersistentMappingEnabled && mPersistentlyMapped) {
+        flushPersistentMapping();
+    }
+
     status_t res = getBufferMapper().lockYCbCr(handle, inUsage, rect, ycbcr);
+    if (res == NO_ERROR && mPersistentMappingEnabled) {
+        rememberYCbCrMapping(inUsage, rect, *ycbcr);
+    }
     return res;
 }
 
 status_t GraphicBuffer::unlock()
 {
+    if (mPersistentMappingEnabled && mPersistentlyMapped) {
+        // Deferred: the HAL unlock (and its cache maintenance) happens in
+        // flushPersistentMapping() or at destruction.
+        return NO_ERROR;
+    }
     status_t res = getBufferMapper().unlock(handle);
     return res;
 }
@@ -333,9 +375,30 @@ status_t GraphicBuffer::lockAsync(uint64_t inProducerUsage, uint64_t inConsumerU
         return BAD_VALUE;
     }
 
+    if (mPersistentMappingEnabled && mPersistentlyMapped && !mMappedYCbCrValid &&
+        inProducerUsage == mMappedProducerUsage && inConsumerUsage == mMappedConsumerUsage &&
+        rect == mMappedRect) {
+        if (fenceFd >= 0) {
+            sp<Fence> fence(new Fence(fenceFd));
+            fence->waitForever("GraphicBuffer::lockAsync(persistent)");
+        }
+        *vaddr = mMappedAddr;
+        if (outBytesPerPixel) *outBytesPerPixel = mMappedBytesPerPixel;
+        if (outBytesPerStride) *outBytesPerStride = mMappedBytesPerStride;
+        return NO_ERROR;
+    }
+
+    if (mPersistentMappingEnabled && mPersistentlyMapped) {
+        flushPersistentMapping();
+    }
+
     status_t res = getBufferMapper().lockAsync(handle, inProducerUsage, inConsumerUsage, rect,
                                                vaddr, fenceFd, outBytesPerPixel, outBytesPerStride);
 
+    if (res == NO_ERROR && mPersistentMappingEnabled) {
+        rememberMapping(inProducerUsage, inConsumerUsage, rect, *vaddr, outBytesPerPixel,
+                        outBytesPerStride);
+    }
     return res;
 }
 
@@ -357,16 +420,79 @@ status_t GraphicBuffer::lockAsyncYCbCr(uint32_t inUsage, const Rect& rect,
                 width, height);
         return BAD_VALUE;
     }
+    if (mPersistentMappingEnabled && mPersistentlyMapped && mMappedYCbCrValid &&
+        inUsage == mMappedProducerUsage && inUsage == mMappedConsumerUsage &&
+        rect == mMappedRect) {
+        if (fenceFd >= 0) {
+            sp<Fence> fence(new Fence(fenceFd));
+            fence->waitForever("GraphicBuffer::lockAsyncYCbCr(persistent)");
+        }
+        *ycbcr = mMappedYCbCr;
+        return NO_ERROR;
+    }
+
+    if (mPersistentMappingEnabled && mPersistentlyMapped) {
+        flushPersistentMapping();
+    }
+
     status_t res = getBufferMapper().lockAsyncYCbCr(handle, inUsage, rect, ycbcr, fenceFd);
+    if (res == NO_ERROR && mPersistentMappingEnabled) {
+        rememberYCbCrMapping(inUsage, rect, *ycbcr);
+    }
     return res;
 }
 
 status_t GraphicBuffer::unlockAsync(int *fenceFd)
 {
+    if (mPersistentMappingEnabled && mPersistentlyMapped) {
+        // Deferred; see unlock().
+        *fenceFd = -1;
+        return NO_ERROR;
+    }
     status_t res = getBufferMapper().unlockAsync(handle, fenceFd);
     return res;
 }
 
+void GraphicBuffer::enablePersistentMapping() {
+    mPersistentMappingEnabled = true;
+}
+
+status_t GraphicBuffer::flushPersistentMapping() {
+    if (!mPersistentlyMapped) {
+        return NO_ERROR;
+    }
+    // Real HAL unlock: performs any deferred cache maintenance and drops
+    // the cached mapping, so the next lock takes the full path again.
+    mPersistentlyMapped = false;
+    mMappedAddr = nullptr;
+    mMappedYCbCrValid = false;
+    return getBufferMapper().unlock(handle);
+}
+
+void GraphicBuffer::rememberMapping(uint64_t producerUsage, uint64_t consumerUsage,
+                                    const Rect& rect, void* vaddr, int32_t* bytesPerPixel,
+                                    int32_t* bytesPerStride) {
+    mPersistentlyMapped = true;
+    mMappedProducerUsage = producerUsage;
+    mMappedConsumerUsage = consumerUsage;
+    mMappedRect = rect;
+    mMappedAddr = vaddr;
+    mMappedBytesPerPixel = bytesPerPixel ? *bytesPerPixel : -1;
+    mMappedBytesPerStride = bytesPerStride ? *bytesPerStride : -1;
+    mMappedYCbCrValid = false;
+}
+
+void GraphicBuffer::rememberYCbCrMapping(uint64_t usage, const Rect& rect,
+                                         const android_ycbcr& ycbcr) {
+    mPersistentlyMapped = true;
+    mMappedProducerUsage = usage;
+    mMappedConsumerUsage = usage;
+    mMappedRect = rect;
+    mMappedAddr = nullptr;
+    mMappedYCbCr = ycbcr;
+    mMappedYCbCrValid = true;
+}
+
 status_t GraphicBuffer::isSupported(uint32_t inWidth, uint32_t inHeight, PixelFormat inFormat,
                                     uint32_t inLayerCount, uint64_t inUsage,
                                     bool* outSupported) const {
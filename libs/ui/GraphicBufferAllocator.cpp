@@ -26,6 +26,7 @@
 #include <grallocusage/GrallocUsageConversion.h>
 
 #include <android-base/stringprintf.h>
+#include <cutils/properties.h>
 #include <log/log.h>
 #include <utils/Singleton.h>
 #include <utils/Trace.h>
@@ -45,6 +46,19 @@ ANDROID_SINGLETON_STATIC_INSTANCE( GraphicBufferAllocator )
 Mutex GraphicBufferAllocator::sLock;
 KeyedVector<buffer_handle_t,
     GraphicBufferAllocator::alloc_rec_t> GraphicBufferAllocator::sAllocList;
+std::list<GraphicBufferAllocator::pooled_buffer_t> GraphicBufferAllocator::sBufferPool;
+size_t GraphicBufferAllocator::sBufferPoolBytes = 0;
+uint64_t GraphicBufferAllocator::sAllocLatencyBuckets[kLatencyBucketCount] = {};
+uint64_t GraphicBufferAllocator::sAllocCount = 0;
+uint64_t GraphicBufferAllocator::sPoolHitCount = 0;
+nsecs_t GraphicBufferAllocator::sAllocLatencyTotal = 0;
+
+// Byte budget for the free-buffer pool; 0 (the default) disables pooling.
+static size_t bufferPoolCapacityBytes() {
+    static const size_t capacity =
+            static_cast<size_t>(property_get_int64("debug.ui.buffer_pool_kb", 0)) * 1024;
+    return capacity;
+}
 
 GraphicBufferAllocator::GraphicBufferAllocator() : mMapper(GraphicBufferMapper::getInstance()) {
     mAllocator = std::make_unique<const Gralloc3Allocator>(
@@ -93,6 +107,20 @@ void GraphicBufferAllocator::dump(std::string& result) const {
     }
     StringAppendF(&result, "Total allocated (estimate): %.2f KB\n", total / 1024.0);
 
+    if (sAllocCount > 0) {
+        StringAppendF(&result,
+                      "Allocation latency: %" PRIu64 " HAL allocations, avg %.2f ms, "
+                      "buckets [<1ms: %" PRIu64 ", <2ms: %" PRIu64 ", <4ms: %" PRIu64
+                      ", <8ms: %" PRIu64 ", >=8ms: %" PRIu64 "]\n",
+                      sAllocCount, sAllocLatencyTotal / (1e6 * sAllocCount),
+                      sAllocLatencyBuckets[0], sAllocLatencyBuckets[1], sAllocLatencyBuckets[2],
+                      sAllocLatencyBuckets[3], sAllocLatencyBuckets[4]);
+    }
+    if (bufferPoolCapacityBytes() > 0) {
+        StringAppendF(&result, "Buffer pool: %zu buffers, %.2f KB parked, %" PRIu64 " hits\n",
+                      sBufferPool.size(), sBufferPoolBytes / 1024.0, sPoolHitCount);
+    }
+
     result.append(mAllocator->dumpDebugInfo());
 }
 
@@ -132,8 +160,29 @@ status_t GraphicBufferAllocator::allocate(uint32_t width, uint32_t height,
     usage &= ~static_cast<uint64_t>((1 << 10) | (1 << 13));
 #endif
 
+    if (bufferPoolCapacityBytes() > 0) {
+        Mutex::Autolock _l(sLock);
+        for (auto it = sBufferPool.begin(); it != sBufferPool.end(); ++it) {
+            if (it->rec.width == width && it->rec.height == height &&
+                    it->rec.format == format && it->rec.layerCount == layerCount &&
+                    it->rec.usage == usage) {
+                *handle = it->handle;
+                *stride = it->rec.stride;
+                sBufferPoolBytes -= it->rec.size;
+                alloc_rec_t rec = std::move(it->rec);
+                rec.requestorName = std::move(requestorName);
+                sAllocList.add(*handle, rec);
+                sBufferPool.erase(it);
+                sPoolHitCount++;
+                return NO_ERROR;
+            }
+        }
+    }
+
+    const nsecs_t allocStartTime = systemTime();
     status_t error =
             mAllocator->allocate(width, height, format, layerCount, usage, 1, stride, handle);
+    const nsecs_t allocLatency = systemTime() - allocStartTime;
     size_t bufSize;
 
     // if stride has no meaning or is too large,
@@ -147,6 +196,15 @@ status_t GraphicBufferAllocator::allocate(uint32_t width, uint32_t height,
 
     if (error == NO_ERROR) {
         Mutex::Autolock _l(sLock);
+        int bucket = 0;
+        for (nsecs_t threshold = ms2ns(1); bucket < kLatencyBucketCount - 1 &&
+                allocLatency >= threshold; threshold *= 2) {
+            bucket++;
+        }
+        sAllocLatencyBuckets[bucket]++;
+        sAllocCount++;
+        sAllocLatencyTotal += allocLatency;
+
         KeyedVector<buffer_handle_t, alloc_rec_t>& list(sAllocList);
         alloc_rec_t rec;
         rec.width = width;
@@ -173,6 +231,27 @@ status_t GraphicBufferAllocator::free(buffer_handle_t handle)
 {
     ATRACE_CALL();
 
+    if (bufferPoolCapacityBytes() > 0) {
+        Mutex::Autolock _l(sLock);
+        const ssize_t index = sAllocList.indexOfKey(handle);
+        if (index >= 0) {
+            // Park the buffer for reuse instead of releasing it; evict the
+            // oldest entries if the pool runs over budget.
+            pooled_buffer_t pooled;
+            pooled.handle = handle;
+            pooled.rec = sAllocList.valueAt(index);
+            sAllocList.removeItemsAt(index);
+            sBufferPoolBytes += pooled.rec.size;
+            sBufferPool.push_back(std::move(pooled));
+            while (sBufferPoolBytes > bufferPoolCapacityBytes() && !sBufferPool.empty()) {
+                mMapper.freeBuffer(sBufferPool.front().handle);
+                sBufferPoolBytes -= sBufferPool.front().rec.size;
+                sBufferPool.pop_front();
+            }
+            return NO_ERROR;
+        }
+    }
+
     // We allocated a buffer from the allocator and imported it into the
     // mapper to get the handle.  We just need to free the handle now.
     mMapper.freeBuffer(handle);
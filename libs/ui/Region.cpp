@@ -439,17 +439,37 @@ const Region Region::operation(const Region& rhs, int dx, int dy, uint32_t op) c
 
 // This is our region rasterizer, which merges rects and spans together
 // to obtain an optimal region.
+// Reusable per-thread span buffer.  Region boolean operations run
+// thousands of times per frame on a handful of threads, and the per-op
+// Vector allocation for the working span shows up in profiles.  The
+// buffer is handed back empty (capacity retained) when the rasterizer
+// finishes; the in-use flag covers the (not expected) reentrant case.
+struct SpanBufferPool {
+    Vector<Rect> buffer;
+    bool inUse = false;
+};
+static thread_local SpanBufferPool gSpanBufferPool;
+
 class Region::rasterizer : public region_operator<Rect>::region_rasterizer
 {
     Rect bounds;
     Vector<Rect>& storage;
     Rect* head;
     Rect* tail;
-    Vector<Rect> span;
+    Vector<Rect> localSpan;
+    Vector<Rect>& span;
     Rect* cur;
 public:
     explicit rasterizer(Region& reg)
-        : bounds(INT_MAX, 0, INT_MIN, 0), storage(reg.mStorage), head(), tail(), cur() {
+        : bounds(INT_MAX, 0, INT_MIN, 0),
+          storage(reg.mStorage),
+          head(),
+          tail(),
+          span(gSpanBufferPool.inUse ? localSpan : gSpanBufferPool.buffer),
+          cur() {
+        if (&span == &gSpanBufferPool.buffer) {
+            gSpanBufferPool.inUse = true;
+        }
         storage.clear();
     }
 
@@ -471,6 +491,10 @@ Region::rasterizer::~rasterizer()
     if (span.size()) {
         flushSpan();
     }
+    if (&span == &gSpanBufferPool.buffer) {
+        span.clear();
+        gSpanBufferPool.inUse = false;
+    }
     if (storage.size()) {
         bounds.top = storage.itemAt(0).top;
         bounds.bottom = storage.top().bottom;
@@ -807,12 +831,11 @@ status_t Region::flatten(void* buffer, size_t size) const {
     // Cast to uint32_t since the size of a size_t can vary between 32- and
     // 64-bit processes
     FlattenableUtils::write(buffer, size, static_cast<uint32_t>(mStorage.size()));
-    for (auto rect : mStorage) {
-        status_t result = rect.flatten(buffer, size);
-        if (result != NO_ERROR) {
-            return result;
-        }
-        FlattenableUtils::advance(buffer, size, sizeof(rect));
+    // A rect's wire format is its in-memory layout, so the whole span
+    // array flattens as one copy instead of four field writes per rect.
+    static_assert(sizeof(Rect) == 4 * sizeof(int32_t), "Rect layout is the wire format");
+    if (!mStorage.isEmpty()) {
+        memcpy(buffer, mStorage.array(), mStorage.size() * sizeof(Rect));
     }
     return NO_ERROR;
 }
@@ -824,25 +847,20 @@ status_t Region::unflatten(void const* buffer, size_t size) {
 
     uint32_t numRects = 0;
     FlattenableUtils::read(buffer, size, numRects);
-    if (size < numRects * sizeof(Rect)) {
-        return NO_MEMORY;
-    }
-
     if (numRects > (UINT32_MAX / sizeof(Rect))) {
         android_errorWriteWithInfoLog(0x534e4554, "29983260", -1, nullptr, 0);
         return NO_MEMORY;
     }
+    if (size < numRects * sizeof(Rect)) {
+        return NO_MEMORY;
+    }
 
     Region result;
     result.mStorage.clear();
-    for (size_t r = 0; r < numRects; ++r) {
-        Rect rect(Rect::EMPTY_RECT);
-        status_t status = rect.unflatten(buffer, size);
-        if (status != NO_ERROR) {
-            return status;
-        }
-        FlattenableUtils::advance(buffer, size, sizeof(rect));
-        result.mStorage.push_back(rect);
+    if (numRects > 0) {
+        // Same single-copy layout as flatten().
+        result.mStorage.resize(numRects);
+        memcpy(result.mStorage.editArray(), buffer, numRects * sizeof(Rect));
     }
 
 #if defined(VALIDATE_REGIONS)
@@ -261,6 +261,43 @@ Region Transform::transform(const Region& reg) const
         if (CC_LIKELY(preserveRects())) {
             Region::const_iterator it = reg.begin();
             Region::const_iterator const end = reg.end();
+            if (!(type() & SCALE)) {
+                // Pure rotate/flip: each destination edge is an integer
+                // add/negate of exactly one source edge, so the span
+                // array converts without the per-corner float multiplies.
+                // The translation is rounded once up front, which matches
+                // the per-corner rounding for the integral translations
+                // display transforms carry.
+                const mat33& M(mMatrix);
+                const int a = static_cast<int>(floorf(M[0][0] + 0.5f));
+                const int b = static_cast<int>(floorf(M[1][0] + 0.5f));
+                const int c = static_cast<int>(floorf(M[0][1] + 0.5f));
+                const int d = static_cast<int>(floorf(M[1][1] + 0.5f));
+                const int x = static_cast<int>(floorf(M[2][0] + 0.5f));
+                const int y = static_cast<int>(floorf(M[2][1] + 0.5f));
+                while (it != end) {
+                    const Rect& r = *it++;
+                    int left, right, top, bottom;
+                    if (a != 0) {
+                        left = a * r.left + x;
+                        right = a * r.right + x;
+                    } else {
+                        left = b * r.top + x;
+                        right = b * r.bottom + x;
+                    }
+                    if (d != 0) {
+                        top = d * r.top + y;
+                        bottom = d * r.bottom + y;
+                    } else {
+                        top = c * r.left + y;
+                        bottom = c * r.right + y;
+                    }
+                    if (left > right) std::swap(left, right);
+                    if (top > bottom) std::swap(top, bottom);
+                    out.orSelf(Rect(left, top, right, bottom));
+                }
+                return out;
+            }
             while (it != end) {
                 out.orSelf(transform(*it++));
             }
@@ -22,6 +22,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <math/mat3.h>
 #include <math/scalar.h>
@@ -294,10 +295,30 @@ public:
         return apply(mTransform * linear, mDestination.getClamper());
     }
 
+    /**
+     * Bakes 1D lookup tables for the source EOTF and the destination OETF,
+     * so transformSpan() avoids the per-channel std::function transfer
+     * calls that dominate large-image conversion.  The table resolution is
+     * clamped to [64, 4096] entries and sampled with linear interpolation.
+     * Baked tables cover the [0..1] domain; spaces whose clamper admits
+     * values outside it (extended sRGB, ACES) saturate at the table edges
+     * and should stay on transform().
+     */
+    void bakeTransferFunctions(uint32_t size = 1024);
+
+    /**
+     * Transforms a span of gamma-space pixels in place, through the baked
+     * transfer tables when bakeTransferFunctions() has been called, and
+     * through transform() otherwise.
+     */
+    void transformSpan(float3* data, size_t count) const noexcept;
+
 private:
     ColorSpace mSource;
     ColorSpace mDestination;
     mat3 mTransform;
+    std::vector<float> mToLinearLUT;
+    std::vector<float> mFromLinearLUT;
 };
 
 }; // namespace android
@@ -25,6 +25,7 @@
 #include <atomic>
 #include <mutex>
 #include <queue>
+#include <string>
 #include <unordered_map>
 
 namespace android {
@@ -158,9 +159,22 @@ public:
     void push(const std::shared_ptr<FenceTime>& fence);
     void updateSignalTimes();
 
+    // Names the timeline for tracing.  When set (and debug.fence.trace is),
+    // each tracked fence emits an async atrace slice from push to the update
+    // that observes its signal, plus a pending-count counter, so systrace
+    // shows which fence family blew the frame budget.
+    void setTraceName(std::string name);
+
 private:
+    void traceFencePushedLocked(int32_t cookie) REQUIRES(mMutex);
+    void traceFenceSignaledLocked(int32_t cookie) REQUIRES(mMutex);
+
     mutable std::mutex mMutex;
     std::queue<std::weak_ptr<FenceTime>> mQueue GUARDED_BY(mMutex);
+    // async-slice cookies, popped in lockstep with mQueue so a fence whose
+    // owner dropped it still closes its slice
+    std::queue<int32_t> mTraceCookies GUARDED_BY(mMutex);
+    std::string mTraceName GUARDED_BY(mMutex);
 };
 
 // Used by test code to create or get FenceTimes for a given Fence.
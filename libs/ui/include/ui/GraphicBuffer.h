@@ -205,6 +205,23 @@ public:
             android_ycbcr *ycbcr, int fenceFd);
     status_t unlockAsync(int *fenceFd);
 
+    /*
+     * Persistent CPU mapping: once enabled, unlock()/unlockAsync() keep
+     * the gralloc mapping alive and a later lock with the same usage and
+     * bounds returns the cached address (after waiting the acquire
+     * fence), skipping the HAL round trip.  Intended for consumers that
+     * repeatedly map the same small set of buffers (CpuConsumer-style
+     * pipelines).
+     *
+     * On devices without IO-coherent CPU caches the HAL lock/unlock pair
+     * is also where cache maintenance happens, so this must only be
+     * enabled for CPU_*_OFTEN (cached) usage; CPU writers must call
+     * flushPersistentMapping() -- a real HAL unlock -- before handing the
+     * buffer to a device consumer.
+     */
+    void enablePersistentMapping();
+    status_t flushPersistentMapping();
+
     status_t isSupported(uint32_t inWidth, uint32_t inHeight, PixelFormat inFormat,
                          uint32_t inLayerCount, uint64_t inUsage, bool* outSupported) const;
 
@@ -233,6 +250,22 @@ public:
 private:
     ~GraphicBuffer();
 
+    void rememberMapping(uint64_t producerUsage, uint64_t consumerUsage, const Rect& rect,
+                         void* vaddr, int32_t* bytesPerPixel, int32_t* bytesPerStride);
+    void rememberYCbCrMapping(uint64_t usage, const Rect& rect, const android_ycbcr& ycbcr);
+
+    // Persistent-mapping state; see enablePersistentMapping().
+    bool mPersistentMappingEnabled = false;
+    bool mPersistentlyMapped = false;
+    uint64_t mMappedProducerUsage = 0;
+    uint64_t mMappedConsumerUsage = 0;
+    Rect mMappedRect{Rect::EMPTY_RECT};
+    void* mMappedAddr = nullptr;
+    int32_t mMappedBytesPerPixel = -1;
+    int32_t mMappedBytesPerStride = -1;
+    bool mMappedYCbCrValid = false;
+    android_ycbcr mMappedYCbCr = {};
+
     enum {
         ownNone   = 0,
         ownHandle = 1,
@@ -20,6 +20,7 @@
 
 #include <stdint.h>
 
+#include <list>
 #include <memory>
 #include <string>
 
@@ -31,6 +32,7 @@
 #include <utils/KeyedVector.h>
 #include <utils/Mutex.h>
 #include <utils/Singleton.h>
+#include <utils/Timers.h>
 
 namespace android {
 
@@ -69,6 +71,26 @@ protected:
     static Mutex sLock;
     static KeyedVector<buffer_handle_t, alloc_rec_t> sAllocList;
 
+    // Optional free-buffer pool (debug.ui.buffer_pool_kb, default off).
+    // free() parks buffers here instead of releasing them to gralloc, and
+    // allocate() reuses a parked buffer with identical parameters, skipping
+    // the multi-millisecond HAL allocation during resize storms.  Oldest
+    // entries are evicted once the pool exceeds its byte budget.
+    struct pooled_buffer_t {
+        buffer_handle_t handle;
+        alloc_rec_t rec;
+    };
+    static std::list<pooled_buffer_t> sBufferPool;
+    static size_t sBufferPoolBytes;
+
+    // Allocation latency accounting for dump(): HAL allocations only --
+    // pool hits are recorded separately.
+    static constexpr int kLatencyBucketCount = 5; // <1ms, <2ms, <4ms, <8ms, rest
+    static uint64_t sAllocLatencyBuckets[kLatencyBucketCount];
+    static uint64_t sAllocCount;
+    static uint64_t sPoolHitCount;
+    static nsecs_t sAllocLatencyTotal;
+
     friend class Singleton<GraphicBufferAllocator>;
     GraphicBufferAllocator();
     ~GraphicBufferAllocator();
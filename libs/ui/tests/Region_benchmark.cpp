@@ -0,0 +1,84 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <ui/Rect.h>
+#include <ui/Region.h>
+
+using namespace android;
+
+namespace {
+
+// Mimics SurfaceFlinger's visible-region computation: a column of
+// window-sized layers accumulated into covered/opaque regions.
+void visibleRegionsWorkload(size_t layerCount) {
+    Region aboveOpaque;
+    Region aboveCovered;
+    Region dirty;
+    for (size_t i = 0; i < layerCount; i++) {
+        const int32_t offset = static_cast<int32_t>(i) * 50;
+        Region visible(Rect(offset, offset, offset + 1080, offset + 1920));
+        const Region covered = aboveCovered.intersect(visible);
+        aboveCovered.orSelf(visible);
+        visible.subtractSelf(aboveOpaque);
+        dirty.orSelf(visible.subtract(covered));
+        if ((i & 1) == 0) {
+            aboveOpaque.orSelf(visible);
+        }
+    }
+    benchmark::DoNotOptimize(dirty.isEmpty());
+}
+
+} // namespace
+
+static void BM_visibleRegions(benchmark::State& state) {
+    while (state.KeepRunning()) {
+        visibleRegionsWorkload(state.range(0));
+    }
+}
+BENCHMARK(BM_visibleRegions)->Arg(10)->Arg(50)->Arg(200);
+
+static void BM_orSelf_fragmented(benchmark::State& state) {
+    // Many disjoint rects, the worst case for the span rasterizer.
+    while (state.KeepRunning()) {
+        Region accumulated;
+        for (int i = 0; i < state.range(0); i++) {
+            const int32_t x = (i % 16) * 128;
+            const int32_t y = (i / 16) * 128;
+            accumulated.orSelf(Rect(x, y, x + 64, y + 64));
+        }
+        benchmark::DoNotOptimize(accumulated.getBounds());
+    }
+}
+BENCHMARK(BM_orSelf_fragmented)->Arg(64)->Arg(256);
+
+static void BM_subtractSelf(benchmark::State& state) {
+    const Region screen(Rect(0, 0, 1080, 1920));
+    Region holes;
+    for (int i = 0; i < 32; i++) {
+        const int32_t y = i * 60;
+        holes.orSelf(Rect(100, y, 980, y + 30));
+    }
+    while (state.KeepRunning()) {
+        Region visible(screen);
+        visible.subtractSelf(holes);
+        benchmark::DoNotOptimize(visible.isEmpty());
+    }
+}
+BENCHMARK(BM_subtractSelf);
+
+BENCHMARK_MAIN();
@@ -17,6 +17,9 @@
 #define LOG_TAG "RegionTest"
 
 #include <stdlib.h>
+#include <string.h>
+
+#include <vector>
 #include <ui/Region.h>
 #include <ui/Rect.h>
 #include <gtest/gtest.h>
@@ -152,5 +155,46 @@ TEST_F(RegionTest, Random_TJunction) {
     }
 }
 
+TEST_F(RegionTest, FlattenUnflattenRoundTrip) {
+    Region original;
+    original.orSelf(Rect(0, 0, 100, 100));
+    original.orSelf(Rect(150, 20, 170, 80));
+    original.orSelf(Rect(30, 120, 60, 180));
+
+    const size_t size = original.getFlattenedSize();
+    std::vector<uint8_t> buffer(size);
+    ASSERT_EQ(NO_ERROR, original.flatten(buffer.data(), buffer.size()));
+
+    Region copy;
+    ASSERT_EQ(NO_ERROR, copy.unflatten(buffer.data(), buffer.size()));
+    size_t originalCount;
+    const Rect* originalRects = original.getArray(&originalCount);
+    size_t copyCount;
+    const Rect* copyRects = copy.getArray(&copyCount);
+    ASSERT_EQ(originalCount, copyCount);
+    EXPECT_EQ(0, memcmp(originalRects, copyRects, originalCount * sizeof(Rect)));
+
+    // The wire image must stay stable: count word followed by the raw
+    // rect array.
+    uint32_t numRects = 0;
+    memcpy(&numRects, buffer.data(), sizeof(numRects));
+    ASSERT_EQ(size, sizeof(uint32_t) + numRects * sizeof(Rect));
+    ASSERT_EQ(originalCount, size_t(numRects));
+    EXPECT_EQ(0,
+              memcmp(buffer.data() + sizeof(uint32_t), originalRects,
+                     originalCount * sizeof(Rect)));
+}
+
+TEST_F(RegionTest, UnflattenRejectsTruncated) {
+    Region original;
+    original.orSelf(Rect(0, 0, 16, 16));
+    std::vector<uint8_t> buffer(original.getFlattenedSize());
+    ASSERT_EQ(NO_ERROR, original.flatten(buffer.data(), buffer.size()));
+
+    Region copy;
+    EXPECT_NE(NO_ERROR, copy.unflatten(buffer.data(), buffer.size() - 1));
+    EXPECT_NE(NO_ERROR, copy.unflatten(buffer.data(), sizeof(uint32_t) - 1));
+}
+
 }; // namespace android
 
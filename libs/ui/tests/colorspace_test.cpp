@@ -19,6 +19,8 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include <ui/ColorSpace.h>
 
 #include <gtest/gtest.h>
@@ -162,6 +164,34 @@ TEST_F(ColorSpaceTest, Connect) {
     EXPECT_TRUE(all(lessThan(abs(r - float3{0.70226f, 0.2757f, 0.1036f}), float3{1e-4f})));
 }
 
+TEST_F(ColorSpaceTest, TransformSpan) {
+    ColorSpaceConnector connector(ColorSpace::sRGB(), ColorSpace::DisplayP3());
+
+    float3 pixels[16];
+    for (int i = 0; i < 16; i++) {
+        pixels[i] = float3{i / 15.0f, 1.0f - i / 15.0f, 0.25f};
+    }
+    float3 expected[16];
+    for (int i = 0; i < 16; i++) {
+        expected[i] = connector.transform(pixels[i]);
+    }
+
+    // Unbaked: span must match per-pixel transform() exactly.
+    float3 unbaked[16];
+    std::copy(pixels, pixels + 16, unbaked);
+    connector.transformSpan(unbaked, 16);
+    for (int i = 0; i < 16; i++) {
+        EXPECT_TRUE(all(lessThan(abs(unbaked[i] - expected[i]), float3{1e-6f})));
+    }
+
+    // Baked: interpolated tables must stay close to the analytic result.
+    connector.bakeTransferFunctions(1024);
+    connector.transformSpan(pixels, 16);
+    for (int i = 0; i < 16; i++) {
+        EXPECT_TRUE(all(lessThan(abs(pixels[i] - expected[i]), float3{1e-3f})));
+    }
+}
+
 TEST_F(ColorSpaceTest, LUT) {
     auto lut = ColorSpace::createLUT(17, ColorSpace::sRGB(), ColorSpace::AdobeRGB());
     EXPECT_TRUE(lut != nullptr);
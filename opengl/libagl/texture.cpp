@@ -281,6 +281,26 @@ int copyPixels(
         return 0;
     }
 
+    if ((dst.format == src.format) && (dst.stride > 0) && (src.stride > 0)) {
+        // Same-format top-down transfers never need the rasterizer: copy
+        // row by row, one memcpy per scanline, whatever the strides and
+        // offsets.  Bottom-up (negative stride) surfaces keep going through
+        // pixelflinger, which owns that addressing convention.
+        const GGLFormat& pixelFormat(c->rasterizer.formats[src.format]);
+        const size_t bpp = pixelFormat.size;
+        const size_t rowBytes = size_t(w) * bpp;
+        uint8_t* d = reinterpret_cast<uint8_t*>(dst.data) +
+                (size_t(yoffset) * dst.stride + size_t(xoffset)) * bpp;
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(src.data) +
+                (size_t(y) * src.stride + size_t(x)) * bpp;
+        for (GLsizei i = 0; i < h; i++) {
+            memcpy(d, s, rowBytes);
+            d += dst.stride * bpp;
+            s += src.stride * bpp;
+        }
+        return 0;
+    }
+
     // use pixel-flinger to handle all the conversions
     GGLContext* ggl = getRasterizer(c);
     if (!ggl) {
@@ -115,72 +115,75 @@ FileBlobCache::FileBlobCache(size_t maxKeySize, size_t maxValueSize, size_t maxT
 }
 
 void FileBlobCache::writeToFile() {
-    if (mFilename.length() > 0) {
-        size_t cacheSize = getFlattenedSize();
-        size_t headerSize = cacheFileHeaderSize;
-        const char* fname = mFilename.c_str();
+    writeSaveBufferToFile(mFilename, flattenForSave());
+}
 
-        // Try to create the file with no permissions so we can write it
-        // without anyone trying to read it.
-        int fd = open(fname, O_CREAT | O_EXCL | O_RDWR, 0);
-        if (fd == -1) {
-            if (errno == EEXIST) {
-                // The file exists, delete it and try again.
-                if (unlink(fname) == -1) {
-                    // No point in retrying if the unlink failed.
-                    ALOGE("error unlinking cache file %s: %s (%d)", fname,
-                            strerror(errno), errno);
-                    return;
-                }
-                // Retry now that we've unlinked the file.
-                fd = open(fname, O_CREAT | O_EXCL | O_RDWR, 0);
-            }
-            if (fd == -1) {
-                ALOGE("error creating cache file %s: %s (%d)", fname,
-                        strerror(errno), errno);
-                return;
-            }
-        }
+std::vector<uint8_t> FileBlobCache::flattenForSave() {
+    std::vector<uint8_t> buf;
+    if (mFilename.length() == 0) {
+        return buf;
+    }
 
-        size_t fileSize = headerSize + cacheSize;
+    size_t cacheSize = getFlattenedSize();
+    size_t headerSize = cacheFileHeaderSize;
+    buf.resize(headerSize + cacheSize);
 
-        uint8_t* buf = new uint8_t [fileSize];
-        if (!buf) {
-            ALOGE("error allocating buffer for cache contents: %s (%d)",
-                    strerror(errno), errno);
-            close(fd);
-            unlink(fname);
-            return;
-        }
+    int err = flatten(buf.data() + headerSize, cacheSize);
+    if (err < 0) {
+        ALOGE("error writing cache contents: %s (%d)", strerror(-err),
+                -err);
+        buf.clear();
+        return buf;
+    }
 
-        int err = flatten(buf + headerSize, cacheSize);
-        if (err < 0) {
-            ALOGE("error writing cache contents: %s (%d)", strerror(-err),
-                    -err);
-            delete [] buf;
-            close(fd);
-            unlink(fname);
-            return;
-        }
+    // Write the file magic and CRC
+    memcpy(buf.data(), cacheFileMagic, 4);
+    uint32_t* crc = reinterpret_cast<uint32_t*>(buf.data() + 4);
+    *crc = crc32c(buf.data() + headerSize, cacheSize);
 
-        // Write the file magic and CRC
-        memcpy(buf, cacheFileMagic, 4);
-        uint32_t* crc = reinterpret_cast<uint32_t*>(buf + 4);
-        *crc = crc32c(buf + headerSize, cacheSize);
+    return buf;
+}
 
-        if (write(fd, buf, fileSize) == -1) {
-            ALOGE("error writing cache file: %s (%d)", strerror(errno),
-                    errno);
-            delete [] buf;
-            close(fd);
-            unlink(fname);
+void FileBlobCache::writeSaveBufferToFile(const std::string& filename,
+                                          const std::vector<uint8_t>& buf) {
+    if (filename.length() == 0 || buf.empty()) {
+        return;
+    }
+
+    const char* fname = filename.c_str();
+
+    // Try to create the file with no permissions so we can write it
+    // without anyone trying to read it.
+    int fd = open(fname, O_CREAT | O_EXCL | O_RDWR, 0);
+    if (fd == -1) {
+        if (errno == EEXIST) {
+            // The file exists, delete it and try again.
+            if (unlink(fname) == -1) {
+                // No point in retrying if the unlink failed.
+                ALOGE("error unlinking cache file %s: %s (%d)", fname,
+                        strerror(errno), errno);
+                return;
+            }
+            // Retry now that we've unlinked the file.
+            fd = open(fname, O_CREAT | O_EXCL | O_RDWR, 0);
+        }
+        if (fd == -1) {
+            ALOGE("error creating cache file %s: %s (%d)", fname,
+                    strerror(errno), errno);
             return;
         }
+    }
 
-        delete [] buf;
-        fchmod(fd, S_IRUSR);
+    if (write(fd, buf.data(), buf.size()) == -1) {
+        ALOGE("error writing cache file: %s (%d)", strerror(errno),
+                errno);
         close(fd);
+        unlink(fname);
+        return;
     }
+
+    fchmod(fd, S_IRUSR);
+    close(fd);
 }
 
 }
@@ -19,6 +19,7 @@
 
 #include "BlobCache.h"
 #include <string>
+#include <vector>
 
 namespace android {
 
@@ -33,6 +34,18 @@ public:
     // disk.
     void writeToFile();
 
+    // flattenForSave snapshots the current contents (including the file
+    // header and CRC) into a buffer; call it while holding whatever lock
+    // guards this cache.  The buffer is empty on failure or when no
+    // backing file is configured.
+    std::vector<uint8_t> flattenForSave();
+
+    // writeSaveBufferToFile writes a buffer produced by flattenForSave()
+    // to disk.  Static so the caller can keep performing the write after
+    // dropping the cache lock, even if the cache itself goes away.
+    static void writeSaveBufferToFile(const std::string& filename,
+                                      const std::vector<uint8_t>& buf);
+
 private:
     // mFilename is the name of the file for storing cache contents.
     std::string mFilename;
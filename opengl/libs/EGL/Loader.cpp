@@ -19,6 +19,7 @@
 
 #include <EGL/Loader.h>
 
+#include <future>
 #include <string>
 
 #include <dirent.h>
@@ -705,18 +706,37 @@ Loader::driver_t* Loader::attempt_to_load_system_driver(egl_connection_t* cnx, c
         hnd = new driver_t(dso);
         return hnd;
     }
+    // The three split vendor libraries are independent until their
+    // entrypoints are wired into the connection, so resolve and dlopen
+    // them concurrently; the serial loads are 20-40ms of app launch on
+    // some devices.  Hook initialization stays on this thread.
+    auto glesv1Future = std::async(std::launch::async, [suffix, exact] {
+        return load_system_driver("GLESv1_CM", suffix, exact);
+    });
+    auto glesv2Future = std::async(std::launch::async, [suffix, exact] {
+        return load_system_driver("GLESv2", suffix, exact);
+    });
+
     dso = load_system_driver("EGL", suffix, exact);
     if (dso) {
         initialize_api(dso, cnx, EGL);
         hnd = new driver_t(dso);
 
-        dso = load_system_driver("GLESv1_CM", suffix, exact);
+        dso = glesv1Future.get();
         initialize_api(dso, cnx, GLESv1_CM);
         hnd->set(dso, GLESv1_CM);
 
-        dso = load_system_driver("GLESv2", suffix, exact);
+        dso = glesv2Future.get();
         initialize_api(dso, cnx, GLESv2);
         hnd->set(dso, GLESv2);
+    } else {
+        // No split EGL library: drop whatever the workers picked up.
+        if (void* glesv1 = glesv1Future.get()) {
+            do_dlclose(glesv1);
+        }
+        if (void* glesv2 = glesv2Future.get()) {
+            do_dlclose(glesv2);
+        }
     }
     return hnd;
 }
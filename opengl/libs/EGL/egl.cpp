@@ -16,6 +16,8 @@
 
 #include <stdlib.h>
 
+#include <thread>
+
 #include <hardware/gralloc.h>
 
 #include <EGL/egl.h>
@@ -83,6 +85,26 @@ static void early_egl_init(void)
 static pthread_once_t once_control = PTHREAD_ONCE_INIT;
 static int sEarlyInitState = pthread_once(&once_control, &early_egl_init);
 
+EGLBoolean egl_init_drivers();
+
+// Optional zygote-preload mode: start resolving, mapping and relocating
+// the vendor driver on a background thread as soon as this library is
+// loaded, so the first eglGetDisplay() in the process (and, when the
+// library is preloaded by the zygote, in every forked app) finds the
+// driver ready.  Off unless debug.egl.async_preload is set, since library
+// initialization normally must not spawn threads -- and a process that
+// forks (the zygote) must only enable this if it waits for the preload to
+// finish before forking, or children can inherit held loader locks.
+static int async_preload_egl_drivers() {
+    char value[PROPERTY_VALUE_MAX];
+    property_get("debug.egl.async_preload", value, "0");
+    if (atoi(value)) {
+        std::thread([] { egl_init_drivers(); }).detach();
+    }
+    return 0;
+}
+[[maybe_unused]] static int sAsyncPreloadState = async_preload_egl_drivers();
+
 // ----------------------------------------------------------------------------
 
 egl_display_ptr validate_display(EGLDisplay dpy) {
@@ -24,14 +24,32 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <thread>
 
+#include <cutils/properties.h>
+
 #include <log/log.h>
 
 // Cache size limits.
 static const size_t maxKeySize = 12 * 1024;
 static const size_t maxValueSize = 64 * 1024;
-static const size_t maxTotalSize = 2 * 1024 * 1024;
+// Default in-memory / on-disk budget; big games blow past 2MB of shader
+// programs, so the limit is tunable per device (debug.egl.blobcache_kb).
+static const size_t defaultMaxTotalSize = 2 * 1024 * 1024;
+
+static size_t getMaxTotalSize() {
+    char value[PROPERTY_VALUE_MAX];
+    property_get("debug.egl.blobcache_kb", value, "0");
+    const long sizeKb = atol(value);
+    if (sizeKb <= 0) {
+        return defaultMaxTotalSize;
+    }
+    // Clamp to something sane: at least the historical default, at most
+    // 64MB so a bad property cannot eat the cache partition.
+    const size_t size = static_cast<size_t>(sizeKb) * 1024;
+    return std::min<size_t>(std::max<size_t>(size, defaultMaxTotalSize), 64 * 1024 * 1024);
+}
 
 // The time in seconds to wait before saving newly inserted cache entries.
 static const unsigned int deferredSaveDelay = 4;
@@ -139,11 +157,20 @@ void egl_cache_t::setBlob(const void* key, EGLsizeiANDROID keySize,
             mSavePending = true;
             std::thread deferredSaveThread([this]() {
                 sleep(deferredSaveDelay);
-                std::lock_guard<std::mutex> lock(mMutex);
-                if (mInitialized && mBlobCache) {
-                    mBlobCache->writeToFile();
+                // Snapshot the contents under the lock, but keep the disk
+                // write outside it so a render thread's setBlob/getBlob
+                // never stalls behind file I/O.
+                std::vector<uint8_t> saveBuffer;
+                std::string filename;
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    if (mInitialized && mBlobCache) {
+                        saveBuffer = mBlobCache->flattenForSave();
+                        filename = mFilename;
+                    }
+                    mSavePending = false;
                 }
-                mSavePending = false;
+                FileBlobCache::writeSaveBufferToFile(filename, saveBuffer);
             });
             deferredSaveThread.detach();
         }
@@ -173,7 +200,7 @@ void egl_cache_t::setCacheFilename(const char* filename) {
 
 BlobCache* egl_cache_t::getBlobCacheLocked() {
     if (mBlobCache == nullptr) {
-        mBlobCache.reset(new FileBlobCache(maxKeySize, maxValueSize, maxTotalSize, mFilename));
+        mBlobCache.reset(new FileBlobCache(maxKeySize, maxValueSize, getMaxTotalSize(), mFilename));
     }
     return mBlobCache.get();
 }
@@ -29,26 +29,55 @@ BufferHubIdGenerator& BufferHubIdGenerator::getInstance() {
     return generator;
 }
 
-int BufferHubIdGenerator::getId() {
-    std::lock_guard<std::mutex> lock(mIdsInUseMutex);
+BufferHubIdGenerator::BufferHubIdGenerator() {
+    for (uint32_t i = 0; i < kFreeRingCapacity; ++i) {
+        mFreeRing[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
 
-    do {
-        if (++mLastId >= std::numeric_limits<int>::max()) {
-            mLastId = 0;
+int BufferHubIdGenerator::getId() {
+    // try the recycle ring first
+    uint32_t pos = mFreeHead.load(std::memory_order_relaxed);
+    for (;;) {
+        FreeCell& cell = mFreeRing[pos & (kFreeRingCapacity - 1)];
+        const uint32_t seq = cell.seq.load(std::memory_order_acquire);
+        const int32_t dif = static_cast<int32_t>(seq - (pos + 1));
+        if (dif == 0) {
+            if (mFreeHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                const int id = cell.id;
+                cell.seq.store(pos + kFreeRingCapacity, std::memory_order_release);
+                return id;
+            }
+        } else if (dif < 0) {
+            break; // ring empty; mint a fresh id
+        } else {
+            pos = mFreeHead.load(std::memory_order_relaxed);
         }
-    } while (mIdsInUse.find(mLastId) != mIdsInUse.end());
+    }
 
-    mIdsInUse.insert(mLastId);
-    return mLastId;
+    const int32_t id = mNextId.fetch_add(1, std::memory_order_relaxed);
+    LOG_ALWAYS_FATAL_IF(id < 0, "%s: id space exhausted", __FUNCTION__);
+    return id;
 }
 
 void BufferHubIdGenerator::freeId(int id) {
-    std::lock_guard<std::mutex> lock(mIdsInUseMutex);
-    auto iter = mIdsInUse.find(id);
-    if (iter != mIdsInUse.end()) {
-        mIdsInUse.erase(iter);
-    } else {
-        ALOGW("%s: Cannot free nonexistent id #%d", __FUNCTION__, id);
+    uint32_t pos = mFreeTail.load(std::memory_order_relaxed);
+    for (;;) {
+        FreeCell& cell = mFreeRing[pos & (kFreeRingCapacity - 1)];
+        const uint32_t seq = cell.seq.load(std::memory_order_acquire);
+        const int32_t dif = static_cast<int32_t>(seq - pos);
+        if (dif == 0) {
+            if (mFreeTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.id = id;
+                cell.seq.store(pos + 1, std::memory_order_release);
+                return;
+            }
+        } else if (dif < 0) {
+            // ring full: abandon the id; fresh ids will cover it
+            return;
+        } else {
+            pos = mFreeTail.load(std::memory_order_relaxed);
+        }
     }
 }
 
@@ -17,10 +17,7 @@
 #ifndef ANDROID_FRAMEWORKS_BUFFERHUB_V1_0_ID_GENERATOR_H
 #define ANDROID_FRAMEWORKS_BUFFERHUB_V1_0_ID_GENERATOR_H
 
-#include <mutex>
-#include <set>
-
-#include <utils/Mutex.h>
+#include <atomic>
 
 namespace android {
 namespace frameworks {
@@ -29,27 +26,38 @@ namespace V1_0 {
 namespace implementation {
 
 // A thread-safe, non-negative, incremental, int id generator.
+//
+// Lock-free: fresh ids come from an atomic counter and freed ids are
+// recycled through a bounded MPMC ring (Vyukov-style per-cell sequence
+// numbers), so concurrent buffer allocation and teardown never serialize on
+// a mutex here.  If the ring is full a freed id is simply abandoned; the
+// 31-bit fresh-id space absorbs the loss.
 class BufferHubIdGenerator {
 public:
     // Get the singleton instance of this class
     static BufferHubIdGenerator& getInstance();
 
-    // Gets next available id. If next id is greater than std::numeric_limits<int32_t>::max(), it
-    // will try to get an id start from 0 again.
+    // Gets next available id, preferring recycled ones.
     int getId();
 
-    // Free a specific id.
+    // Free a specific id for reuse.
     void freeId(int id);
 
 private:
-    BufferHubIdGenerator() = default;
+    BufferHubIdGenerator();
     ~BufferHubIdGenerator() = default;
 
-    // Start from -1 so all valid ids will be >= 0
-    int mLastId = -1;
+    static constexpr uint32_t kFreeRingCapacity = 4096; // power of two
+
+    struct FreeCell {
+        std::atomic<uint32_t> seq;
+        int id;
+    };
 
-    std::mutex mIdsInUseMutex;
-    std::set<int> mIdsInUse GUARDED_BY(mIdsInUseMutex);
+    std::atomic<int32_t> mNextId{0};
+    FreeCell mFreeRing[kFreeRingCapacity];
+    std::atomic<uint32_t> mFreeHead{0};
+    std::atomic<uint32_t> mFreeTail{0};
 };
 
 } // namespace implementation
@@ -30,6 +30,16 @@
 
 #include <vkjson.h>
 
+#include <dirent.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#include <chrono>
+
+#include <android-base/file.h>
+#include <android-base/parseint.h>
+#include <android-base/strings.h>
+
 #include "gpustats/GpuStats.h"
 
 namespace android {
@@ -46,7 +56,64 @@ const String16 sDump("android.permission.DUMP");
 
 const char* const GpuService::SERVICE_NAME = "gpu";
 
-GpuService::GpuService() : mGpuStats(std::make_unique<GpuStats>()){};
+GpuService::GpuService() : mGpuStats(std::make_unique<GpuStats>()) {
+    const int32_t pollMs = property_get_int32("debug.gpuservice.freq_poll_ms", 0);
+    if (pollMs > 0) {
+        mGpuFreqNode = findGpuFreqNode();
+        if (!mGpuFreqNode.empty()) {
+            mFreqSampler = std::thread(&GpuService::gpuFreqSamplerLoop, this, pollMs);
+        } else {
+            ALOGW("GPU frequency telemetry requested but no sysfs node found");
+        }
+    }
+}
+
+GpuService::~GpuService() {
+    mFreqSamplerExit.store(true);
+    if (mFreqSampler.joinable()) {
+        mFreqSampler.join();
+    }
+}
+
+std::string GpuService::findGpuFreqNode() {
+    // Adreno exposes the clock under kgsl; everything else worth reading
+    // shows up as a devfreq device with a GPU-ish name.
+    static const char* kKgslNode = "/sys/class/kgsl/kgsl-3d0/gpuclk";
+    if (access(kKgslNode, R_OK) == 0) {
+        return kKgslNode;
+    }
+
+    std::unique_ptr<DIR, decltype(&closedir)> dir(opendir("/sys/class/devfreq"), closedir);
+    if (!dir) {
+        return std::string();
+    }
+    while (struct dirent* entry = readdir(dir.get())) {
+        const std::string name = entry->d_name;
+        if (name.find("gpu") == std::string::npos && name.find("mali") == std::string::npos &&
+            name.find("kgsl") == std::string::npos) {
+            continue;
+        }
+        std::string node = "/sys/class/devfreq/" + name + "/cur_freq";
+        if (access(node.c_str(), R_OK) == 0) {
+            return node;
+        }
+    }
+    return std::string();
+}
+
+void GpuService::gpuFreqSamplerLoop(int32_t pollMs) {
+    while (!mFreqSamplerExit.load()) {
+        std::string contents;
+        if (base::ReadFileToString(mGpuFreqNode, &contents)) {
+            int64_t freq = 0;
+            if (base::ParseInt(base::Trim(contents), &freq)) {
+                mLastGpuFreqHz.store(freq);
+                ATRACE_INT64("GPU freq", freq);
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(pollMs));
+    }
+}
 
 void GpuService::setGpuStats(const std::string& driverPackageName,
                              const std::string& driverVersionName, uint64_t driverVersionCode,
@@ -116,6 +183,12 @@ status_t GpuService::doDump(int fd, const Vector<String16>& args, bool /*asProto
 
             mGpuStats->dump(Vector<String16>(), &result);
             result.append("\n");
+
+            const int64_t gpuFreq = mLastGpuFreqHz.load();
+            if (gpuFreq >= 0) {
+                StringAppendF(&result, "GPU frequency: %" PRId64 " (from %s)\n\n", gpuFreq,
+                              mGpuFreqNode.c_str());
+            }
         }
     }
 
@@ -23,7 +23,10 @@
 #include <graphicsenv/IGpuService.h>
 #include <serviceutils/PriorityDumper.h>
 
+#include <atomic>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace android {
@@ -35,6 +38,7 @@ public:
     static const char* const SERVICE_NAME ANDROID_API;
 
     GpuService() ANDROID_API;
+    ~GpuService();
 
 protected:
     status_t shellCommand(int in, int out, int err, std::vector<String16>& args) override;
@@ -71,6 +75,21 @@ private:
 
     status_t doDump(int fd, const Vector<String16>& args, bool asProto);
 
+    /*
+     * GPU frequency telemetry (debug.gpuservice.freq_poll_ms > 0): a
+     * sampler thread reads the GPU clock from whichever devfreq/kgsl sysfs
+     * node this device exposes, emits it as an atrace counter, and keeps
+     * the last value for dumpsys.  Best-effort -- devices without a
+     * recognizable node simply don't start the thread.
+     */
+    void gpuFreqSamplerLoop(int32_t pollMs);
+    static std::string findGpuFreqNode();
+
+    std::thread mFreqSampler;
+    std::atomic<bool> mFreqSamplerExit { false };
+    std::atomic<int64_t> mLastGpuFreqHz { -1 };
+    std::string mGpuFreqNode;
+
     /*
      * Attributes
      */
@@ -54,6 +54,25 @@ public:
         return t;
     };
 
+    /**
+     * Retrieve and remove all queued objects, oldest first.
+     * Blocks execution while queue is empty.
+     * A consumer that can process elements in bulk should prefer this over pop(): a burst of
+     * pushes is drained with a single wakeup and a single lock handoff.
+     */
+    std::vector<T> popAll() {
+        std::unique_lock lock(mLock);
+        android::base::ScopedLockAssertion assumeLock(mLock);
+        mHasElements.wait(lock, [this]{
+                android::base::ScopedLockAssertion assumeLock(mLock);
+                return !this->mQueue.empty();
+        });
+        std::vector<T> all;
+        all.swap(mQueue);
+        mQueue.reserve(mCapacity);
+        return all;
+    };
+
     /**
      * Add a new object to the queue.
      * Does not block.
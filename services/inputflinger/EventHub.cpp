@@ -817,7 +817,14 @@ size_t EventHub::getEvents(int timeoutMillis, RawEvent* buffer, size_t bufferSiz
 
     AutoMutex _l(mLock);
 
-    struct input_event readBuffer[bufferSize];
+    // The raw read buffer lives on the heap: callers now pass multi-
+    // thousand-event buffers to batch high-rate devices, which would be
+    // tens of kilobytes of stack as a VLA.  It persists across calls and
+    // grows to the largest requested batch.
+    if (mInputEventBuffer.size() < bufferSize) {
+        mInputEventBuffer.resize(bufferSize);
+    }
+    struct input_event* readBuffer = mInputEventBuffer.data();
 
     RawEvent* event = buffer;
     size_t capacity = bufferSize;
@@ -476,6 +476,10 @@ private:
 
     // The array of pending epoll events and the index of the next event to be handled.
     struct epoll_event mPendingEventItems[EPOLL_MAX_EVENTS];
+
+    // Reusable raw-event read buffer for getEvents(); heap-backed so large
+    // batched reads for high-rate devices don't live on the stack.
+    std::vector<struct input_event> mInputEventBuffer;
     size_t mPendingEventCount;
     size_t mPendingEventIndex;
     bool mPendingINotify;
@@ -231,44 +231,49 @@ void MotionClassifier::callInputClassifierHal() {
     // From this point on, mService is guaranteed to be non-null.
 
     while (true) {
-        ClassifierEvent event = mEvents.pop();
-        bool halResponseOk = true;
-        switch (event.type) {
-            case ClassifierEventType::MOTION: {
-                NotifyMotionArgs* motionArgs = static_cast<NotifyMotionArgs*>(event.args.get());
-                common::V1_0::MotionEvent motionEvent =
-                        notifyMotionArgsToHalMotionEvent(*motionArgs);
-                Return<common::V1_0::Classification> response = mService->classify(motionEvent);
-                halResponseOk = response.isOk();
-                if (halResponseOk) {
-                    common::V1_0::Classification halClassification = response;
-                    updateClassification(motionArgs->deviceId, motionArgs->eventTime,
-                            getMotionClassification(halClassification));
+        // Drain every queued event with one wakeup.  The HIDL interface only classifies one
+        // MotionEvent per call, but taking the whole backlog here removes a condition variable
+        // handoff per event when samples arrive faster than the HAL returns.
+        std::vector<ClassifierEvent> events = mEvents.popAll();
+        for (ClassifierEvent& event : events) {
+            bool halResponseOk = true;
+            switch (event.type) {
+                case ClassifierEventType::MOTION: {
+                    NotifyMotionArgs* motionArgs = static_cast<NotifyMotionArgs*>(event.args.get());
+                    common::V1_0::MotionEvent motionEvent =
+                            notifyMotionArgsToHalMotionEvent(*motionArgs);
+                    Return<common::V1_0::Classification> response = mService->classify(motionEvent);
+                    halResponseOk = response.isOk();
+                    if (halResponseOk) {
+                        common::V1_0::Classification halClassification = response;
+                        updateClassification(motionArgs->deviceId, motionArgs->eventTime,
+                                getMotionClassification(halClassification));
+                    }
+                    break;
+                }
+                case ClassifierEventType::DEVICE_RESET: {
+                    const int32_t deviceId = *(event.getDeviceId());
+                    halResponseOk = mService->resetDevice(deviceId).isOk();
+                    setClassification(deviceId, MotionClassification::NONE);
+                    break;
+                }
+                case ClassifierEventType::HAL_RESET: {
+                    halResponseOk = mService->reset().isOk();
+                    clearClassifications();
+                    break;
+                }
+                case ClassifierEventType::EXIT: {
+                    clearClassifications();
+                    return;
                 }
-                break;
-            }
-            case ClassifierEventType::DEVICE_RESET: {
-                const int32_t deviceId = *(event.getDeviceId());
-                halResponseOk = mService->resetDevice(deviceId).isOk();
-                setClassification(deviceId, MotionClassification::NONE);
-                break;
-            }
-            case ClassifierEventType::HAL_RESET: {
-                halResponseOk = mService->reset().isOk();
-                clearClassifications();
-                break;
             }
-            case ClassifierEventType::EXIT: {
+            if (!halResponseOk) {
+                ALOGE("Error communicating with InputClassifier HAL. "
+                        "Exiting MotionClassifier HAL thread");
                 clearClassifications();
                 return;
             }
         }
-        if (!halResponseOk) {
-            ALOGE("Error communicating with InputClassifier HAL. "
-                    "Exiting MotionClassifier HAL thread");
-            clearClassifications();
-            return;
-        }
     }
 }
 
@@ -48,13 +48,17 @@
 #include <errno.h>
 #include <inttypes.h>
 #include <limits.h>
+
+#include <algorithm>
 #include <sstream>
+#include <vector>
 #include <stddef.h>
 #include <time.h>
 #include <unistd.h>
 
 #include <android-base/chrono_utils.h>
 #include <android-base/stringprintf.h>
+#include <cutils/properties.h>
 #include <log/log.h>
 #include <utils/Trace.h>
 #include <powermanager/PowerManager.h>
@@ -234,6 +238,7 @@ static T getValueByKey(std::unordered_map<U, T>& map, U key) {
 
 InputDispatcher::InputDispatcher(const sp<InputDispatcherPolicyInterface>& policy) :
     mPolicy(policy),
+    mCoalesceCursorMoves(property_get_bool("debug.input.coalesce_cursor_moves", false)),
     mPendingEvent(nullptr), mLastDropReason(DROP_REASON_NOT_DROPPED),
     mAppSwitchSawKeyDown(false), mAppSwitchDueTime(LONG_LONG_MAX),
     mNextUnblockedEvent(nullptr),
@@ -441,9 +446,18 @@ void InputDispatcher::dispatchOnceInnerLocked(nsecs_t* nextWakeupTime) {
 }
 
 bool InputDispatcher::enqueueInboundEventLocked(EventEntry* entry) {
+    if (mCoalesceCursorMoves && entry->type == EventEntry::TYPE_MOTION
+            && tryCoalesceCursorMoveLocked(static_cast<MotionEntry*>(entry))) {
+        // The sample was folded into the pending tail entry; the queue is non-empty so the
+        // dispatcher is already awake (or will drain it on its current wakeup).
+        entry->release();
+        return false;
+    }
+
     bool needWake = mInboundQueue.isEmpty();
     mInboundQueue.enqueueAtTail(entry);
     traceInboundQueueLengthLocked();
+    recordEventStageLocked(entry->sequenceNum, now(), 0);
 
     switch (entry->type) {
     case EventEntry::TYPE_KEY: {
@@ -500,6 +514,50 @@ bool InputDispatcher::enqueueInboundEventLocked(EventEntry* entry) {
     return needWake;
 }
 
+bool InputDispatcher::tryCoalesceCursorMoveLocked(MotionEntry* entry) {
+    // Only pure relative mouse moves: a single mouse pointer, no button or state transition
+    // riding along.  Anything else must keep its own slot in the queue.
+    if (!(entry->source & AINPUT_SOURCE_MOUSE) || entry->pointerCount != 1
+            || (entry->action != AMOTION_EVENT_ACTION_HOVER_MOVE
+                    && entry->action != AMOTION_EVENT_ACTION_MOVE)
+            || entry->isInjected() || (entry->policyFlags & POLICY_FLAG_INJECTED)) {
+        // Note that intermediate entries of an injected chain carry POLICY_FLAG_INJECTED but
+        // no injectionState, so the flag check is load-bearing, not belt-and-braces.
+        return false;
+    }
+
+    EventEntry* tailEntry = mInboundQueue.tail;
+    if (tailEntry == nullptr || tailEntry->type != EventEntry::TYPE_MOTION
+            || tailEntry->refCount != 1 || tailEntry->dispatchInProgress
+            || tailEntry->isInjected()) {
+        return false;
+    }
+
+    MotionEntry* tail = static_cast<MotionEntry*>(tailEntry);
+    if (tail->deviceId != entry->deviceId || tail->source != entry->source
+            || tail->displayId != entry->displayId || tail->action != entry->action
+            || tail->policyFlags != entry->policyFlags || tail->flags != entry->flags
+            || tail->metaState != entry->metaState || tail->buttonState != entry->buttonState
+            || tail->classification != entry->classification
+            || tail->pointerCount != entry->pointerCount
+            || tail->pointerProperties[0] != entry->pointerProperties[0]) {
+        return false;
+    }
+
+    // Keep the freshest absolute position and timestamp, accumulate the relative motion the
+    // two samples carried so velocity tracking still integrates the full distance travelled.
+    const float relativeX = tail->pointerCoords[0].getAxisValue(AMOTION_EVENT_AXIS_RELATIVE_X)
+            + entry->pointerCoords[0].getAxisValue(AMOTION_EVENT_AXIS_RELATIVE_X);
+    const float relativeY = tail->pointerCoords[0].getAxisValue(AMOTION_EVENT_AXIS_RELATIVE_Y)
+            + entry->pointerCoords[0].getAxisValue(AMOTION_EVENT_AXIS_RELATIVE_Y);
+    tail->pointerCoords[0].copyFrom(entry->pointerCoords[0]);
+    tail->pointerCoords[0].setAxisValue(AMOTION_EVENT_AXIS_RELATIVE_X, relativeX);
+    tail->pointerCoords[0].setAxisValue(AMOTION_EVENT_AXIS_RELATIVE_Y, relativeY);
+    tail->eventTime = entry->eventTime;
+    tail->EventEntry::eventTime = entry->eventTime; // MotionEntry shadows the base field
+    return true;
+}
+
 void InputDispatcher::addRecentEventLocked(EventEntry* entry) {
     entry->refCount += 1;
     mRecentQueue.enqueueAtTail(entry);
@@ -2173,6 +2231,14 @@ void InputDispatcher::startDispatchCycleLocked(nsecs_t currentTime,
             connection->getInputChannelName().c_str());
 #endif
 
+    // Cork the channel while draining the outbound queue: consecutive
+    // publishable events leave in a single datagram (the consumer's
+    // InputChannel splits them, and its existing batching merges
+    // consecutive motion samples into one MotionEvent), so a burst of
+    // high-rate touch samples costs one syscall and one wakeup instead of
+    // one per sample.
+    connection->inputChannel->startMessageBatch();
+
     while (connection->status == Connection::STATUS_NORMAL
             && !connection->outboundQueue.isEmpty()) {
         DispatchEntry* dispatchEntry = connection->outboundQueue.head;
@@ -2245,6 +2311,7 @@ void InputDispatcher::startDispatchCycleLocked(nsecs_t currentTime,
 
         default:
             ALOG_ASSERT(false);
+            connection->inputChannel->flushMessageBatch();
             return;
         }
 
@@ -2273,6 +2340,9 @@ void InputDispatcher::startDispatchCycleLocked(nsecs_t currentTime,
                         "status=%d", connection->getInputChannelName().c_str(), status);
                 abortBrokenDispatchCycleLocked(currentTime, connection, true /*notify*/);
             }
+            // Entries already staged stay in the channel's batch buffer and
+            // are retried by the next flush.
+            connection->inputChannel->flushMessageBatch();
             return;
         }
 
@@ -2281,6 +2351,20 @@ void InputDispatcher::startDispatchCycleLocked(nsecs_t currentTime,
         traceOutboundQueueLength(connection);
         connection->waitQueue.enqueueAtTail(dispatchEntry);
         traceWaitQueueLength(connection);
+        recordEventStageLocked(dispatchEntry->eventEntry->sequenceNum,
+                dispatchEntry->deliveryTime, 1);
+    }
+
+    const status_t flushStatus = connection->inputChannel->flushMessageBatch();
+    if (flushStatus == WOULD_BLOCK) {
+        // The socket is full: the staged entries are already on the wait
+        // queue and their bytes are retained in the channel; they go out
+        // with the flush that follows the app's next finished signal.
+        connection->inputPublisherBlocked = true;
+    } else if (flushStatus != OK && connection->status == Connection::STATUS_NORMAL) {
+        ALOGE("channel '%s' ~ Could not flush batched events, status=%d",
+                connection->getInputChannelName().c_str(), flushStatus);
+        abortBrokenDispatchCycleLocked(currentTime, connection, true /*notify*/);
     }
 }
 
@@ -3584,12 +3668,72 @@ void InputDispatcher::logDispatchStateLocked() {
     }
 }
 
+void InputDispatcher::recordEventStageLocked(uint32_t seq, nsecs_t when, int stage) {
+    EventTimeline& timeline = mEventTimelines[seq % kEventTimelineRingSize];
+    if (stage == 0) {
+        timeline.seq = seq;
+        timeline.enqueueTime = when;
+        timeline.publishTime = 0;
+        timeline.finishTime = 0;
+        return;
+    }
+    if (timeline.seq != seq) {
+        return; // slot was recycled for a newer event
+    }
+    if (stage == 1) {
+        // an event can be published to several connections; keep the first
+        if (timeline.publishTime == 0) {
+            timeline.publishTime = when;
+        }
+    } else {
+        if (timeline.finishTime == 0) {
+            timeline.finishTime = when;
+        }
+    }
+}
+
+static void dumpLatencyPercentiles(std::string& dump, const char* name,
+        std::vector<nsecs_t>& values) {
+    if (values.empty()) {
+        return;
+    }
+    std::sort(values.begin(), values.end());
+    const nsecs_t p50 = values[values.size() / 2];
+    const nsecs_t p95 = values[(values.size() * 95) / 100];
+    const nsecs_t p99 = values[(values.size() * 99) / 100];
+    dump += StringPrintf(INDENT2 "%s: %zu events, p50 %.2fms, p95 %.2fms, p99 %.2fms\n",
+            name, values.size(), p50 / 1e6, p95 / 1e6, p99 / 1e6);
+}
+
+void InputDispatcher::dumpEventLatencyLocked(std::string& dump) {
+    std::vector<nsecs_t> enqueueToPublish;
+    std::vector<nsecs_t> publishToFinish;
+    for (const EventTimeline& timeline : mEventTimelines) {
+        if (timeline.enqueueTime == 0) continue;
+        if (timeline.publishTime != 0) {
+            enqueueToPublish.push_back(timeline.publishTime - timeline.enqueueTime);
+            if (timeline.finishTime != 0) {
+                publishToFinish.push_back(timeline.finishTime - timeline.publishTime);
+            }
+        }
+    }
+    if (enqueueToPublish.empty()) {
+        return;
+    }
+    dump += StringPrintf(INDENT "EventLatency (last %zu dispatched events):\n",
+            enqueueToPublish.size());
+    dumpLatencyPercentiles(dump, "enqueue -> publish", enqueueToPublish);
+    dumpLatencyPercentiles(dump, "publish -> finish", publishToFinish);
+}
+
 void InputDispatcher::dumpDispatchStateLocked(std::string& dump) {
     dump += StringPrintf(INDENT "DispatchEnabled: %s\n", toString(mDispatchEnabled));
     dump += StringPrintf(INDENT "DispatchFrozen: %s\n", toString(mDispatchFrozen));
     dump += StringPrintf(INDENT "InputFilterEnabled: %s\n", toString(mInputFilterEnabled));
     dump += StringPrintf(INDENT "FocusedDisplayId: %" PRId32 "\n", mFocusedDisplayId);
 
+    dumpEventLatencyLocked(dump);
+
     if (!mFocusedApplicationHandlesByDisplay.empty()) {
         dump += StringPrintf(INDENT "FocusedApplications:\n");
         for (auto& it : mFocusedApplicationHandlesByDisplay) {
@@ -4198,6 +4342,7 @@ void InputDispatcher::doDispatchCycleFinishedLockedInterruptible(
     // Handle post-event policy actions.
     DispatchEntry* dispatchEntry = connection->findWaitQueueEntry(seq);
     if (dispatchEntry) {
+        recordEventStageLocked(dispatchEntry->eventEntry->sequenceNum, finishTime, 2);
         nsecs_t eventDuration = finishTime - dispatchEntry->deliveryTime;
         if (eventDuration > SLOW_EVENT_PROCESSING_WARNING_TIMEOUT) {
             std::string msg =
@@ -17,6 +17,7 @@
 #ifndef _UI_INPUT_DISPATCHER_H
 #define _UI_INPUT_DISPATCHER_H
 
+#include <array>
 #include <condition_variable>
 #include <input/Input.h>
 #include <input/InputApplication.h>
@@ -934,6 +935,30 @@ private:
     // Enqueues an inbound event.  Returns true if mLooper->wake() should be called.
     bool enqueueInboundEventLocked(EventEntry* entry) REQUIRES(mLock);
 
+    // Compact per-event dispatch timeline ring for latency analytics.  All
+    // three stages are recorded under mLock on the paths that already hold
+    // it, keyed by the event's sequence number; dumpsys summarizes
+    // enqueue->publish and publish->finish percentiles over the ring, so
+    // production devices can report input pipeline latency without a
+    // debug build.
+    static constexpr size_t kEventTimelineRingSize = 256;
+    struct EventTimeline {
+        uint32_t seq = 0;
+        nsecs_t enqueueTime = 0;
+        nsecs_t publishTime = 0;
+        nsecs_t finishTime = 0;
+    };
+    std::array<EventTimeline, kEventTimelineRingSize> mEventTimelines GUARDED_BY(mLock);
+    void recordEventStageLocked(uint32_t seq, nsecs_t when, int stage) REQUIRES(mLock);
+    void dumpEventLatencyLocked(std::string& dump) REQUIRES(mLock);
+
+    // Cursor move coalescing, an opt-in latency optimization for pointer devices
+    // (debug.input.coalesce_cursor_moves).  When the inbound queue already ends with an
+    // undelivered move from the same mouse, fold the new sample into it so a backlogged
+    // app consumes the freshest pointer position instead of draining stale ones.
+    bool tryCoalesceCursorMoveLocked(MotionEntry* entry) REQUIRES(mLock);
+    const bool mCoalesceCursorMoves;
+
     // Cleans up input state when dropping an inbound event.
     void dropInboundEventLocked(EventEntry* entry, DropReason dropReason) REQUIRES(mLock);
 
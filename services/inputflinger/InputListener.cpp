@@ -20,6 +20,8 @@
 
 #include "InputListener.h"
 
+#include <algorithm>
+
 #include <android/log.h>
 
 namespace android {
@@ -229,33 +231,50 @@ QueuedInputListener::~QueuedInputListener() {
 
 void QueuedInputListener::notifyConfigurationChanged(
         const NotifyConfigurationChangedArgs* args) {
+    std::lock_guard<std::mutex> lock(mLock);
     mArgsQueue.push_back(new NotifyConfigurationChangedArgs(*args));
 }
 
 void QueuedInputListener::notifyKey(const NotifyKeyArgs* args) {
+    std::lock_guard<std::mutex> lock(mLock);
     mArgsQueue.push_back(new NotifyKeyArgs(*args));
 }
 
 void QueuedInputListener::notifyMotion(const NotifyMotionArgs* args) {
+    std::lock_guard<std::mutex> lock(mLock);
     mArgsQueue.push_back(new NotifyMotionArgs(*args));
 }
 
 void QueuedInputListener::notifySwitch(const NotifySwitchArgs* args) {
+    std::lock_guard<std::mutex> lock(mLock);
     mArgsQueue.push_back(new NotifySwitchArgs(*args));
 }
 
 void QueuedInputListener::notifyDeviceReset(const NotifyDeviceResetArgs* args) {
+    std::lock_guard<std::mutex> lock(mLock);
     mArgsQueue.push_back(new NotifyDeviceResetArgs(*args));
 }
 
 void QueuedInputListener::flush() {
-    size_t count = mArgsQueue.size();
+    std::vector<NotifyArgs*> argsQueue;
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        argsQueue.swap(mArgsQueue);
+    }
+    size_t count = argsQueue.size();
     for (size_t i = 0; i < count; i++) {
-        NotifyArgs* args = mArgsQueue[i];
+        NotifyArgs* args = argsQueue[i];
         args->notify(mInnerListener);
         delete args;
     }
-    mArgsQueue.clear();
+}
+
+void QueuedInputListener::stableSortByEventTime() {
+    std::lock_guard<std::mutex> lock(mLock);
+    std::stable_sort(mArgsQueue.begin(), mArgsQueue.end(),
+                     [](const NotifyArgs* lhs, const NotifyArgs* rhs) {
+                         return lhs->eventTime < rhs->eventTime;
+                     });
 }
 
 
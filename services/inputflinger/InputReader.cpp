@@ -45,6 +45,7 @@
 #include "InputReader.h"
 
 #include <errno.h>
+#include <future>
 #include <inttypes.h>
 #include <limits.h>
 #include <math.h>
@@ -52,6 +53,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#include <cutils/properties.h>
 #include <log/log.h>
 
 #include <android-base/stringprintf.h>
@@ -279,6 +281,10 @@ InputReader::InputReader(const sp<EventHubInterface>& eventHub,
         mConfigurationChangesToRefresh(0) {
     mQueuedListener = new QueuedInputListener(listener);
 
+    char value[PROPERTY_VALUE_MAX];
+    property_get("debug.input.parallel_device_processing", value, "0");
+    mParallelDeviceProcessing = atoi(value);
+
     { // acquire lock
         AutoMutex _l(mLock);
 
@@ -358,6 +364,11 @@ void InputReader::loopOnce() {
 }
 
 void InputReader::processEventsLocked(const RawEvent* rawEvents, size_t count) {
+    if (mParallelDeviceProcessing) {
+        processEventsParallelLocked(rawEvents, count);
+        return;
+    }
+
     for (const RawEvent* rawEvent = rawEvents; count;) {
         int32_t type = rawEvent->type;
         size_t batchSize = 1;
@@ -395,6 +406,113 @@ void InputReader::processEventsLocked(const RawEvent* rawEvents, size_t count) {
     }
 }
 
+void InputReader::processEventsParallelLocked(const RawEvent* rawEvents, size_t count) {
+    // Partition the batch into per-device runs and cook independent
+    // devices' runs on concurrent workers.  Keyboards (they update the
+    // global meta state other mappers read), external styli (they push
+    // fused state into touch devices) and the synthetic device-change
+    // events act as serial barriers: pending workers are joined before
+    // such a run is processed on this thread.  Cross-device pointer fades
+    // remain safe because PointerController is internally synchronized.
+    // Afterwards the queued args are stable-sorted by event time, so
+    // cross-device ordering matches arrival while per-device ordering is
+    // preserved by construction.
+    struct Run {
+        InputDevice* device;
+        const RawEvent* events;
+        size_t count;
+    };
+    std::vector<Run> parallelRuns;
+    bool usedWorkers = false;
+
+    const auto flushParallelRuns = [&] {
+        if (parallelRuns.empty()) {
+            return;
+        }
+        if (parallelRuns.size() == 1) {
+            parallelRuns[0].device->process(parallelRuns[0].events, parallelRuns[0].count);
+        } else {
+            usedWorkers = true;
+            std::vector<std::future<void>> work;
+            work.reserve(parallelRuns.size());
+            for (const Run& run : parallelRuns) {
+                work.push_back(std::async(std::launch::async, [run] {
+                    run.device->process(run.events, run.count);
+                }));
+            }
+            for (auto& future : work) {
+                future.wait();
+            }
+        }
+        parallelRuns.clear();
+    };
+
+    for (const RawEvent* rawEvent = rawEvents; count;) {
+        int32_t type = rawEvent->type;
+        size_t batchSize = 1;
+        if (type < EventHubInterface::FIRST_SYNTHETIC_EVENT) {
+            int32_t deviceId = rawEvent->deviceId;
+            while (batchSize < count) {
+                if (rawEvent[batchSize].type >= EventHubInterface::FIRST_SYNTHETIC_EVENT
+                        || rawEvent[batchSize].deviceId != deviceId) {
+                    break;
+                }
+                batchSize += 1;
+            }
+
+            ssize_t deviceIndex = mDevices.indexOfKey(deviceId);
+            if (deviceIndex < 0) {
+                ALOGW("Discarding event for unknown deviceId %d.", deviceId);
+            } else {
+                InputDevice* device = mDevices.valueAt(deviceIndex);
+                if (!device->isIgnored()) {
+                    constexpr uint32_t kBarrierClasses =
+                            INPUT_DEVICE_CLASS_KEYBOARD | INPUT_DEVICE_CLASS_EXTERNAL_STYLUS;
+                    if (device->getClasses() & kBarrierClasses) {
+                        flushParallelRuns();
+                        device->process(rawEvent, batchSize);
+                    } else {
+                        // A device can appear at most once per group: a new
+                        // run for it after an interleaving device means its
+                        // previous run is already pending; keep order by
+                        // flushing first.
+                        for (const Run& run : parallelRuns) {
+                            if (run.device == device) {
+                                flushParallelRuns();
+                                break;
+                            }
+                        }
+                        parallelRuns.push_back({device, rawEvent, batchSize});
+                    }
+                }
+            }
+        } else {
+            flushParallelRuns();
+            switch (rawEvent->type) {
+            case EventHubInterface::DEVICE_ADDED:
+                addDeviceLocked(rawEvent->when, rawEvent->deviceId);
+                break;
+            case EventHubInterface::DEVICE_REMOVED:
+                removeDeviceLocked(rawEvent->when, rawEvent->deviceId);
+                break;
+            case EventHubInterface::FINISHED_DEVICE_SCAN:
+                handleConfigurationChangedLocked(rawEvent->when);
+                break;
+            default:
+                ALOG_ASSERT(false); // can't happen
+                break;
+            }
+        }
+        count -= batchSize;
+        rawEvent += batchSize;
+    }
+    flushParallelRuns();
+
+    if (usedWorkers) {
+        mQueuedListener->stableSortByEventTime();
+    }
+}
+
 void InputReader::addDeviceLocked(nsecs_t when, int32_t deviceId) {
     ssize_t deviceIndex = mDevices.indexOfKey(deviceId);
     if (deviceIndex >= 0) {
@@ -644,6 +762,8 @@ void InputReader::fadePointerLocked() {
 }
 
 void InputReader::requestTimeoutAtTimeLocked(nsecs_t when) {
+    // Timeout requests can arrive from parallel device workers.
+    std::lock_guard<std::mutex> lock(mNextTimeoutLock);
     if (when < mNextTimeout) {
         mNextTimeout = when;
         mEventHub->wake();
@@ -22,6 +22,9 @@
 #include "InputListener.h"
 #include "InputReaderBase.h"
 
+#include <atomic>
+#include <mutex>
+
 #include <input/DisplayViewport.h>
 #include <input/Input.h>
 #include <input/VelocityControl.h>
@@ -187,17 +190,30 @@ private:
 
     InputReaderConfiguration mConfig;
 
-    // used by InputReaderContext::getNextSequenceNum() as a counter for event sequence numbers
-    uint32_t mNextSequenceNum;
-
-    // The event queue.
-    static const int EVENT_BUFFER_SIZE = 256;
+    // used by InputReaderContext::getNextSequenceNum() as a counter for event sequence numbers;
+    // atomic because parallel per-device processing draws numbers concurrently
+    std::atomic<uint32_t> mNextSequenceNum;
+
+    // The event queue.  Sized so one getEvents() drains a full interval of
+    // a high-rate device (an 8kHz mouse emits ~4 events per report, so 256
+    // entries turned over a dozen times per frame, multiplying read() and
+    // epoll round trips); events are written by EventHub directly into
+    // this buffer and consumed in place, so the larger batch adds no
+    // copies.
+    static const int EVENT_BUFFER_SIZE = 2048;
     RawEvent mEventBuffer[EVENT_BUFFER_SIZE];
 
+    // When enabled (debug.input.parallel_device_processing), per-device
+    // runs within a batch are cooked by concurrent workers; keyboards,
+    // external styli and device changes act as serial barriers.  See
+    // processEventsParallelLocked().
+    bool mParallelDeviceProcessing;
+
     KeyedVector<int32_t, InputDevice*> mDevices;
 
     // low-level input event decoding and device management
     void processEventsLocked(const RawEvent* rawEvents, size_t count);
+    void processEventsParallelLocked(const RawEvent* rawEvents, size_t count);
 
     void addDeviceLocked(nsecs_t when, int32_t deviceId);
     void removeDeviceLocked(nsecs_t when, int32_t deviceId);
@@ -216,17 +232,19 @@ private:
 
     void fadePointerLocked();
 
-    int32_t mGeneration;
+    std::atomic<int32_t> mGeneration;
     int32_t bumpGenerationLocked();
 
     void getInputDevicesLocked(std::vector<InputDeviceInfo>& outInputDevices);
 
-    nsecs_t mDisableVirtualKeysTimeout;
+    std::atomic<nsecs_t> mDisableVirtualKeysTimeout;
     void disableVirtualKeysUntilLocked(nsecs_t time);
     bool shouldDropVirtualKeyLocked(nsecs_t now,
             InputDevice* device, int32_t keyCode, int32_t scanCode);
 
     nsecs_t mNextTimeout;
+    // serializes timeout requests arriving from parallel device workers
+    std::mutex mNextTimeoutLock;
     void requestTimeoutAtTimeLocked(nsecs_t when);
 
     uint32_t mConfigurationChangesToRefresh;
@@ -17,6 +17,7 @@
 #ifndef _UI_INPUT_LISTENER_H
 #define _UI_INPUT_LISTENER_H
 
+#include <mutex>
 #include <vector>
 
 #include <input/Input.h>
@@ -219,8 +220,17 @@ public:
 
     void flush();
 
+    // Stable-sorts the queued args by event time.  Used after parallel
+    // per-device mapper processing so cross-device ordering matches
+    // arrival order; per-device order is already preserved because each
+    // device is processed by a single worker.
+    void stableSortByEventTime();
+
 private:
     sp<InputListenerInterface> mInnerListener;
+    // Guards mArgsQueue: the queue is filled concurrently when per-device
+    // parallel processing is enabled.  Uncontended in the serial case.
+    std::mutex mLock;
     std::vector<NotifyArgs*> mArgsQueue;
 };
 
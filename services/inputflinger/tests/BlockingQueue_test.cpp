@@ -93,6 +93,26 @@ TEST(BlockingQueueTest, Queue_Erases) {
     ASSERT_EQ(3, queue.pop());
 }
 
+/**
+ * popAll drains the entire queue in FIFO order, and the queue is usable afterwards.
+ */
+TEST(BlockingQueueTest, Queue_PopAllDrains) {
+    constexpr size_t capacity = 4;
+    BlockingQueue<int> queue(capacity);
+
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+    std::vector<int> all = queue.popAll();
+    ASSERT_EQ(all, (std::vector<int>{1, 2, 3}));
+    // Capacity is restored after the drain
+    for (size_t i = 0; i < capacity; i++) {
+        ASSERT_TRUE(queue.push(static_cast<int>(i)));
+    }
+    ASSERT_FALSE(queue.push(5));
+    ASSERT_EQ(queue.popAll(), (std::vector<int>{0, 1, 2, 3}));
+}
+
 // --- BlockingQueueTest - Multiple threads ---
 
 TEST(BlockingQueueTest, Queue_AllowsMultipleThreads) {
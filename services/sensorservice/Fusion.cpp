@@ -170,6 +170,10 @@ public:
     }
 };
 
+// Upper bound on the number of gyro samples whose covariance propagation
+// may be deferred; at 500Hz this spans a few milliseconds.
+static const size_t kMaxDeferredPredicts = 16;
+
 // -----------------------------------------------------------------------
 
 Fusion::Fusion() {
@@ -197,6 +201,9 @@ Fusion::Fusion() {
 void Fusion::init(int mode) {
     mInitState = 0;
 
+    mPredictDeferred = false;
+    mDeferredCount = 0;
+
     mGyroRate = 0;
 
     mCount[0] = 0;
@@ -491,12 +498,40 @@ void Fusion::predict(const vec3_t& w, float dT) {
     if (x0.w < 0)
         x0 = -x0;
 
-    P = Phi*P*transpose(Phi) + GQGt;
+    // Defer the expensive P propagation: compose this sample's transition
+    // into the accumulator instead.  Phi is block-triangular
+    // ([A B; 0 I]), so composition is [Ak B k; 0 I]*[A B; 0 I] =
+    // [Ak*A Ak*B+Bk; 0 I] -- two 3x3 products against the eight a full
+    // propagation costs per sample at gyro rate.
+    if (!mPredictDeferred) {
+        mPhiAcc = Phi;
+        mQAcc = GQGt;
+        mPredictDeferred = true;
+    } else {
+        mPhiAcc[1][0] = Phi[0][0]*mPhiAcc[1][0] + Phi[1][0];
+        mPhiAcc[0][0] = Phi[0][0]*mPhiAcc[0][0];
+        mQAcc = mQAcc + GQGt;
+    }
+    if (++mDeferredCount >= kMaxDeferredPredicts) {
+        propagateDeferredCovariance();
+    }
 
     checkState();
 }
 
+void Fusion::propagateDeferredCovariance() {
+    if (!mPredictDeferred) {
+        return;
+    }
+    P = mPhiAcc*P*transpose(mPhiAcc) + mQAcc;
+    mPredictDeferred = false;
+    mDeferredCount = 0;
+}
+
 void Fusion::update(const vec3_t& z, const vec3_t& Bi, float sigma) {
+    // The measurement update needs the current covariance.
+    propagateDeferredCovariance();
+
     vec4_t q(x0);
     // measured vector in body space: h(p) = A(p)*Bi
     const mat33_t A(quatToMatrix(q));
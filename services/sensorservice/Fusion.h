@@ -98,6 +98,22 @@ private:
     void checkState();
     void predict(const vec3_t& w, float dT);
     void update(const vec3_t& z, const vec3_t& Bi, float sigma);
+
+    /*
+     * Deferred covariance propagation: predict() composes each sample's
+     * transition into mPhiAcc (two 3x3 products, exploiting Phi's
+     * block-triangular structure) and accumulates process noise into
+     * mQAcc; the full P = Phi P Phi' + Q propagation then runs once per
+     * measurement update (or when the deferral window fills) instead of
+     * once per gyro sample.  Noise transport inside a window is
+     * approximated by plain accumulation, an O(|w| dT) relative error
+     * over the few milliseconds a window spans.
+     */
+    void propagateDeferredCovariance();
+    bool mPredictDeferred;
+    size_t mDeferredCount;
+    mat<mat33_t, 2, 2> mPhiAcc;
+    mat<mat33_t, 2, 2> mQAcc;
     static mat34_t getF(const vec4_t& p);
     static vec3_t getOrthogonal(const vec3_t &v);
 };
@@ -20,6 +20,7 @@
 #include <utils/Timers.h>
 
 #include <inttypes.h>
+#include <vector>
 
 namespace android {
 namespace SensorServiceUtil {
@@ -53,22 +54,34 @@ void RecentEventLogger::setLastEventStale() {
 }
 
 std::string RecentEventLogger::dump() const {
-    std::lock_guard<std::mutex> lk(mLock);
+    // Snapshot the ring under the lock, then format outside of it.  The copy is a few KB at
+    // most; the localtime/appendFormat work below is what used to stall addEvent() -- and with
+    // it event delivery for this sensor -- while a dumpsys was in flight.
+    std::vector<SensorEventLog> events;
+    bool maskData;
+    {
+        std::lock_guard<std::mutex> lk(mLock);
+        events.reserve(mRecentEvents.size());
+        for (size_t i = 0; i < mRecentEvents.size(); ++i) {
+            events.push_back(mRecentEvents[i]);
+        }
+        maskData = mMaskData;
+    }
 
     //TODO: replace String8 with std::string completely in this function
     String8 buffer;
 
-    buffer.appendFormat("last %zu events\n", mRecentEvents.size());
+    buffer.appendFormat("last %zu events\n", events.size());
     int j = 0;
-    for (int i = mRecentEvents.size() - 1; i >= 0; --i) {
-        const auto& ev = mRecentEvents[i];
+    for (int i = events.size() - 1; i >= 0; --i) {
+        const auto& ev = events[i];
         struct tm * timeinfo = localtime(&(ev.mWallTime.tv_sec));
         buffer.appendFormat("\t%2d (ts=%.9f, wall=%02d:%02d:%02d.%03d) ",
                 ++j, ev.mEvent.timestamp/1e9, timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec,
                 (int) ns2ms(ev.mWallTime.tv_nsec));
 
         // data
-        if (!mMaskData) {
+        if (!maskData) {
             if (mSensorType == SENSOR_TYPE_STEP_COUNTER) {
                 buffer.appendFormat("%" PRIu64 ", ", ev.mEvent.u64.step_counter);
             } else {
@@ -363,6 +363,16 @@ std::string SensorDevice::dump() const {
     result.appendFormat("Total %zu h/w sensors, %zu running:\n",
                         mSensorList.size(), mActivationCount.size());
 
+    const uint64_t wakeups = mPollWakeups.load(std::memory_order_relaxed);
+    const nsecs_t statsStart = mPollStatsStartNs.load(std::memory_order_relaxed);
+    if (wakeups > 0 && statsStart > 0) {
+        const double seconds = (systemTime() - statsStart) / 1e9;
+        const uint64_t events = mPollEvents.load(std::memory_order_relaxed);
+        result.appendFormat("HAL poll wakeups: %" PRIu64 " (%.1f/s), avg batch %.1f events\n",
+                            wakeups, seconds > 0 ? wakeups / seconds : 0.0,
+                            wakeups > 0 ? double(events) / wakeups : 0.0);
+    }
+
     Mutex::Autolock _l(mLock);
     for (const auto & s : mSensorList) {
         int32_t handle = s.handle;
@@ -413,6 +423,13 @@ ssize_t SensorDevice::poll(sensors_event_t* buffer, size_t count) {
         ALOGE("Must support polling or FMQ");
         eventsRead = -1;
     }
+    if (eventsRead > 0) {
+        if (mPollStatsStartNs.load(std::memory_order_relaxed) == 0) {
+            mPollStatsStartNs.store(systemTime(), std::memory_order_relaxed);
+        }
+        mPollWakeups.fetch_add(1, std::memory_order_relaxed);
+        mPollEvents.fetch_add(static_cast<uint64_t>(eventsRead), std::memory_order_relaxed);
+    }
     return eventsRead;
 }
 
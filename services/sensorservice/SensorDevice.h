@@ -18,6 +18,7 @@
 #define ANDROID_SENSOR_DEVICE_H
 
 #include "SensorDeviceUtils.h"
+#include <atomic>
 #include "SensorServiceUtils.h"
 #include "SensorsWrapper.h"
 
@@ -186,6 +187,13 @@ private:
     SensorServiceUtil::RingBuffer<HidlTransportErrorLog> mHidlTransportErrors;
     int mTotalHidlTransportErrors;
 
+    // HAL wakeup accounting for dump(): how many poll() returns woke us and
+    // how many events they carried, so batching regressions (many wakeups,
+    // small batches) are visible in dumpsys sensorservice.
+    std::atomic<uint64_t> mPollWakeups { 0 };
+    std::atomic<uint64_t> mPollEvents { 0 };
+    std::atomic<nsecs_t> mPollStatsStartNs { 0 };
+
     // Use this vector to determine which client is activated or deactivated.
     SortedVector<void *> mDisabledClients;
     SensorDevice();
@@ -57,8 +57,10 @@ void SensorService::SensorDirectConnection::onFirstRef() {
 
 void SensorService::SensorDirectConnection::dump(String8& result) const {
     Mutex::Autolock _l(mConnectionLock);
-    result.appendFormat("\tPackage %s, HAL channel handle %d, total sensor activated %zu\n",
-            String8(mOpPackageName).string(), getHalChannelHandle(), mActivated.size());
+    result.appendFormat("\tPackage %s, HAL channel handle %d, mem type %d format %d size %zu, "
+            "total sensor activated %zu\n",
+            String8(mOpPackageName).string(), getHalChannelHandle(),
+            mMem.type, mMem.format, mMem.size, mActivated.size());
     for (auto &i : mActivated) {
         result.appendFormat("\t\tSensor %#08x, rate %d\n", i.first, i.second);
     }
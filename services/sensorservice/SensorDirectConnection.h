@@ -34,6 +34,14 @@ namespace android {
 class SensorService;
 class BitTube;
 
+// A direct report channel.  The service only brokers configuration here: the
+// HAL owns the write path and deposits events for every configured sensor into
+// the one shared memory ring described by mMem, interleaved in arrival order
+// and stamped with the single monotonic atomic counter the direct report
+// format defines.  Consumers fusing several sensors therefore read one layout,
+// not one ring per sensor.  Rate control is likewise HAL-side: the per-sensor
+// rate level passed to configureChannel() is the only decimation knob, since
+// no event ever passes through sensorservice on this path.
 class SensorService::SensorDirectConnection: public BnSensorEventConnection {
 public:
     SensorDirectConnection(const sp<SensorService>& service, uid_t uid,
@@ -226,6 +226,22 @@ void SensorService::SensorEventConnection::incrementPendingFlushCount(int32_t ha
     }
 }
 
+bool SensorService::SensorEventConnection::needsAnyEvents(const int32_t* handles,
+                                                          size_t numHandles) {
+    Mutex::Autolock _l(mConnectionLock);
+    for (size_t i = 0; i < mSensorInfo.size(); i++) {
+        if (mSensorInfo.valueAt(i).mPendingFlushEventsToSend > 0) {
+            return true;
+        }
+    }
+    for (size_t i = 0; i < numHandles; i++) {
+        if (mSensorInfo.indexOfKey(handles[i]) >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 status_t SensorService::SensorEventConnection::sendEvents(
         sensors_event_t const* buffer, size_t numEvents,
         sensors_event_t* scratch,
@@ -82,6 +82,12 @@ private:
     virtual void destroy();
 
     // Count the number of flush complete events which are about to be dropped in the buffer.
+    // Returns true if any of the given sensor handles is registered on this
+    // connection, or if any registered sensor has pending flush-complete
+    // events to deliver; lets the sensor thread skip the full per-connection
+    // demux for polls carrying nothing this connection wants.
+    bool needsAnyEvents(const int32_t* handles, size_t numHandles);
+
     // Increment mPendingFlushEventsToSend in mSensorInfo. These flush complete events will be sent
     // separately before the next batch of events.
     void countFlushCompleteEventsLocked(sensors_event_t const* scratch, int numEventsDropped);
@@ -859,12 +859,43 @@ bool SensorService::threadLoop() {
             }
         }
 
+        // Collect the distinct sensors present in this poll so connections
+        // with no interest in any of them (and no pending flush events)
+        // skip the full demux scan; with many subscribed apps most of them
+        // care about none of a given burst.
+        constexpr size_t kMaxBatchHandles = 16;
+        int32_t batchHandles[kMaxBatchHandles];
+        size_t numBatchHandles = 0;
+        bool batchHandlesValid = true;
+        for (ssize_t i = 0; i < count && batchHandlesValid; i++) {
+            int32_t handle = mSensorEventBuffer[i].sensor;
+            if (mSensorEventBuffer[i].type == SENSOR_TYPE_META_DATA) {
+                handle = mSensorEventBuffer[i].meta_data.sensor;
+            }
+            bool seen = false;
+            for (size_t j = 0; j < numBatchHandles; j++) {
+                if (batchHandles[j] == handle) {
+                    seen = true;
+                    break;
+                }
+            }
+            if (!seen) {
+                if (numBatchHandles == kMaxBatchHandles) {
+                    batchHandlesValid = false;
+                } else {
+                    batchHandles[numBatchHandles++] = handle;
+                }
+            }
+        }
+
         // Send our events to clients. Check the state of wake lock for each client and release the
         // lock if none of the clients need it.
         bool needsWakeLock = false;
         for (const sp<SensorEventConnection>& connection : activeConnections) {
-            connection->sendEvents(mSensorEventBuffer, count, mSensorEventScratch,
-                    mMapFlushEventsToConnections);
+            if (!batchHandlesValid || connection->needsAnyEvents(batchHandles, numBatchHandles)) {
+                connection->sendEvents(mSensorEventBuffer, count, mSensorEventScratch,
+                        mMapFlushEventsToConnections);
+            }
             needsWakeLock |= connection->needsWakeLock();
             // If the connection has one-shot sensors, it may be cleaned up after first trigger.
             // Early check for one-shot sensors.
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <Fusion.h>
+
+using namespace android;
+
+namespace {
+
+// Feeds the filter enough samples to leave the init phase.
+void warmUp(Fusion* fusion) {
+    const vec3_t acc(0.f, 0.f, 9.81f);
+    const vec3_t mag(0.f, 30.f, -20.f);
+    const vec3_t gyro(0.f, 0.f, 0.f);
+    for (int i = 0; i < 64; i++) {
+        fusion->handleAcc(acc, 0.01f);
+        fusion->handleMag(mag);
+        fusion->handleGyro(gyro, 0.002f);
+    }
+}
+
+} // namespace
+
+// The sensorservice steady state: a 500Hz gyro predict stream with a
+// 100Hz accelerometer update interleaved.
+static void BM_fusionGyroStream(benchmark::State& state) {
+    Fusion fusion;
+    fusion.init();
+    warmUp(&fusion);
+
+    const vec3_t gyro(0.02f, -0.01f, 0.005f);
+    const vec3_t acc(0.1f, -0.2f, 9.79f);
+    int sample = 0;
+    while (state.KeepRunning()) {
+        fusion.handleGyro(gyro, 0.002f);
+        if (++sample == 5) {
+            sample = 0;
+            fusion.handleAcc(acc, 0.01f);
+        }
+        benchmark::DoNotOptimize(fusion.getAttitude());
+    }
+}
+BENCHMARK(BM_fusionGyroStream);
+
+// Pure predict cost, no updates: the worst case for per-sample covariance
+// work.
+static void BM_fusionPredictOnly(benchmark::State& state) {
+    Fusion fusion;
+    fusion.init();
+    warmUp(&fusion);
+
+    const vec3_t gyro(0.02f, -0.01f, 0.005f);
+    while (state.KeepRunning()) {
+        fusion.handleGyro(gyro, 0.002f);
+    }
+    benchmark::DoNotOptimize(fusion.getAttitude());
+}
+BENCHMARK(BM_fusionPredictOnly);
+
+BENCHMARK_MAIN();
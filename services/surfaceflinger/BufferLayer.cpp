@@ -577,16 +577,9 @@ bool BufferLayer::isProtected() const {
 }
 
 bool BufferLayer::latchUnsignaledBuffers() {
-    static bool propertyLoaded = false;
-    static bool latch = false;
-    static std::mutex mutex;
-    std::lock_guard<std::mutex> lock(mutex);
-    if (!propertyLoaded) {
-        char value[PROPERTY_VALUE_MAX] = {};
-        property_get("debug.sf.latch_unsignaled", value, "0");
-        latch = atoi(value);
-        propertyLoaded = true;
-    }
+    // Checked for every layer on every latch; C++ static initialization
+    // already guarantees the one-time read, so don't take a mutex per call.
+    static const bool latch = property_get_bool("debug.sf.latch_unsignaled", false);
     return latch;
 }
 
@@ -506,6 +506,11 @@ void BufferLayerConsumer::addAndGetFrameTimestamps(const NewFrameEventsEntry* ne
     }
 }
 
+sp<IMemory> BufferLayerConsumer::getFrameTimestampsRing() {
+    sp<Layer> l = mLayer.promote();
+    return l.get() ? l->getFrameTimestampsRing() : nullptr;
+}
+
 void BufferLayerConsumer::abandonLocked() {
     BLC_LOGV("abandonLocked");
     mCurrentTextureBuffer = nullptr;
@@ -65,6 +65,10 @@ bool BufferQueueLayer::getTransformToDisplayInverse() const {
     return mConsumer->getTransformToDisplayInverse();
 }
 
+uint32_t BufferQueueLayer::getActiveBufferTransform() const {
+    return mConsumer != nullptr ? mConsumer->getCurrentTransform() : 0;
+}
+
 void BufferQueueLayer::releasePendingBuffer(nsecs_t dequeueReadyTime) {
     if (!mConsumer->releasePendingBuffer()) {
         return;
@@ -46,6 +46,8 @@ public:
 
     bool getTransformToDisplayInverse() const override;
 
+    uint32_t getActiveBufferTransform() const override;
+
     // If a buffer was replaced this frame, release the former buffer
     void releasePendingBuffer(nsecs_t dequeueReadyTime) override;
 
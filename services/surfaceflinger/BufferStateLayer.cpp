@@ -120,6 +120,10 @@ bool BufferStateLayer::getTransformToDisplayInverse() const {
     return mCurrentState.transformToDisplayInverse;
 }
 
+uint32_t BufferStateLayer::getActiveBufferTransform() const {
+    return getDrawingState().transform;
+}
+
 void BufferStateLayer::pushPendingState() {
     if (!mCurrentState.modified) {
         return;
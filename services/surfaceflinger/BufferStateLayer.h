@@ -48,6 +48,8 @@ public:
 
     bool getTransformToDisplayInverse() const override;
 
+    uint32_t getActiveBufferTransform() const override;
+
     uint32_t doTransactionResize(uint32_t flags, Layer::State* /*stateToCommit*/) override {
         return flags;
     }
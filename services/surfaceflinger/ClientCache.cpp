@@ -21,10 +21,14 @@
 
 #include <cinttypes>
 
+#include <android-base/stringprintf.h>
+
 #include "ClientCache.h"
 
 namespace android {
 
+using base::StringAppendF;
+
 ANDROID_SINGLETON_STATIC_INSTANCE(ClientCache);
 
 ClientCache::ClientCache() : mDeathRecipient(new CacheDeathRecipient) {}
@@ -98,10 +102,66 @@ bool ClientCache::add(const client_cache_t& cacheId, const sp<GraphicBuffer>& bu
         return false;
     }
 
-    processBuffers[id].buffer = buffer;
+    // Reuse an already-cached import of the same allocation, if any.
+    mTotalAdds++;
+    if (mTotalAdds % 256 == 0) {
+        // Amortized sweep: erase-time pruning misses an id whose last strong
+        // reference was held outside the cache at erase time.
+        for (auto it = mBuffersById.begin(); it != mBuffersById.end();) {
+            it = it->second.promote() == nullptr ? mBuffersById.erase(it) : std::next(it);
+        }
+    }
+    sp<GraphicBuffer> cached = buffer;
+    auto idIt = mBuffersById.find(buffer->getId());
+    if (idIt != mBuffersById.end()) {
+        sp<GraphicBuffer> existing = idIt->second.promote();
+        if (existing != nullptr) {
+            cached = existing;
+            mDedupHits++;
+        } else {
+            idIt->second = buffer;
+        }
+    } else {
+        mBuffersById.emplace(buffer->getId(), buffer);
+    }
+
+    processBuffers[id].buffer = cached;
     return true;
 }
 
+void ClientCache::dump(std::string& result) {
+    std::lock_guard lock(mMutex);
+
+    // Prune dead id entries while we're here.
+    size_t liveIds = 0;
+    for (auto idIt = mBuffersById.begin(); idIt != mBuffersById.end();) {
+        if (idIt->second.promote() == nullptr) {
+            idIt = mBuffersById.erase(idIt);
+        } else {
+            liveIds++;
+            idIt++;
+        }
+    }
+
+    size_t entries = 0;
+    for (const auto& [token, processBuffers] : mBuffers) {
+        entries += processBuffers.size();
+    }
+    StringAppendF(&result,
+                        "ClientCache: %zu entries over %zu processes, %zu distinct buffers; "
+                        "%" PRIu64 " adds, %" PRIu64 " shared an existing import\n",
+                        entries, mBuffers.size(), liveIds, mTotalAdds, mDedupHits);
+}
+
+void ClientCache::pruneBufferIdLocked(uint64_t bufferId) {
+    // Drop the dedup-index entry once no cache entry keeps the buffer alive;
+    // without this the id map grows forever on devices that never dump.
+    auto idIt = mBuffersById.find(bufferId);
+    if (idIt != mBuffersById.end() && idIt->second.promote() == nullptr) {
+        mBuffersById.erase(idIt);
+    }
+}
+
 void ClientCache::erase(const client_cache_t& cacheId) {
     auto& [processToken, id] = cacheId;
     std::vector<sp<ErasedRecipient>> pendingErase;
@@ -120,7 +180,14 @@ void ClientCache::erase(const client_cache_t& cacheId) {
             }
         }
 
+        const bool hadBuffer = buf->buffer != nullptr;
+        const uint64_t bufferId = hadBuffer ? buf->buffer->getId() : 0;
+        // erase() drops the cache's strong ref; buf points into the erased
+        // entry and must not be touched afterwards
         mBuffers[processToken].erase(id);
+        if (hadBuffer) {
+            pruneBufferIdLocked(bufferId);
+        }
     }
 
     for (auto& recipient : pendingErase) {
@@ -180,6 +247,8 @@ void ClientCache::removeProcess(const wp<IBinder>& processToken) {
             return;
         }
 
+        std::vector<uint64_t> bufferIds;
+        bufferIds.reserve(itr->second.size());
         for (auto& [id, clientCacheBuffer] : itr->second) {
             client_cache_t cacheId = {processToken, id};
             for (auto& recipient : clientCacheBuffer.recipients) {
@@ -188,8 +257,14 @@ void ClientCache::removeProcess(const wp<IBinder>& processToken) {
                     pendingErase.emplace_back(erasedRecipient, cacheId);
                 }
             }
+            if (clientCacheBuffer.buffer != nullptr) {
+                bufferIds.push_back(clientCacheBuffer.buffer->getId());
+            }
         }
         mBuffers.erase(itr);
+        for (uint64_t bufferId : bufferIds) {
+            pruneBufferIdLocked(bufferId);
+        }
     }
 
     for (auto& [recipient, cacheId] : pendingErase) {
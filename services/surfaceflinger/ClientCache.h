@@ -53,6 +53,8 @@ public:
     void unregisterErasedRecipient(const client_cache_t& cacheId,
                                    const wp<ErasedRecipient>& recipient);
 
+    void dump(std::string& result);
+
 private:
     std::mutex mMutex;
 
@@ -71,6 +73,19 @@ private:
 
     sp<CacheDeathRecipient> mDeathRecipient;
 
+    // Cross-client dedup: identical buffers pushed by several processes
+    // (wallpapers, decor) arrive as separate imports of the same
+    // allocation; the allocator-assigned buffer id identifies them, so
+    // every cache entry for that id shares one GraphicBuffer and the
+    // duplicate import is dropped immediately.  Entries are weak and
+    // pruned when dead.
+    std::unordered_map<uint64_t, wp<GraphicBuffer>> mBuffersById GUARDED_BY(mMutex);
+    void pruneBufferIdLocked(uint64_t bufferId) REQUIRES(mMutex);
+
+    // statistics surfaced in dumpsys SurfaceFlinger
+    uint64_t mTotalAdds GUARDED_BY(mMutex) = 0;
+    uint64_t mDedupHits GUARDED_BY(mMutex) = 0;
+
     bool getBuffer(const client_cache_t& cacheId, ClientCacheBuffer** outClientCacheBuffer)
             REQUIRES(mMutex);
 };
@@ -18,6 +18,9 @@
 #define LOG_TAG "HwcComposer"
 
 #include <inttypes.h>
+
+#include <android-base/stringprintf.h>
+#include <cutils/properties.h>
 #include <log/log.h>
 
 #include "ComposerHal.h"
@@ -161,10 +164,25 @@ void Composer::CommandWriter::writeBufferMetadata(
     write64(metadata.usage);
 }
 
+uint32_t Composer::writerInitialSize()
+{
+    // The writer pre-allocates the shared-memory command queue; frames
+    // that outgrow it fall back to growing and copying mid-frame inside
+    // the HIDL support library.  Devices with many layers can pre-size it
+    // (debug.sf.hwc_command_buffer_kib) and validate the choice against
+    // the high-water mark reported in dumpsys.
+    int32_t sizeKib = property_get_int32("debug.sf.hwc_command_buffer_kib", 64);
+    if (sizeKib < 16) sizeKib = 16;
+    if (sizeKib > 1024) sizeKib = 1024;
+    // minus a small space for metadata such as read/write pointers
+    return static_cast<uint32_t>(sizeKib) * 1024 / sizeof(uint32_t) - 16;
+}
+
 Composer::Composer(const std::string& serviceName)
-    : mWriter(kWriterInitialSize),
+    : mWriter(writerInitialSize()),
       mIsUsingVrComposer(serviceName == std::string("vr"))
 {
+    mCommandQueueStats.writerCapacity = writerInitialSize();
     mComposer = V2_1::IComposer::getService(serviceName);
 
     if (mComposer == nullptr) {
@@ -221,8 +239,15 @@ std::vector<IComposer::Capability> Composer::getCapabilities()
 std::string Composer::dumpDebugInfo()
 {
     std::string info;
+
+    base::StringAppendF(&info,
+                        "Composer command queue: capacity %u words, high-water %u words, "
+                        "%" PRIu64 " executes, %" PRIu64 " queue renegotiations\n",
+                        mCommandQueueStats.writerCapacity, mCommandQueueStats.maxCommandLength,
+                        mCommandQueueStats.executeCalls, mCommandQueueStats.queueChanges);
+
     mComposer->dumpDebugInfo([&](const auto& tmpInfo) {
-        info = tmpInfo.c_str();
+        info += tmpInfo.c_str();
     });
 
     return info;
@@ -845,6 +870,18 @@ Error Composer::execute()
         return Error::NO_RESOURCES;
     }
 
+    mCommandQueueStats.executeCalls++;
+    if (queueChanged) {
+        mCommandQueueStats.queueChanges++;
+    }
+    if (commandLength > mCommandQueueStats.maxCommandLength) {
+        mCommandQueueStats.maxCommandLength = commandLength;
+        ALOGI_IF(commandLength > mCommandQueueStats.writerCapacity,
+                 "HWC command queue high-water %u words exceeds pre-sized capacity %u; consider "
+                 "raising debug.sf.hwc_command_buffer_kib",
+                 commandLength, mCommandQueueStats.writerCapacity);
+    }
+
     // set up new input command queue if necessary
     if (queueChanged) {
         auto ret = mClient->setInputCommandQueue(*mWriter.getMQDescriptor());
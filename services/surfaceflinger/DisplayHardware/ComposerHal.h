@@ -445,12 +445,22 @@ private:
     sp<V2_2::IComposerClient> mClient_2_2;
     sp<IComposerClient> mClient_2_3;
 
-    // 64KiB minus a small space for metadata such as read/write pointers
-    static constexpr size_t kWriterInitialSize =
-        64 * 1024 / sizeof(uint32_t) - 16;
+    // Initial command queue size in words; property-tunable, 64KiB
+    // equivalent by default.  See writerInitialSize().
+    static uint32_t writerInitialSize();
     CommandWriter mWriter;
     CommandReader mReader;
 
+    // Command queue statistics surfaced through dumpDebugInfo() so the
+    // pre-sized capacity can be validated against real frames.
+    struct CommandQueueStats {
+        uint64_t executeCalls = 0;
+        uint64_t queueChanges = 0;      // FMQ (re)negotiations with the HAL
+        uint32_t maxCommandLength = 0;  // high-water mark, in words
+        uint32_t writerCapacity = 0;    // initial capacity, in words
+    };
+    CommandQueueStats mCommandQueueStats;
+
     // When true, the we attach to the vr_hwcomposer service instead of the
     // hwcomposer. This allows us to redirect surfaces to 3d surfaces in vr.
     const bool mIsUsingVrComposer;
@@ -20,11 +20,13 @@
 #define LOG_TAG "FramebufferSurface"
 
 #include <errno.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <utils/String8.h>
+#include <utils/Timers.h>
 #include <log/log.h>
 
 #include <hardware/hardware.h>
@@ -135,6 +137,7 @@ status_t FramebufferSurface::nextBuffer(uint32_t& outSlot,
     mCurrentBufferSlot = item.mSlot;
     mCurrentBuffer = mSlots[mCurrentBufferSlot].mGraphicBuffer;
     mCurrentFence = item.mFence;
+    mLastAcquireTime = systemTime();
 
     outFence = item.mFence;
     mHwcBufferCache.getHwcBuffer(mCurrentBufferSlot, mCurrentBuffer, &outSlot, &outBuffer);
@@ -156,8 +159,31 @@ void FramebufferSurface::freeBufferLocked(int slotIndex) {
 }
 
 void FramebufferSurface::onFrameCommitted() {
+    sp<Fence> presentFence = mHwc.getPresentFence(mDisplayId);
+
+    // Fold in the latency of the frame before this one; by now its present
+    // fence has almost certainly signaled.
+    if (mPendingPresentFence != Fence::NO_FENCE) {
+        const nsecs_t signalTime = mPendingPresentFence->getSignalTime();
+        if (signalTime != Fence::SIGNAL_TIME_PENDING &&
+                signalTime != Fence::SIGNAL_TIME_INVALID &&
+                signalTime > mPendingAcquireTime) {
+            const nsecs_t latency = signalTime - mPendingAcquireTime;
+            if (mLatencyFrameCount == 0 || latency < mLatencyMin) mLatencyMin = latency;
+            if (latency > mLatencyMax) mLatencyMax = latency;
+            mLatencyTotal += latency;
+            mLatencyFrameCount++;
+        }
+        mPendingPresentFence = Fence::NO_FENCE;
+    }
+    if (mLastAcquireTime != 0 && presentFence->isValid()) {
+        mPendingPresentFence = presentFence;
+        mPendingAcquireTime = mLastAcquireTime;
+    }
+    mLastAcquireTime = 0;
+
     if (mHasPendingRelease) {
-        sp<Fence> fence = mHwc.getPresentFence(mDisplayId);
+        sp<Fence> fence = presentFence;
         if (fence->isValid()) {
             status_t result = addReleaseFence(mPreviousBufferSlot,
                     mPreviousBuffer, fence);
@@ -178,6 +204,13 @@ void FramebufferSurface::dumpAsString(String8& result) const {
     result.appendFormat("  FramebufferSurface: dataspace: %s(%d)\n",
                         dataspaceDetails(static_cast<android_dataspace>(mDataSpace)).c_str(),
                         mDataSpace);
+    if (mLatencyFrameCount > 0) {
+        result.appendFormat("  acquire->present latency over %" PRIu64 " frames: "
+                            "avg %.2f ms, min %.2f ms, max %.2f ms\n",
+                            mLatencyFrameCount,
+                            mLatencyTotal / (1e6 * mLatencyFrameCount),
+                            mLatencyMin / 1e6, mLatencyMax / 1e6);
+    }
     ConsumerBase::dumpLocked(result, "   ");
 }
 
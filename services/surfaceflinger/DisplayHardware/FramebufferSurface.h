@@ -94,6 +94,20 @@ private:
     bool mHasPendingRelease;
     int mPreviousBufferSlot;
     sp<GraphicBuffer> mPreviousBuffer;
+
+    // Acquire->present latency bookkeeping, reported in dumpAsString() so the
+    // buffer-depth/latency tradeoff of
+    // ro.surface_flinger.max_frame_buffer_acquired_buffers can be measured on
+    // a running device.  mLastAcquireTime is stamped when a new client target
+    // is latched; the pair below waits one frame for its present fence to
+    // signal before being folded into the stats.
+    nsecs_t mLastAcquireTime = 0;
+    nsecs_t mPendingAcquireTime = 0;
+    sp<Fence> mPendingPresentFence = Fence::NO_FENCE;
+    uint64_t mLatencyFrameCount = 0;
+    nsecs_t mLatencyTotal = 0;
+    nsecs_t mLatencyMin = 0;
+    nsecs_t mLatencyMax = 0;
 };
 
 // ---------------------------------------------------------------------------
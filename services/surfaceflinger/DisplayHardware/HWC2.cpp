@@ -804,6 +804,7 @@ Layer::Layer(android::Hwc2::Composer& composer, const std::unordered_set<Capabil
     mCapabilities(capabilities),
     mDisplayId(displayId),
     mId(layerId),
+    mHasSidebandStreamCapability(capabilities.count(Capability::SidebandStream) > 0),
     mColorMatrix(android::mat4())
 {
     ALOGV("Created layer %" PRIu64 " on display %" PRIu64, layerId, displayId);
@@ -870,24 +871,46 @@ Error Layer::setSurfaceDamage(const Region& damage)
 
 Error Layer::setBlendMode(BlendMode mode)
 {
+    if (mBlendMode == mode) {
+        return Error::None;
+    }
     auto intMode = static_cast<Hwc2::IComposerClient::BlendMode>(mode);
     auto intError = mComposer.setLayerBlendMode(mDisplayId, mId, intMode);
-    return static_cast<Error>(intError);
+    const auto error = static_cast<Error>(intError);
+    if (error == Error::None) {
+        mBlendMode = mode;
+    }
+    return error;
 }
 
 Error Layer::setColor(hwc_color_t color)
 {
+    if (mColor && mColor->r == color.r && mColor->g == color.g && mColor->b == color.b &&
+        mColor->a == color.a) {
+        return Error::None;
+    }
     Hwc2::IComposerClient::Color hwcColor{color.r, color.g, color.b, color.a};
     auto intError = mComposer.setLayerColor(mDisplayId, mId, hwcColor);
-    return static_cast<Error>(intError);
+    const auto error = static_cast<Error>(intError);
+    if (error == Error::None) {
+        mColor = color;
+    }
+    return error;
 }
 
 Error Layer::setCompositionType(Composition type)
 {
+    if (mCompositionType == type) {
+        return Error::None;
+    }
     auto intType = static_cast<Hwc2::IComposerClient::Composition>(type);
     auto intError = mComposer.setLayerCompositionType(
             mDisplayId, mId, intType);
-    return static_cast<Error>(intError);
+    const auto error = static_cast<Error>(intError);
+    if (error == Error::None) {
+        mCompositionType = type;
+    }
+    return error;
 }
 
 Error Layer::setDataspace(Dataspace dataspace)
@@ -960,21 +983,35 @@ Error Layer::setPerFrameMetadata(const int32_t supportedPerFrameMetadata,
 
 Error Layer::setDisplayFrame(const Rect& frame)
 {
+    if (mDisplayFrame == frame) {
+        return Error::None;
+    }
     Hwc2::IComposerClient::Rect hwcRect{frame.left, frame.top,
         frame.right, frame.bottom};
     auto intError = mComposer.setLayerDisplayFrame(mDisplayId, mId, hwcRect);
-    return static_cast<Error>(intError);
+    const auto error = static_cast<Error>(intError);
+    if (error == Error::None) {
+        mDisplayFrame = frame;
+    }
+    return error;
 }
 
 Error Layer::setPlaneAlpha(float alpha)
 {
+    if (mPlaneAlpha == alpha) {
+        return Error::None;
+    }
     auto intError = mComposer.setLayerPlaneAlpha(mDisplayId, mId, alpha);
-    return static_cast<Error>(intError);
+    const auto error = static_cast<Error>(intError);
+    if (error == Error::None) {
+        mPlaneAlpha = alpha;
+    }
+    return error;
 }
 
 Error Layer::setSidebandStream(const native_handle_t* stream)
 {
-    if (mCapabilities.count(Capability::SidebandStream) == 0) {
+    if (!mHasSidebandStreamCapability) {
         ALOGE("Attempted to call setSidebandStream without checking that the "
                 "device supports sideband streams");
         return Error::Unsupported;
@@ -985,23 +1022,50 @@ Error Layer::setSidebandStream(const native_handle_t* stream)
 
 Error Layer::setSourceCrop(const FloatRect& crop)
 {
+    if (mSourceCrop == crop) {
+        return Error::None;
+    }
     Hwc2::IComposerClient::FRect hwcRect{
         crop.left, crop.top, crop.right, crop.bottom};
     auto intError = mComposer.setLayerSourceCrop(mDisplayId, mId, hwcRect);
-    return static_cast<Error>(intError);
+    const auto error = static_cast<Error>(intError);
+    if (error == Error::None) {
+        mSourceCrop = crop;
+    }
+    return error;
 }
 
 Error Layer::setTransform(Transform transform)
 {
+    if (mTransform == transform) {
+        return Error::None;
+    }
     auto intTransform = static_cast<Hwc2::Transform>(transform);
     auto intError = mComposer.setLayerTransform(mDisplayId, mId, intTransform);
-    return static_cast<Error>(intError);
+    const auto error = static_cast<Error>(intError);
+    if (error == Error::None) {
+        mTransform = transform;
+    }
+    return error;
+}
+
+// Content comparison for regions; Region::isTriviallyEqual only compares
+// storage, which freshly computed regions never share.
+static bool regionsEqual(const Region& lhs, const Region& rhs)
+{
+    size_t lhsRectCount = 0;
+    size_t rhsRectCount = 0;
+    auto lhsRects = lhs.getArray(&lhsRectCount);
+    auto rhsRects = rhs.getArray(&rhsRectCount);
+    if (lhsRectCount != rhsRectCount) {
+        return false;
+    }
+    return memcmp(lhsRects, rhsRects, lhsRectCount * sizeof(Rect)) == 0;
 }
 
 Error Layer::setVisibleRegion(const Region& region)
 {
-    if (region.isRect() && mVisibleRegion.isRect() &&
-        (region.getBounds() == mVisibleRegion.getBounds())) {
+    if (regionsEqual(region, mVisibleRegion)) {
         return Error::None;
     }
     mVisibleRegion = region;
@@ -1021,14 +1085,28 @@ Error Layer::setVisibleRegion(const Region& region)
 
 Error Layer::setZOrder(uint32_t z)
 {
+    if (mZOrder == z) {
+        return Error::None;
+    }
     auto intError = mComposer.setLayerZOrder(mDisplayId, mId, z);
-    return static_cast<Error>(intError);
+    const auto error = static_cast<Error>(intError);
+    if (error == Error::None) {
+        mZOrder = z;
+    }
+    return error;
 }
 
 Error Layer::setInfo(uint32_t type, uint32_t appId)
 {
+  if (mInfo && mInfo->first == type && mInfo->second == appId) {
+    return Error::None;
+  }
   auto intError = mComposer.setLayerInfo(mDisplayId, mId, type, appId);
-  return static_cast<Error>(intError);
+  const auto error = static_cast<Error>(intError);
+  if (error == Error::None) {
+    mInfo = std::make_pair(type, appId);
+  }
+  return error;
 }
 
 // Composer HAL 2.3
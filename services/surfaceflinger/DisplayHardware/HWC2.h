@@ -35,7 +35,9 @@
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <optional>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace android {
@@ -439,6 +441,10 @@ private:
     hwc2_display_t mDisplayId;
     hwc2_layer_t mId;
 
+    // Capability probes resolved once at construction so the per-call
+    // paths carry no hash lookups.
+    const bool mHasSidebandStreamCapability;
+
     // Cached HWC2 data, to ensure the same commands aren't sent to the HWC
     // multiple times.
     android::Region mVisibleRegion = android::Region::INVALID_REGION;
@@ -447,6 +453,18 @@ private:
     android::HdrMetadata mHdrMetadata;
     android::mat4 mColorMatrix;
     uint32_t mBufferSlot;
+    // Shadow copies of the remaining per-layer state; layer state is
+    // persistent in the HAL, so commands whose value is unchanged can be
+    // elided entirely.  Unset until the first successful send.
+    std::optional<BlendMode> mBlendMode;
+    std::optional<hwc_color_t> mColor;
+    std::optional<Composition> mCompositionType;
+    std::optional<android::Rect> mDisplayFrame;
+    std::optional<float> mPlaneAlpha;
+    std::optional<android::FloatRect> mSourceCrop;
+    std::optional<Transform> mTransform;
+    std::optional<uint32_t> mZOrder;
+    std::optional<std::pair<uint32_t, uint32_t>> mInfo;
 };
 
 } // namespace impl
@@ -176,7 +176,20 @@ status_t VirtualDisplaySurface::prepareFrame(CompositionType compositionType) {
         // dequeueBuffer().
         mOutputFormat = mDefaultOutputFormat;
         mOutputUsage = GRALLOC_USAGE_HW_COMPOSER;
-        refreshOutputBuffer();
+
+        // The buffer dequeued in beginFrame() may already satisfy the sink
+        // defaults (GLES commonly renders in the sink's own format); if so,
+        // keep it instead of paying a cancel+dequeue+setOutputBuffer cycle on
+        // every GLES->MIXED/HWC transition.
+        sp<GraphicBuffer> buf;
+        if (mOutputProducerSlot >= 0) {
+            buf = mProducerBuffers[mOutputProducerSlot];
+        }
+        if (buf == nullptr ||
+                static_cast<uint32_t>(buf->getPixelFormat()) != mDefaultOutputFormat ||
+                (buf->getUsage() & GRALLOC_USAGE_HW_COMPOSER) == 0) {
+            refreshOutputBuffer();
+        }
     }
 
     return NO_ERROR;
@@ -139,6 +139,11 @@ void FrameTracker::getStats(FrameStats* outStats) const {
     }
 }
 
+void FrameTracker::setMissedFrameCallback(MissedFrameCallback callback) {
+    Mutex::Autolock lock(mMutex);
+    mMissedFrameCallback = std::move(callback);
+}
+
 void FrameTracker::logAndResetStats(const String8& name) {
     Mutex::Autolock lock(mMutex);
     logStatsLocked(name);
@@ -171,6 +176,17 @@ void FrameTracker::processFencesLocked() const {
                 records[idx].actualPresentFence = nullptr;
                 numFences--;
                 updated = true;
+
+                // Report a blown frame the moment its present resolves,
+                // instead of leaving the miss to be discovered in dumps a
+                // frame (or much) later.
+                if (mMissedFrameCallback && mDisplayPeriod > 0 &&
+                    records[idx].desiredPresentTime > 0 &&
+                    records[idx].actualPresentTime >
+                            records[idx].desiredPresentTime + mDisplayPeriod) {
+                    mMissedFrameCallback(records[idx].desiredPresentTime,
+                                         records[idx].actualPresentTime);
+                }
             }
         }
 
@@ -17,6 +17,8 @@
 #ifndef ANDROID_FRAMETRACKER_H
 #define ANDROID_FRAMETRACKER_H
 
+#include <functional>
+
 #include <ui/FenceTime.h>
 
 #include <stddef.h>
@@ -92,6 +94,17 @@ public:
     // dumpStats dump appends the current frame display time history to the result string.
     void dumpStats(std::string& result) const;
 
+    // Invoked as soon as a frame's present fence resolves later than its
+    // desired present time by more than the given slack (in display
+    // periods this defaults to one).  This fires from whichever thread
+    // resolves the fences -- typically postComposition -- one frame
+    // earlier than dump-based consumers can see the miss, so callers
+    // (e.g. per-layer pacing plumbing) can shed work mid-pipeline.  The
+    // callback must not call back into this tracker.
+    using MissedFrameCallback =
+            std::function<void(nsecs_t desiredPresentTime, nsecs_t actualPresentTime)>;
+    void setMissedFrameCallback(MissedFrameCallback callback);
+
 private:
     struct FrameRecord {
         FrameRecord() :
@@ -152,6 +165,9 @@ private:
     // all frames with duration greater than 2^(NUM_FRAME_BUCKETS-1).
     int32_t mNumFrames[NUM_FRAME_BUCKETS];
 
+    // Notified when a resolved frame missed its desired present time.
+    MissedFrameCallback mMissedFrameCallback;
+
     // mDisplayPeriod is the display refresh period of the display for which
     // this FrameTracker is gathering information.
     nsecs_t mDisplayPeriod;
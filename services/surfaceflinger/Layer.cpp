@@ -28,6 +28,8 @@
 #include <compositionengine/OutputLayer.h>
 #include <compositionengine/impl/LayerCompositionState.h>
 #include <compositionengine/impl/OutputLayerCompositionState.h>
+#include <binder/MemoryBase.h>
+#include <cutils/ashmem.h>
 #include <cutils/compiler.h>
 #include <cutils/native_handle.h>
 #include <cutils/properties.h>
@@ -38,6 +40,7 @@
 #include <renderengine/RenderEngine.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <ui/DebugUtils.h>
 #include <ui/GraphicBuffer.h>
@@ -70,6 +73,7 @@ namespace android {
 using base::StringAppendF;
 
 std::atomic<int32_t> Layer::sSequence{1};
+std::atomic<uint64_t> Layer::sHierarchyGeneration{1};
 
 Layer::Layer(const LayerCreationArgs& args)
       : mFlinger(args.flinger),
@@ -85,6 +89,11 @@ Layer::Layer(const LayerCreationArgs& args)
 
     mTransactionName = String8("TX - ") + mName;
 
+    // Tag the per-layer fence timelines so debug.fence.trace can attribute
+    // acquire/release spans to the layer in systrace.
+    mAcquireTimeline.setTraceName(std::string("fence-acquire-") + mName.string());
+    mReleaseTimeline.setTraceName(std::string("fence-release-") + mName.string());
+
     mCurrentState.active_legacy.w = args.w;
     mCurrentState.active_legacy.h = args.h;
     mCurrentState.flags = layerFlags;
@@ -920,6 +929,9 @@ uint32_t Layer::getTransactionFlags(uint32_t flags) {
 }
 
 uint32_t Layer::setTransactionFlags(uint32_t flags) {
+    // Any state change can affect traversal order; conservatively
+    // invalidate the cached traversal lists.
+    dirtyHierarchy();
     return mTransactionFlags.fetch_or(flags);
 }
 
@@ -1428,6 +1440,7 @@ void Layer::addAndGetFrameTimestamps(const NewFrameEventsEntry* newTimestamps,
         // Push the new fence after updating since it's likely still pending.
         mAcquireTimeline.push(newTimestamps->acquireFence);
         mFrameEventHistory.addQueue(*newTimestamps);
+        publishFrameTimestampsRingLocked(newTimestamps->frameNumber);
     }
 
     if (outDelta) {
@@ -1435,6 +1448,87 @@ void Layer::addAndGetFrameTimestamps(const NewFrameEventsEntry* newTimestamps,
     }
 }
 
+sp<IMemory> Layer::getFrameTimestampsRing() {
+    Mutex::Autolock lock(mFrameEventHistoryMutex);
+    return mFrameTimestampsRingMemory;
+}
+
+// A timestamp is publishable once it holds a real time; 0 in the ring
+// means "not available yet" and makes the reader fall back to the binder
+// query.
+static int64_t publishableTime(nsecs_t time) {
+    return (FrameEvents::isValidTimestamp(time) && time > 0) ? time : 0;
+}
+
+static int64_t publishableFenceTime(const std::shared_ptr<FenceTime>& fence) {
+    if (fence == nullptr) {
+        return 0;
+    }
+    const nsecs_t time = fence->getCachedSignalTime();
+    return (time > 0 && time != Fence::SIGNAL_TIME_PENDING) ? time : 0;
+}
+
+void Layer::publishFrameTimestampsRingLocked(uint64_t newFrameNumber) {
+    if (mFrameTimestampsRing == nullptr) {
+        if (mFrameTimestampsRingFailed) {
+            return;
+        }
+        // Same setup as the event-thread vsync ring: a read-only ashmem
+        // region for clients, with a private writable mapping created
+        // before the region is locked down.
+        const size_t ringSize = sizeof(FrameTimestampsRing);
+        sp<MemoryHeapBase> heap =
+                new MemoryHeapBase(ringSize, MemoryHeapBase::READ_ONLY, "Layer timestamps ring");
+        void* writable = MAP_FAILED;
+        if (heap->getBase() != MAP_FAILED) {
+            writable = mmap(nullptr, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                            heap->getHeapID(), 0);
+        }
+        if (writable == MAP_FAILED ||
+            ashmem_set_prot_region(heap->getHeapID(), PROT_READ) != 0) {
+            ALOGW("Layer %s: could not set up the frame timestamps ring", getName().string());
+            if (writable != MAP_FAILED) {
+                munmap(writable, ringSize);
+            }
+            mFrameTimestampsRingFailed = true;
+            return;
+        }
+        mFrameTimestampsRingHeap = heap;
+        mFrameTimestampsRingMemory = new MemoryBase(heap, 0, ringSize);
+        mFrameTimestampsRing = static_cast<FrameTimestampsRing*>(writable);
+        memset(mFrameTimestampsRing, 0, ringSize);
+    }
+
+    mRingFrameNumbers[newFrameNumber % FrameTimestampsRing::kEntryCount] = newFrameNumber;
+
+    // Refresh every tracked frame: fences resolve over several frames, so
+    // entries fill in as their signal times become known.
+    for (size_t i = 0; i < FrameTimestampsRing::kEntryCount; i++) {
+        const uint64_t frameNumber = mRingFrameNumbers[i];
+        if (frameNumber == 0) {
+            continue;
+        }
+        FrameEvents* events = mFrameEventHistory.getFrame(frameNumber);
+        if (events == nullptr || events->frameNumber != frameNumber) {
+            continue;
+        }
+
+        FrameTimestampsRing::Entry& entry = mFrameTimestampsRing->entries[i];
+        const uint32_t seq = entry.seq.load(std::memory_order_relaxed);
+        entry.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        entry.frameNumber = frameNumber;
+        entry.latchTime = publishableTime(events->latchTime);
+        entry.firstRefreshStartTime = publishableTime(events->firstRefreshStartTime);
+        entry.lastRefreshStartTime = publishableTime(events->lastRefreshStartTime);
+        entry.dequeueReadyTime = publishableTime(events->dequeueReadyTime);
+        entry.gpuCompositionDoneTime = publishableFenceTime(events->gpuCompositionDoneFence);
+        entry.displayPresentTime = publishableFenceTime(events->displayPresentFence);
+        entry.releaseTime = publishableFenceTime(events->releaseFence);
+        entry.seq.store(seq + 2, std::memory_order_release);
+    }
+}
+
 size_t Layer::getChildrenCount() const {
     size_t count = 0;
     for (const sp<Layer>& child : mCurrentChildren) {
@@ -1661,6 +1755,19 @@ __attribute__((no_sanitize("unsigned-integer-overflow"))) LayerVector Layer::mak
 /**
  * Negatively signed relatives are before 'this' in Z-order.
  */
+const LayerVector& Layer::getTraversalList(LayerVector::StateSet stateSet,
+                                           bool* outSkipRelativeZUsers) {
+    const bool useDrawing = stateSet == LayerVector::StateSet::Drawing;
+    TraversalCache& cache = useDrawing ? mDrawingTraversal : mCurrentTraversal;
+    const uint64_t generation = sHierarchyGeneration.load();
+    if (cache.generation != generation) {
+        cache.list = makeTraversalList(stateSet, &cache.skipRelativeZUsers);
+        cache.generation = generation;
+    }
+    *outSkipRelativeZUsers = cache.skipRelativeZUsers;
+    return cache.list;
+}
+
 void Layer::traverseInZOrder(LayerVector::StateSet stateSet, const LayerVector::Visitor& visitor) {
     // In the case we have other layers who are using a relative Z to us, makeTraversalList will
     // produce a new list for traversing, including our relatives, and not including our children
@@ -1669,7 +1776,17 @@ void Layer::traverseInZOrder(LayerVector::StateSet stateSet, const LayerVector::
     // However in this case we need to take the responsibility for filtering children which
     // are relatives of another surface here.
     bool skipRelativeZUsers = false;
-    const LayerVector list = makeTraversalList(stateSet, &skipRelativeZUsers);
+    // Off the main thread the shared traversal cache may be rebuilt under
+    // us; take a by-value snapshot instead (copy-on-write, so cheap).
+    LayerVector snapshot(stateSet);
+    const LayerVector* listPtr;
+    if (mFlinger->isMainThread()) {
+        listPtr = &getTraversalList(stateSet, &skipRelativeZUsers);
+    } else {
+        snapshot = makeTraversalList(stateSet, &skipRelativeZUsers);
+        listPtr = &snapshot;
+    }
+    const LayerVector& list = *listPtr;
 
     size_t i = 0;
     for (; i < list.size(); i++) {
@@ -1702,7 +1819,15 @@ void Layer::traverseInReverseZOrder(LayerVector::StateSet stateSet,
                                     const LayerVector::Visitor& visitor) {
     // See traverseInZOrder for documentation.
     bool skipRelativeZUsers = false;
-    LayerVector list = makeTraversalList(stateSet, &skipRelativeZUsers);
+    LayerVector snapshot(stateSet);
+    const LayerVector* listPtr;
+    if (mFlinger->isMainThread()) {
+        listPtr = &getTraversalList(stateSet, &skipRelativeZUsers);
+    } else {
+        snapshot = makeTraversalList(stateSet, &skipRelativeZUsers);
+        listPtr = &snapshot;
+    }
+    const LayerVector& list = *listPtr;
 
     int32_t i = 0;
     for (i = int32_t(list.size()) - 1; i >= 0; i--) {
@@ -1849,6 +1974,9 @@ void Layer::commitChildList() {
     }
     mDrawingChildren = mCurrentChildren;
     mDrawingParent = mCurrentParent;
+    // The drawing-side hierarchy (and any z values committed by
+    // doTransaction()) just changed.
+    dirtyHierarchy();
 }
 
 static wp<Layer> extractLayerFromBinder(const wp<IBinder>& weakBinderHandle) {
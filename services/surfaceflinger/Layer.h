@@ -18,6 +18,7 @@
 #define ANDROID_LAYER_H
 
 #include <compositionengine/LayerFE.h>
+#include <binder/MemoryHeapBase.h>
 #include <gui/BufferQueue.h>
 #include <gui/ISurfaceComposerClient.h>
 #include <gui/LayerState.h>
@@ -104,6 +105,27 @@ public:
     Region visibleNonTransparentRegion;
     Region surfaceDamageRegion;
 
+    // Inputs and derived opaque region from this layer's last
+    // computeVisibleRegions() pass.  Lets SurfaceFlinger skip re-resolving
+    // layers whose visibility inputs are unchanged and that no changed
+    // layer above can occlude or expose; see
+    // SurfaceFlinger::computeVisibleRegions().
+    struct VisibilityCache {
+        bool valid{false};
+        // Identity tag of the display the cache was computed for; never
+        // dereferenced.
+        const void* display{nullptr};
+        bool visible{false};
+        Rect bounds{Rect::EMPTY_RECT};
+        bool translucent{false};
+        float alpha{1.0f};
+        float cornerRadius{0.0f};
+        uint32_t orientation{0};
+        Region transparentRegion;
+        Region opaqueRegion;
+    };
+    VisibilityCache visibilityCache;
+
     // Layer serial number.  This gives layers an explicit ordering, so we
     // have a stable sort order when their layer stack and Z-order are
     // the same.
@@ -633,6 +655,9 @@ public:
     }
 
     void onDisconnect();
+    // Shared-memory ring of resolved consumer-side frame timestamps,
+    // created lazily; see publishFrameTimestampsRingLocked().
+    sp<IMemory> getFrameTimestampsRing();
     void addAndGetFrameTimestamps(const NewFrameEventsEntry* newEntry,
                                   FrameEventHistoryDelta* outDelta);
 
@@ -653,6 +678,19 @@ public:
     // ignored.
     RoundedCornerState getRoundedCornerState() const;
 
+    // Bumps the global hierarchy generation, invalidating every layer's
+    // cached traversal list.  Called whenever layer state that can affect
+    // traversal order changes.
+    static void dirtyHierarchy() { sHierarchyGeneration++; }
+
+    // Latched buffer access for the no-GL capture fast path; the fence
+    // must be waited before reading the buffer's pixels.
+    const sp<GraphicBuffer>& getActiveBuffer() const { return mActiveBuffer; }
+    const sp<Fence>& getActiveBufferFence() const { return mActiveBufferFence; }
+    // The gralloc transform of the latched buffer (e.g. camera rotation);
+    // 0 for layer types without buffers.
+    virtual uint32_t getActiveBufferTransform() const { return 0; }
+
     void traverseInReverseZOrder(LayerVector::StateSet stateSet,
                                  const LayerVector::Visitor& visitor);
     void traverseInZOrder(LayerVector::StateSet stateSet, const LayerVector::Visitor& visitor);
@@ -738,6 +776,12 @@ protected:
     void setupRoundedCornersCropCoordinates(Rect win, const FloatRect& roundedCornersCrop) const;
     void setParent(const sp<Layer>& layer);
     LayerVector makeTraversalList(LayerVector::StateSet stateSet, bool* outSkipRelativeZUsers);
+    // Returns the (cached) list makeTraversalList() would produce.  The
+    // cache is rebuilt only when the hierarchy generation has moved, so
+    // the repeated per-frame traversals stop re-merging and re-sorting
+    // the relative-Z list.
+    const LayerVector& getTraversalList(LayerVector::StateSet stateSet,
+                                        bool* outSkipRelativeZUsers);
     void addZOrderRelative(const wp<Layer>& relative);
     void removeZOrderRelative(const wp<Layer>& relative);
 
@@ -836,6 +880,22 @@ protected:
     State mDrawingState;
     std::atomic<uint32_t> mTransactionFlags{0};
 
+    // Global generation counter for anything that can affect traversal
+    // order (children, z, layer stacks, relative-Z links); cached
+    // traversal lists are keyed against it.
+    static std::atomic<uint64_t> sHierarchyGeneration;
+
+    // Cached makeTraversalList() results, one per state set.  Accessed
+    // under the same external lock as the states above.
+    struct TraversalCache {
+        explicit TraversalCache(LayerVector::StateSet stateSet) : list(stateSet) {}
+        uint64_t generation{0};  // 0 is never a valid generation
+        bool skipRelativeZUsers{false};
+        LayerVector list;
+    };
+    TraversalCache mCurrentTraversal{LayerVector::StateSet::Current};
+    TraversalCache mDrawingTraversal{LayerVector::StateSet::Drawing};
+
     // Accessed from main thread and binder threads
     Mutex mPendingStateMutex;
     Vector<State> mPendingStates;
@@ -847,6 +907,16 @@ protected:
     // Accessed by both consumer and producer on main and binder threads.
     Mutex mFrameEventHistoryMutex;
     ConsumerFrameEventHistory mFrameEventHistory;
+
+    // Publishes the resolved timestamps of recent frames into the shared
+    // ring; called on the queue path with mFrameEventHistoryMutex held.
+    void publishFrameTimestampsRingLocked(uint64_t newFrameNumber);
+
+    sp<MemoryHeapBase> mFrameTimestampsRingHeap;
+    sp<IMemory> mFrameTimestampsRingMemory;
+    FrameTimestampsRing* mFrameTimestampsRing = nullptr;
+    bool mFrameTimestampsRingFailed = false;
+    uint64_t mRingFrameNumbers[FrameTimestampsRing::kEntryCount] = {};
     FenceTimeline mAcquireTimeline;
     FenceTimeline mReleaseTimeline;
 
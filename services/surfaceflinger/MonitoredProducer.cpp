@@ -77,6 +77,19 @@ status_t MonitoredProducer::attachBuffer(int* outSlot,
     return mProducer->attachBuffer(outSlot, buffer);
 }
 
+status_t MonitoredProducer::queueAndDequeueBuffer(int slot, const QueueBufferInput& input,
+                                                  QueueBufferOutput* output, uint32_t width,
+                                                  uint32_t height, PixelFormat format,
+                                                  uint64_t usage, uint64_t* outBufferAge,
+                                                  int* outSlot, sp<Fence>* outFence) {
+    return mProducer->queueAndDequeueBuffer(slot, input, output, width, height, format, usage,
+                                            outBufferAge, outSlot, outFence);
+}
+
+status_t MonitoredProducer::getFrameTimestampsRing(sp<IMemory>* outRing) {
+    return mProducer->getFrameTimestampsRing(outRing);
+}
+
 status_t MonitoredProducer::queueBuffer(int slot, const QueueBufferInput& input,
         QueueBufferOutput* output) {
     return mProducer->queueBuffer(slot, input, output);
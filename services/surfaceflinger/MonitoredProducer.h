@@ -47,6 +47,12 @@ public:
             sp<Fence>* outFence);
     virtual status_t attachBuffer(int* outSlot,
             const sp<GraphicBuffer>& buffer);
+    virtual status_t queueAndDequeueBuffer(int slot, const QueueBufferInput& input,
+                                           QueueBufferOutput* output, uint32_t width,
+                                           uint32_t height, PixelFormat format, uint64_t usage,
+                                           uint64_t* outBufferAge, int* outSlot,
+                                           sp<Fence>* outFence) override;
+    virtual status_t getFrameTimestampsRing(sp<IMemory>* outRing) override;
     virtual status_t queueBuffer(int slot, const QueueBufferInput& input,
             QueueBufferOutput* output);
     virtual status_t cancelBuffer(int slot, const sp<Fence>& fence);
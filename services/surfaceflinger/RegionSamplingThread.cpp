@@ -24,6 +24,8 @@
 #include <cutils/properties.h>
 #include <gui/IRegionSamplingListener.h>
 #include <utils/Trace.h>
+
+#include <algorithm>
 #include <string>
 
 #include <compositionengine/Display.h>
@@ -379,6 +381,9 @@ void RegionSamplingThread::captureSample() {
     }
 
     const Rect sampledArea = sampleRegion.bounds();
+    if (sampledArea.isEmpty()) {
+        return;
+    }
 
     auto dx = 0;
     auto dy = 0;
@@ -400,8 +405,17 @@ void RegionSamplingThread::captureSample() {
     ui::Transform t(orientation);
     auto screencapRegion = t.transform(sampleRegion);
     screencapRegion = screencapRegion.translate(dx, dy);
-    DisplayRenderArea renderArea(device, screencapRegion.bounds(), sampledArea.getWidth(),
-                                 sampledArea.getHeight(), ui::Dataspace::V0_SRGB, orientation);
+
+    // Sampling only needs a coarse luma estimate, so let the GPU
+    // downsample the capture during the blit and run the (unchanged) luma
+    // math over what remains: a kSampleScale^2 reduction of the CPU pixel
+    // loop and its cache pollution.
+    constexpr int32_t kSampleScale = 8;
+    const int32_t sampleWidth = std::max(sampledArea.getWidth() / kSampleScale, 1);
+    const int32_t sampleHeight = std::max(sampledArea.getHeight() / kSampleScale, 1);
+
+    DisplayRenderArea renderArea(device, screencapRegion.bounds(), sampleWidth, sampleHeight,
+                                 ui::Dataspace::V0_SRGB, orientation);
 
     std::unordered_set<sp<IRegionSamplingListener>, SpHash<IRegionSamplingListener>> listeners;
 
@@ -447,13 +461,13 @@ void RegionSamplingThread::captureSample() {
     };
 
     sp<GraphicBuffer> buffer = nullptr;
-    if (mCachedBuffer && mCachedBuffer->getWidth() == sampledArea.getWidth() &&
-        mCachedBuffer->getHeight() == sampledArea.getHeight()) {
+    if (mCachedBuffer && mCachedBuffer->getWidth() == static_cast<uint32_t>(sampleWidth) &&
+        mCachedBuffer->getHeight() == static_cast<uint32_t>(sampleHeight)) {
         buffer = mCachedBuffer;
     } else {
         const uint32_t usage = GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_HW_RENDER;
-        buffer = new GraphicBuffer(sampledArea.getWidth(), sampledArea.getHeight(),
-                                   PIXEL_FORMAT_RGBA_8888, 1, usage, "RegionSamplingThread");
+        buffer = new GraphicBuffer(sampleWidth, sampleHeight, PIXEL_FORMAT_RGBA_8888, 1, usage,
+                                   "RegionSamplingThread");
     }
 
     bool ignored;
@@ -466,9 +480,23 @@ void RegionSamplingThread::captureSample() {
         }
     }
 
+    // Map the descriptor areas into the downsampled buffer's space (at
+    // least one pixel each).
+    std::vector<Descriptor> scaledDescriptors = activeDescriptors;
+    for (Descriptor& descriptor : scaledDescriptors) {
+        Rect relative = descriptor.area - sampledArea.leftTop();
+        Rect scaled;
+        scaled.left = relative.left * sampleWidth / sampledArea.getWidth();
+        scaled.top = relative.top * sampleHeight / sampledArea.getHeight();
+        scaled.right = std::max(relative.right * sampleWidth / sampledArea.getWidth(),
+                                scaled.left + 1);
+        scaled.bottom = std::max(relative.bottom * sampleHeight / sampledArea.getHeight(),
+                                 scaled.top + 1);
+        descriptor.area = scaled;
+    }
+
     ALOGV("Sampling %zu descriptors", activeDescriptors.size());
-    std::vector<float> lumas =
-            sampleBuffer(buffer, sampledArea.leftTop(), activeDescriptors, orientation);
+    std::vector<float> lumas = sampleBuffer(buffer, Point(0, 0), scaledDescriptors, orientation);
     if (lumas.size() != activeDescriptors.size()) {
         ALOGW("collected %zu median luma values for %zu descriptors", lumas.size(),
               activeDescriptors.size());
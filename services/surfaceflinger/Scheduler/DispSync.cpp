@@ -538,9 +538,68 @@ bool DispSync::addPresentFence(const std::shared_ptr<FenceTime>& fenceTime) {
 
     updateErrorLocked();
 
+    if (mModelUpdated && mError > kErrorThreshold) {
+        // Before falling back to hardware vsync, try to absorb the error
+        // as a phase correction: panels with thermally drifting refresh
+        // mostly accumulate phase error, which the present fences track
+        // continuously.  Only residual error -- a real period change --
+        // still re-enables hardware vsync.
+        correctPhaseFromPresentLocked();
+    }
+
     return !mModelUpdated || mError > kErrorThreshold;
 }
 
+void DispSync::correctPhaseFromPresentLocked() {
+    // Mean signed phase error against the un-adjusted refresh period,
+    // mirroring the squared-error computation in updateErrorLocked().
+    nsecs_t period = mPeriod / (1 + mRefreshSkipCount);
+    nsecs_t errSum = 0;
+    int numSamples = 0;
+
+    for (size_t i = 0; i < NUM_PRESENT_SAMPLES; i++) {
+        nsecs_t time = mPresentFences[i]->getCachedSignalTime();
+        if (time == Fence::SIGNAL_TIME_PENDING || time == Fence::SIGNAL_TIME_INVALID) {
+            continue;
+        }
+
+        nsecs_t sample = time - mReferenceTime;
+        if (sample <= mPhase) {
+            continue;
+        }
+
+        nsecs_t sampleErr = (sample - mPhase) % period;
+        if (sampleErr > period / 2) {
+            sampleErr -= period;
+        }
+        errSum += sampleErr;
+        numSamples++;
+    }
+
+    if (numSamples < 3) {
+        return;
+    }
+
+    // Quarter gain keeps the loop stable against fence jitter while still
+    // converging within a handful of frames.
+    const nsecs_t correction = (errSum / numSamples) / 4;
+    if (correction == 0) {
+        return;
+    }
+
+    mPhase += correction;
+    mPhaseCorrectionCount++;
+    mCumulativePhaseCorrection += correction;
+    ALOGV("[%s] phase corrected by %" PRId64 " us from present fences", mName,
+          ns2us(correction));
+    if (mTraceDetailedInfo) {
+        ATRACE_INT64("DispSync:PhaseCorrection", correction);
+    }
+    mThread->updateModel(mPeriod, mPhase, mReferenceTime);
+
+    updateErrorLocked();
+}
+
 void DispSync::beginResync() {
     Mutex::Autolock lock(mMutex);
     ALOGV("[%s] beginResync", mName);
@@ -811,6 +870,9 @@ void DispSync::dump(std::string& result) const {
                   1000000000.0 / mPeriod, mRefreshSkipCount);
     StringAppendF(&result, "mPhase: %" PRId64 " ns\n", mPhase);
     StringAppendF(&result, "mError: %" PRId64 " ns (sqrt=%.1f)\n", mError, sqrt(mError));
+    StringAppendF(&result,
+                  "present-fence phase corrections: %u (cumulative %" PRId64 " ns)\n",
+                  mPhaseCorrectionCount, mCumulativePhaseCorrection);
     StringAppendF(&result, "mNumResyncSamplesSincePresent: %d (limit %d)\n",
                   mNumResyncSamplesSincePresent, MAX_RESYNC_SAMPLES_WITHOUT_PRESENT);
     StringAppendF(&result, "mNumResyncSamples: %zd (max %d)\n", mNumResyncSamples,
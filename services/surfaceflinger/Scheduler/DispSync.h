@@ -192,6 +192,9 @@ public:
 private:
     void updateModelLocked();
     void updateErrorLocked();
+    // Applies a filtered phase correction derived from the present-fence
+    // samples, so phase drift does not force hardware vsync back on.
+    void correctPhaseFromPresentLocked();
     void resetLocked();
     void resetErrorLocked();
 
@@ -236,6 +239,11 @@ private:
     // Used to sanity check that we are able to calculate the model error.
     size_t mZeroErrSamplesCount;
 
+    // Statistics for the present-fence-driven phase corrections, shown in
+    // dumpsys so the prediction quality can be judged per display.
+    uint32_t mPhaseCorrectionCount = 0;
+    nsecs_t mCumulativePhaseCorrection = 0;
+
     // Whether we have updated the vsync event model since the last resync.
     bool mModelUpdated;
 
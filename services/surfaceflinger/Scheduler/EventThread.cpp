@@ -18,6 +18,7 @@
 
 #include <pthread.h>
 #include <sched.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 
 #include <chrono>
@@ -29,6 +30,8 @@
 
 #include <bfqio/bfqio.h>
 
+#include <binder/MemoryBase.h>
+#include <cutils/ashmem.h>
 #include <cutils/compiler.h>
 #include <cutils/sched_policy.h>
 
@@ -145,6 +148,16 @@ void EventThreadConnection::requestNextVsync() {
     mEventThread->requestNextVsync(this);
 }
 
+status_t EventThreadConnection::getLatestVsyncRing(sp<IMemory>* outRing) {
+    *outRing = mEventThread->getVsyncRingMemory();
+    return *outRing != nullptr ? NO_ERROR : INVALID_OPERATION;
+}
+
+status_t EventThreadConnection::setVsyncPhase(uint32_t phase) {
+    mEventThread->setVsyncPhase(phase, this);
+    return NO_ERROR;
+}
+
 status_t EventThreadConnection::postEvent(const DisplayEventReceiver::Event& event) {
     ssize_t size = DisplayEventReceiver::sendEvents(&mChannel, &event, 1);
     return size < 0 ? status_t(size) : status_t(NO_ERROR);
@@ -175,6 +188,34 @@ EventThread::EventThread(VSyncSource* src, std::unique_ptr<VSyncSource> uniqueSr
     }
     mVSyncSource->setCallback(this);
 
+    // Shared page through which polling clients read the latest vsync
+    // without a socket round trip; see getLatestVsyncRing().  The heap is
+    // marked read-only so clients cannot corrupt what other processes
+    // read; we keep a private writable mapping created before the ashmem
+    // region is locked down.
+    const size_t ringSize = sizeof(DisplayEventReceiver::VsyncEventRing);
+    mVsyncRingHeap = new MemoryHeapBase(ringSize, MemoryHeapBase::READ_ONLY,
+                                        "EventThread vsync ring");
+    if (mVsyncRingHeap->getBase() != MAP_FAILED) {
+        void* writable = mmap(nullptr, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                              mVsyncRingHeap->getHeapID(), 0);
+        if (writable != MAP_FAILED &&
+            ashmem_set_prot_region(mVsyncRingHeap->getHeapID(), PROT_READ) == 0) {
+            mVsyncRingMemory = new MemoryBase(mVsyncRingHeap, 0, ringSize);
+            mVsyncRing = static_cast<DisplayEventReceiver::VsyncEventRing*>(writable);
+            mVsyncRing->seq.store(0, std::memory_order_relaxed);
+        } else {
+            ALOGW("EventThread: could not set up the vsync ring; clients fall back to sockets");
+            if (writable != MAP_FAILED) {
+                munmap(writable, ringSize);
+            }
+            mVsyncRingHeap = nullptr;
+        }
+    } else {
+        ALOGW("EventThread: could not allocate the vsync ring; clients fall back to sockets");
+        mVsyncRingHeap = nullptr;
+    }
+
     mThread = std::thread([this]() NO_THREAD_SAFETY_ANALYSIS {
         std::unique_lock<std::mutex> lock(mMutex);
         threadMain(lock);
@@ -206,6 +247,11 @@ EventThread::~EventThread() {
         mCondition.notify_all();
     }
     mThread.join();
+
+    if (mVsyncRing != nullptr) {
+        munmap(mVsyncRing, sizeof(DisplayEventReceiver::VsyncEventRing));
+        mVsyncRing = nullptr;
+    }
 }
 
 void EventThread::setPhaseOffset(nsecs_t phaseOffset) {
@@ -258,6 +304,15 @@ void EventThread::setVsyncRate(uint32_t rate, const sp<EventThreadConnection>& c
     }
 }
 
+void EventThread::setVsyncPhase(uint32_t phase, const sp<EventThreadConnection>& connection) {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (connection->vsyncPhase != phase) {
+        connection->vsyncPhase = phase;
+        mCondition.notify_all();
+    }
+}
+
 void EventThread::requestNextVsync(const sp<EventThreadConnection>& connection) {
     if (connection->resyncCallback) {
         connection->resyncCallback();
@@ -313,6 +368,22 @@ void EventThread::onConfigChanged(PhysicalDisplayId displayId, int32_t configId)
     mCondition.notify_all();
 }
 
+sp<IMemory> EventThread::getVsyncRingMemory() const {
+    return mVsyncRingMemory;
+}
+
+void EventThread::publishLatestVsync(const DisplayEventReceiver::Event& event) {
+    if (mVsyncRing == nullptr) {
+        return;
+    }
+    // Seqlock write: odd while in progress, even when stable.
+    const uint32_t seq = mVsyncRing->seq.load(std::memory_order_relaxed);
+    mVsyncRing->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    mVsyncRing->event = event;
+    mVsyncRing->seq.store(seq + 2, std::memory_order_release);
+}
+
 void EventThread::threadMain(std::unique_lock<std::mutex>& lock) {
     DisplayEventConsumers consumers;
 
@@ -361,7 +432,15 @@ void EventThread::threadMain(std::unique_lock<std::mutex>& lock) {
         }
 
         if (!consumers.empty()) {
-            dispatchEvent(*event, consumers);
+            // The per-consumer writes are syscalls; with many registered
+            // apps they dominate the vsync-critical path, so drop the
+            // lock while performing them.
+            lock.unlock();
+            const auto deadConnections = dispatchEvent(*event, consumers);
+            lock.lock();
+            for (const auto& connection : deadConnections) {
+                removeDisplayEventConnectionLocked(connection);
+            }
             consumers.clear();
         }
 
@@ -424,8 +503,10 @@ bool EventThread::shouldConsumeEvent(const DisplayEventReceiver::Event& event,
                     return true;
                 case VSyncRequest::Periodic:
                     return true;
-                default:
-                    return event.vsync.count % vsyncPeriod(connection->vsyncRequest) == 0;
+                default: {
+                    const auto period = vsyncPeriod(connection->vsyncRequest);
+                    return event.vsync.count % period == connection->vsyncPhase % period;
+                }
             }
 
         default:
@@ -433,8 +514,16 @@ bool EventThread::shouldConsumeEvent(const DisplayEventReceiver::Event& event,
     }
 }
 
-void EventThread::dispatchEvent(const DisplayEventReceiver::Event& event,
-                                const DisplayEventConsumers& consumers) {
+std::vector<wp<EventThreadConnection>> EventThread::dispatchEvent(
+        const DisplayEventReceiver::Event& event, const DisplayEventConsumers& consumers) {
+    // Publish once into the shared ring so polling clients see the payload
+    // without any socket traffic; the per-connection writes below act as
+    // the doorbell.
+    if (event.header.type == DisplayEventReceiver::DISPLAY_EVENT_VSYNC) {
+        publishLatestVsync(event);
+    }
+
+    std::vector<wp<EventThreadConnection>> deadConnections;
     for (const auto& consumer : consumers) {
         switch (consumer->postEvent(event)) {
             case NO_ERROR:
@@ -448,9 +537,10 @@ void EventThread::dispatchEvent(const DisplayEventReceiver::Event& event,
 
             default:
                 // Treat EPIPE and other errors as fatal.
-                removeDisplayEventConnectionLocked(consumer);
+                deadConnections.emplace_back(consumer);
         }
     }
+    return deadConnections;
 }
 
 void EventThread::dump(std::string& result) const {
@@ -473,7 +563,11 @@ void EventThread::dump(std::string& result) const {
     StringAppendF(&result, "  connections (count=%zu):\n", mDisplayEventConnections.size());
     for (const auto& ptr : mDisplayEventConnections) {
         if (const auto connection = ptr.promote()) {
-            StringAppendF(&result, "    %s\n", toString(*connection).c_str());
+            const uint32_t drops = connection->getChannelDroppedSendCount();
+            StringAppendF(&result, "    %s%s\n", toString(*connection).c_str(),
+                          drops > 0
+                                  ? StringPrintf(" (dropped sends: %u)", drops).c_str()
+                                  : "");
         }
     }
 }
@@ -28,6 +28,7 @@
 
 #include <android-base/thread_annotations.h>
 
+#include <binder/MemoryHeapBase.h>
 #include <gui/DisplayEventReceiver.h>
 #include <gui/IDisplayEventConnection.h>
 #include <private/gui/BitTube.h>
@@ -78,11 +79,18 @@ public:
     status_t stealReceiveChannel(gui::BitTube* outChannel) override;
     status_t setVsyncRate(uint32_t rate) override;
     void requestNextVsync() override; // asynchronous
+    status_t getLatestVsyncRing(sp<IMemory>* outRing) override;
+    status_t setVsyncPhase(uint32_t phase) override;
+
+    // Full-socket send failures on this connection's channel, for dumps.
+    uint32_t getChannelDroppedSendCount() const { return mChannel.getDroppedSendCount(); }
 
     // Called in response to requestNextVsync.
     const ResyncCallback resyncCallback;
 
     VSyncRequest vsyncRequest = VSyncRequest::None;
+    // which vsync within a periodic request's cycle is delivered (count % period == phase)
+    uint32_t vsyncPhase = 0;
     const ISurfaceComposer::ConfigChanged configChanged;
 
 private:
@@ -116,8 +124,13 @@ public:
     virtual status_t registerDisplayEventConnection(
             const sp<EventThreadConnection>& connection) = 0;
     virtual void setVsyncRate(uint32_t rate, const sp<EventThreadConnection>& connection) = 0;
+    virtual void setVsyncPhase(uint32_t phase, const sp<EventThreadConnection>& connection) = 0;
     // Requests the next vsync. If resetIdleTimer is set to true, it resets the idle timer.
     virtual void requestNextVsync(const sp<EventThreadConnection>& connection) = 0;
+
+    // Shared page carrying the latest published vsync event, or nullptr
+    // when unavailable; see IDisplayEventConnection::getLatestVsyncRing().
+    virtual sp<IMemory> getVsyncRingMemory() const = 0;
 };
 
 namespace impl {
@@ -136,6 +149,7 @@ public:
 
     status_t registerDisplayEventConnection(const sp<EventThreadConnection>& connection) override;
     void setVsyncRate(uint32_t rate, const sp<EventThreadConnection>& connection) override;
+    void setVsyncPhase(uint32_t phase, const sp<EventThreadConnection>& connection) override;
     void requestNextVsync(const sp<EventThreadConnection>& connection) override;
 
     // called before the screen is turned off from main thread
@@ -152,6 +166,8 @@ public:
 
     void setPhaseOffset(nsecs_t phaseOffset) override;
 
+    sp<IMemory> getVsyncRingMemory() const override;
+
 private:
     friend EventThreadTest;
 
@@ -165,8 +181,12 @@ private:
 
     bool shouldConsumeEvent(const DisplayEventReceiver::Event& event,
                             const sp<EventThreadConnection>& connection) const REQUIRES(mMutex);
-    void dispatchEvent(const DisplayEventReceiver::Event& event,
-                       const DisplayEventConsumers& consumers) REQUIRES(mMutex);
+    // Performs the per-consumer socket writes without the lock held and
+    // returns the connections whose channel died, for removal under the
+    // lock.  Also publishes vsync events into the shared ring.
+    std::vector<wp<EventThreadConnection>> dispatchEvent(const DisplayEventReceiver::Event& event,
+                                                         const DisplayEventConsumers& consumers);
+    void publishLatestVsync(const DisplayEventReceiver::Event& event);
 
     void removeDisplayEventConnectionLocked(const wp<EventThreadConnection>& connection)
             REQUIRES(mMutex);
@@ -188,6 +208,13 @@ private:
     std::vector<wp<EventThreadConnection>> mDisplayEventConnections GUARDED_BY(mMutex);
     std::deque<DisplayEventReceiver::Event> mPendingEvents GUARDED_BY(mMutex);
 
+    // Single-producer shared page carrying the latest vsync event under a
+    // seqlock; handed to clients via getLatestVsyncRing().  Only the event
+    // thread writes it.
+    sp<MemoryHeapBase> mVsyncRingHeap;
+    sp<IMemory> mVsyncRingMemory;
+    DisplayEventReceiver::VsyncEventRing* mVsyncRing = nullptr;
+
     // VSYNC state of connected display.
     struct VSyncState {
         explicit VSyncState(PhysicalDisplayId displayId) : displayId(displayId) {}
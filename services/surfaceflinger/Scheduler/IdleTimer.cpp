@@ -78,20 +78,28 @@ void IdleTimer::loop() {
                 break;
             }
 
-            auto triggerTime = std::chrono::steady_clock::now() + mInterval;
+            mDeadline.store((std::chrono::steady_clock::now() + mInterval)
+                                    .time_since_epoch()
+                                    .count(),
+                            std::memory_order_relaxed);
             mState = TimerState::WAITING;
             while (mState == TimerState::WAITING) {
-                constexpr auto zero = std::chrono::steady_clock::duration::zero();
-                auto waitTime = triggerTime - std::chrono::steady_clock::now();
-                if (waitTime > zero) mCondition.wait_for(mMutex, waitTime);
-                if (mState == TimerState::RESET) {
-                    triggerTime = std::chrono::steady_clock::now() + mInterval;
-                    mState = TimerState::WAITING;
-                } else if (mState == TimerState::WAITING &&
-                           (triggerTime - std::chrono::steady_clock::now()) <= zero) {
+                // The deadline may have been bumped (without a wakeup) any
+                // number of times while we slept; keep sleeping until the
+                // latest one has actually passed.
+                const auto deadline = std::chrono::steady_clock::time_point(
+                        std::chrono::steady_clock::duration(
+                                mDeadline.load(std::memory_order_relaxed)));
+                const auto now = std::chrono::steady_clock::now();
+                if (now >= deadline) {
                     triggerTimeout = true;
                     mState = TimerState::IDLE;
+                    break;
                 }
+                mCondition.wait_for(mMutex, deadline - now);
+                // A RESET here means we were re-armed out of IDLE (or
+                // stop/start); fall back to the outer loop which fires
+                // the reset callback and re-arms.
             }
         }
         if (triggerTimeout && mTimeoutCallback) {
@@ -101,8 +109,20 @@ void IdleTimer::loop() {
 } // namespace scheduler
 
 void IdleTimer::reset() {
+    mDeadline.store((std::chrono::steady_clock::now() + mInterval).time_since_epoch().count(),
+                    std::memory_order_relaxed);
+
+    // While armed, the bump above is all that's needed: the timer thread
+    // re-reads the deadline when its current wait runs out.  Only the
+    // idle state needs a state change and a wakeup.
+    if (mState.load(std::memory_order_acquire) != TimerState::IDLE) {
+        return;
+    }
     {
         std::lock_guard<std::mutex> lock(mMutex);
+        if (mState != TimerState::IDLE) {
+            return;
+        }
         mState = TimerState::RESET;
     }
     mCondition.notify_all();
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <thread>
@@ -43,7 +44,11 @@ public:
     void start();
     // Stops the idle timer and any held resources.
     void stop();
-    // Resets the wakeup time and fires the reset callback.
+    // Resets the wakeup time.  While the timer is armed this is a plain
+    // atomic deadline bump -- no lock, no wakeup -- so per-input-event
+    // resets don't churn the timer thread; the thread re-reads the
+    // deadline when its current wait expires.  Only the transition out of
+    // the idle state wakes the thread (and fires the reset callback).
     void reset();
 
 private:
@@ -78,7 +83,13 @@ private:
     std::mutex mMutex;
 
     // Current timer state
-    TimerState mState GUARDED_BY(mMutex) = TimerState::RESET;
+    // Atomic so reset() can check it without the lock; transitions still
+    // happen under mMutex for the condition variable.
+    std::atomic<TimerState> mState = TimerState::RESET;
+
+    // Absolute steady-clock deadline (duration-since-epoch ticks) of the
+    // current wait; bumped lock-free by reset().
+    std::atomic<std::chrono::steady_clock::duration::rep> mDeadline = 0;
 
     // Interval after which timer expires.
     const Interval mInterval;
@@ -50,84 +50,61 @@ std::unique_ptr<LayerHistory::LayerHandle> LayerHistory::createLayer(const std::
                                                                      float maxRefreshRate) {
     const int64_t id = sNextId++;
 
-    std::lock_guard lock(mLock);
-    mInactiveLayerInfos.emplace(id,
-                                std::make_shared<LayerInfo>(name, minRefreshRate, maxRefreshRate));
-    return std::make_unique<LayerHistory::LayerHandle>(*this, id);
+    auto layerInfo = std::make_shared<LayerInfo>(name, minRefreshRate, maxRefreshRate);
+    {
+        std::lock_guard lock(mLock);
+        mLayerInfos.emplace(id, layerInfo);
+    }
+    return std::make_unique<LayerHistory::LayerHandle>(*this, id, std::move(layerInfo));
 }
 
 void LayerHistory::destroyLayer(const int64_t id) {
     std::lock_guard lock(mLock);
-    auto it = mActiveLayerInfos.find(id);
-    if (it != mActiveLayerInfos.end()) {
-        mActiveLayerInfos.erase(it);
-    }
-
-    it = mInactiveLayerInfos.find(id);
-    if (it != mInactiveLayerInfos.end()) {
-        mInactiveLayerInfos.erase(it);
-    }
+    mLayerInfos.erase(id);
 }
 
 void LayerHistory::insert(const std::unique_ptr<LayerHandle>& layerHandle, nsecs_t presentTime,
                           bool isHdr) {
-    std::shared_ptr<LayerInfo> layerInfo;
-    {
-        std::lock_guard lock(mLock);
-        auto layerInfoIterator = mInactiveLayerInfos.find(layerHandle->mId);
-        if (layerInfoIterator != mInactiveLayerInfos.end()) {
-            layerInfo = layerInfoIterator->second;
-            mInactiveLayerInfos.erase(layerInfoIterator);
-            mActiveLayerInfos.insert({layerHandle->mId, layerInfo});
-        } else {
-            layerInfoIterator = mActiveLayerInfos.find(layerHandle->mId);
-            if (layerInfoIterator != mActiveLayerInfos.end()) {
-                layerInfo = layerInfoIterator->second;
-            } else {
-                ALOGW("Inserting information about layer that is not registered: %" PRId64,
-                      layerHandle->mId);
-                return;
-            }
-        }
-    }
-    layerInfo->setLastPresentTime(presentTime);
-    layerInfo->setHDRContent(isHdr);
+    // Straight to the per-layer state; no registry lock on the buffer
+    // update path.
+    LayerInfo& layerInfo = *layerHandle->mLayerInfo;
+    layerInfo.setLastPresentTime(presentTime);
+    layerInfo.setHDRContent(isHdr);
 }
 
 void LayerHistory::setVisibility(const std::unique_ptr<LayerHandle>& layerHandle, bool visible) {
-    std::shared_ptr<LayerInfo> layerInfo;
-    {
-        std::lock_guard lock(mLock);
-        auto layerInfoIterator = mInactiveLayerInfos.find(layerHandle->mId);
-        if (layerInfoIterator != mInactiveLayerInfos.end()) {
-            layerInfo = layerInfoIterator->second;
-            if (visible) {
-                mInactiveLayerInfos.erase(layerInfoIterator);
-                mActiveLayerInfos.insert({layerHandle->mId, layerInfo});
-            }
-        } else {
-            layerInfoIterator = mActiveLayerInfos.find(layerHandle->mId);
-            if (layerInfoIterator != mActiveLayerInfos.end()) {
-                layerInfo = layerInfoIterator->second;
-            } else {
-                ALOGW("Inserting information about layer that is not registered: %" PRId64,
-                      layerHandle->mId);
-                return;
-            }
-        }
-    }
-    layerInfo->setVisibility(visible);
+    layerHandle->mLayerInfo->setVisibility(visible);
 }
 
 std::pair<float, bool> LayerHistory::getDesiredRefreshRateAndHDR() {
     bool isHDR = false;
     float newRefreshRate = 0.f;
+    const int64_t obsoleteEpsilon = systemTime() - scheduler::OBSOLETE_TIME_EPSILON_NS.count();
+
     std::lock_guard lock(mLock);
 
-    removeIrrelevantLayers();
+    // Find the max refresh rate among the layers that were recently
+    // updated.  Hidden layers contribute nothing; a layer whose history
+    // went obsolete drops its (decayed) samples so a later reactivation
+    // starts fresh, mirroring the old active/inactive transition.
+    for (const auto& [layerId, layerInfo] : mLayerInfos) {
+        if (!layerInfo->isVisible()) {
+            // Mirror the old inactive transition: hidden layers restart
+            // with fresh history when they reappear.
+            layerInfo->clearHistory();
+            continue;
+        }
+        if (!layerInfo->getHDRContent() && layerInfo->getLastUpdatedTime() < obsoleteEpsilon) {
+            if (mTraceEnabled) {
+                ALOGD("Layer %s obsolete", layerInfo->getName().c_str());
+                // Make sure to update systrace to indicate that the layer was erased.
+                std::string layerName = "LFPS " + layerInfo->getName();
+                ATRACE_INT(layerName.c_str(), 0);
+            }
+            layerInfo->clearHistory();
+            continue;
+        }
 
-    // Iterate through all layers that have been recently updated, and find the max refresh rate.
-    for (const auto& [layerId, layerInfo] : mActiveLayerInfos) {
         const float layerRefreshRate = layerInfo->getDesiredRefreshRate();
         if (mTraceEnabled) {
             // Store the refresh rate in traces for easy debugging.
@@ -147,44 +124,11 @@ std::pair<float, bool> LayerHistory::getDesiredRefreshRateAndHDR() {
     return {newRefreshRate, isHDR};
 }
 
-void LayerHistory::removeIrrelevantLayers() {
-    const int64_t obsoleteEpsilon = systemTime() - scheduler::OBSOLETE_TIME_EPSILON_NS.count();
-    // Iterator pointing to first element in map
-    auto it = mActiveLayerInfos.begin();
-    while (it != mActiveLayerInfos.end()) {
-        // If last updated was before the obsolete time, remove it.
-        // Keep HDR layer around as long as they are visible.
-        if (!it->second->isVisible() ||
-            (!it->second->getHDRContent() && it->second->getLastUpdatedTime() < obsoleteEpsilon)) {
-            // erase() function returns the iterator of the next
-            // to last deleted element.
-            if (mTraceEnabled) {
-                ALOGD("Layer %s obsolete", it->second->getName().c_str());
-                // Make sure to update systrace to indicate that the layer was erased.
-                std::string layerName = "LFPS " + it->second->getName();
-                ATRACE_INT(layerName.c_str(), 0);
-            }
-            auto id = it->first;
-            auto layerInfo = it->second;
-            layerInfo->clearHistory();
-            mInactiveLayerInfos.insert({id, layerInfo});
-            it = mActiveLayerInfos.erase(it);
-        } else {
-            ++it;
-        }
-    }
-}
-
 void LayerHistory::clearHistory() {
     std::lock_guard lock(mLock);
 
-    auto it = mActiveLayerInfos.begin();
-    while (it != mActiveLayerInfos.end()) {
-        auto id = it->first;
-        auto layerInfo = it->second;
+    for (const auto& [layerId, layerInfo] : mLayerInfos) {
         layerInfo->clearHistory();
-        mInactiveLayerInfos.insert({id, layerInfo});
-        it = mActiveLayerInfos.erase(it);
     }
 }
 
@@ -37,13 +37,18 @@ namespace scheduler {
  */
 class LayerHistory {
 public:
-    // Handle for each layer we keep track of.
+    // Handle for each layer we keep track of.  It holds a direct reference
+    // to the layer's info so the per-buffer-update paths (insert,
+    // setVisibility) go straight to the per-layer state without touching
+    // the registry lock.
     class LayerHandle {
     public:
-        LayerHandle(LayerHistory& lh, int64_t id) : mId(id), mLayerHistory(lh) {}
+        LayerHandle(LayerHistory& lh, int64_t id, std::shared_ptr<LayerInfo> layerInfo)
+              : mId(id), mLayerInfo(std::move(layerInfo)), mLayerHistory(lh) {}
         ~LayerHandle() { mLayerHistory.destroyLayer(mId); }
 
         const int64_t mId;
+        const std::shared_ptr<LayerInfo> mLayerInfo;
 
     private:
         LayerHistory& mLayerHistory;
@@ -72,13 +77,10 @@ public:
     void destroyLayer(const int64_t id);
 
 private:
-    // Removes the layers that have been idle for a given amount of time from mLayerInfos.
-    void removeIrrelevantLayers() REQUIRES(mLock);
-
-    // Information about currently active layers.
+    // Registry of tracked layers.  Only createLayer/destroyLayer and the
+    // per-frame aggregation take this lock; buffer updates never do.
     std::mutex mLock;
-    std::unordered_map<int64_t, std::shared_ptr<LayerInfo>> mActiveLayerInfos GUARDED_BY(mLock);
-    std::unordered_map<int64_t, std::shared_ptr<LayerInfo>> mInactiveLayerInfos GUARDED_BY(mLock);
+    std::unordered_map<int64_t, std::shared_ptr<LayerInfo>> mLayerInfos GUARDED_BY(mLock);
 
     // Each layer has it's own ID. This variable keeps track of the count.
     static std::atomic<int64_t> sNextId;
@@ -53,25 +53,24 @@ MessageQueue::~MessageQueue() = default;
 namespace impl {
 
 void MessageQueue::Handler::dispatchRefresh() {
-    if ((android_atomic_or(eventMaskRefresh, &mEventMask) & eventMaskRefresh) == 0) {
-        mQueue.mLooper->sendMessage(this, Message(MessageQueue::REFRESH));
+    // Wake the poll only on the empty-to-pending transition; if any bit
+    // is still set, a wake is already in flight (or the drain is about to
+    // pick this one up).
+    if (mQueue.mPendingSignals.fetch_or(eventMaskRefresh) == 0) {
+        mQueue.mLooper->wake();
     }
 }
 
 void MessageQueue::Handler::dispatchInvalidate() {
-    if ((android_atomic_or(eventMaskInvalidate, &mEventMask) & eventMaskInvalidate) == 0) {
-        mQueue.mLooper->sendMessage(this, Message(MessageQueue::INVALIDATE));
+    if (mQueue.mPendingSignals.fetch_or(eventMaskInvalidate) == 0) {
+        mQueue.mLooper->wake();
     }
 }
 
 void MessageQueue::Handler::handleMessage(const Message& message) {
     switch (message.what) {
         case INVALIDATE:
-            android_atomic_and(~eventMaskInvalidate, &mEventMask);
-            mQueue.mFlinger->onMessageReceived(message.what);
-            break;
         case REFRESH:
-            android_atomic_and(~eventMaskRefresh, &mEventMask);
             mQueue.mFlinger->onMessageReceived(message.what);
             break;
     }
@@ -118,6 +117,18 @@ void MessageQueue::waitMessage() {
     do {
         IPCThreadState::self()->flushCommands();
         int32_t ret = mLooper->pollOnce(-1);
+
+        // Drain the fast-path signals before interpreting the poll
+        // result; INVALIDATE runs ahead of REFRESH, matching the old
+        // queued order.
+        const uint32_t signals = mPendingSignals.exchange(0, std::memory_order_acq_rel);
+        if (signals & eventMaskInvalidate) {
+            mFlinger->onMessageReceived(INVALIDATE);
+        }
+        if (signals & eventMaskRefresh) {
+            mFlinger->onMessageReceived(REFRESH);
+        }
+
         switch (ret) {
             case Looper::POLL_WAKE:
             case Looper::POLL_CALLBACK:
@@ -21,6 +21,8 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <atomic>
+
 #include <utils/Looper.h>
 #include <utils/Timers.h>
 #include <utils/threads.h>
@@ -99,13 +101,15 @@ public:
 namespace impl {
 
 class MessageQueue final : public android::MessageQueue {
+    // Pending-signal bits for the two per-vsync messages; see
+    // waitMessage().
+    enum { eventMaskInvalidate = 0x1, eventMaskRefresh = 0x2 };
+
     class Handler : public MessageHandler {
-        enum { eventMaskInvalidate = 0x1, eventMaskRefresh = 0x2, eventMaskTransaction = 0x4 };
         MessageQueue& mQueue;
-        int32_t mEventMask;
 
     public:
-        explicit Handler(MessageQueue& queue) : mQueue(queue), mEventMask(0) {}
+        explicit Handler(MessageQueue& queue) : mQueue(queue) {}
         virtual void handleMessage(const Message& message);
         void dispatchRefresh();
         void dispatchInvalidate();
@@ -113,6 +117,14 @@ class MessageQueue final : public android::MessageQueue {
 
     friend class Handler;
 
+    // The INVALIDATE/REFRESH signals bypass the Looper message queue:
+    // dispatch sets a bit and wakes the poll only on the empty-to-pending
+    // transition, and waitMessage() drains the bits directly into
+    // onMessageReceived() -- no per-vsync Message allocation, handler
+    // indirection or queue locking.  Looper messages remain for
+    // postMessage() users and the fd callbacks.
+    std::atomic<uint32_t> mPendingSignals{0};
+
     sp<SurfaceFlinger> mFlinger;
     sp<Looper> mLooper;
     android::EventThread* mEventThread;
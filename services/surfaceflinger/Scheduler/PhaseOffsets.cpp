@@ -98,6 +98,10 @@ PhaseOffsets::PhaseOffsets() {
 
     mOffsets.insert({RefreshRateType::POWER_SAVING, defaultOffsets});
     mOffsets.insert({RefreshRateType::DEFAULT, defaultOffsets});
+    // Intermediate panel rates: the lower one behaves like the default
+    // rate, the higher one like the high-fps rate.
+    mOffsets.insert({RefreshRateType::INTERMEDIATE_1, defaultOffsets});
+    mOffsets.insert({RefreshRateType::INTERMEDIATE_2, highFpsOffsets});
     mOffsets.insert({RefreshRateType::PERFORMANCE, highFpsOffsets});
 
     mOffsetThresholdForNextVsync = phaseOffsetThresholdForNextVsyncNs != -1
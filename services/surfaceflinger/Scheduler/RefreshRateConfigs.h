@@ -35,9 +35,11 @@ namespace scheduler {
 class RefreshRateConfigs {
 public:
     // Enum to indicate which vsync rate to run at. Power saving is intended to be the lowest
-    // (eg. when the screen is in AOD mode or off), default is the old 60Hz, and performance
-    // is the new 90Hz. Eventually we want to have a way for vendors to map these in the configs.
-    enum class RefreshRateType { POWER_SAVING, DEFAULT, PERFORMANCE };
+    // (eg. when the screen is in AOD mode or off), default is the lowest panel rate, and
+    // performance the highest; panels exposing more than two configs slot the intermediate
+    // rates between them in ascending order so content-based selection can pick an exact
+    // multiple of the content rate (a 48/60/90/120 panel lands on 48Hz for 24fps video).
+    enum class RefreshRateType { POWER_SAVING, DEFAULT, INTERMEDIATE_1, INTERMEDIATE_2, PERFORMANCE };
 
     struct RefreshRate {
         // This config ID corresponds to the position of the config in the vector that is stored
@@ -95,38 +97,42 @@ public:
             configIdToVsyncPeriod.emplace_back(i, configs.at(i)->getVsyncPeriod());
         }
 
+        // Ascending refresh rate order.
         std::sort(configIdToVsyncPeriod.begin(), configIdToVsyncPeriod.end(),
                   [](const std::pair<int, nsecs_t>& a, const std::pair<int, nsecs_t>& b) {
                       return a.second > b.second;
                   });
 
-        // When the configs are ordered by the resync rate. We assume that the first one is DEFAULT.
-        nsecs_t vsyncPeriod = configIdToVsyncPeriod[0].second;
-        if (vsyncPeriod != 0) {
+        // Every panel config participates in content-based selection, not
+        // just the first two: the lowest rate is DEFAULT, the highest is
+        // PERFORMANCE, and up to two intermediates slot between them in
+        // ascending order.  Two-config panels keep the historical mapping.
+        const auto addRefreshRate = [&](RefreshRateType type, size_t sortedIndex) {
+            const nsecs_t vsyncPeriod = configIdToVsyncPeriod[sortedIndex].second;
+            if (vsyncPeriod == 0) {
+                return;
+            }
             const float fps = 1e9 / vsyncPeriod;
-            const int configId = configIdToVsyncPeriod[0].first;
-            mRefreshRates.emplace(RefreshRateType::DEFAULT,
+            const int configId = configIdToVsyncPeriod[sortedIndex].first;
+            mRefreshRates.emplace(type,
                                   std::make_shared<RefreshRate>(
                                           RefreshRate{configId, base::StringPrintf("%2.ffps", fps),
                                                       static_cast<uint32_t>(fps),
                                                       configs.at(configId)->getId()}));
-        }
+        };
 
+        addRefreshRate(RefreshRateType::DEFAULT, 0);
         if (configs.size() < 2) {
             return;
         }
-
-        // When the configs are ordered by the resync rate. We assume that the second one is
-        // PERFORMANCE, eg. the higher rate.
-        vsyncPeriod = configIdToVsyncPeriod[1].second;
-        if (vsyncPeriod != 0) {
-            const float fps = 1e9 / vsyncPeriod;
-            const int configId = configIdToVsyncPeriod[1].first;
-            mRefreshRates.emplace(RefreshRateType::PERFORMANCE,
-                                  std::make_shared<RefreshRate>(
-                                          RefreshRate{configId, base::StringPrintf("%2.ffps", fps),
-                                                      static_cast<uint32_t>(fps),
-                                                      configs.at(configId)->getId()}));
+        addRefreshRate(RefreshRateType::PERFORMANCE, configs.size() - 1);
+
+        static constexpr RefreshRateType kIntermediates[] = {RefreshRateType::INTERMEDIATE_1,
+                                                             RefreshRateType::INTERMEDIATE_2};
+        const size_t intermediateCount =
+                std::min<size_t>(configs.size() - 2, sizeof(kIntermediates) / sizeof(kIntermediates[0]));
+        for (size_t i = 0; i < intermediateCount; i++) {
+            addRefreshRate(kIntermediates[i], 1 + i);
         }
     }
 
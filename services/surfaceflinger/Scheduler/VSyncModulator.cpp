@@ -106,7 +106,19 @@ VSyncModulator::Offsets VSyncModulator::getOffsets() {
 }
 
 VSyncModulator::Offsets VSyncModulator::getNextOffsets() {
-    return mOffsetMap.at(getNextOffsetType());
+    Offsets offsets = mOffsetMap.at(getNextOffsetType());
+    offsets.sf += mOffsetAdjustment;
+    offsets.app += mOffsetAdjustment;
+    return offsets;
+}
+
+void VSyncModulator::setOffsetAdjustment(nsecs_t adjustment) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (adjustment == mOffsetAdjustment) {
+        return;
+    }
+    mOffsetAdjustment = adjustment;
+    updateOffsetsLocked();
 }
 
 VSyncModulator::OffsetType VSyncModulator::getNextOffsetType() {
@@ -143,7 +155,9 @@ void VSyncModulator::updateOffsetsLocked() {
 
 void VSyncModulator::flushOffsets() {
     OffsetType type = getNextOffsetType();
-    mOffsets = mOffsetMap.at(type);
+    // Keep getOffsets() consistent with what was handed to the scheduler,
+    // dynamic adjustment included.
+    mOffsets = getNextOffsets();
     if (!mTraceDetailedInfo) {
         return;
     }
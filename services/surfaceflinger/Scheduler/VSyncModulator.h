@@ -97,6 +97,12 @@ public:
     // frame.
     void onRefreshed(bool usedRenderEngine);
 
+    // Applies a bounded dynamic adjustment on top of the configured
+    // offsets: positive values wake the app and SF later (recovering
+    // latency margin), negative values earlier.  Driven by the
+    // phase-offset feedback loop in SurfaceFlinger.
+    void setOffsetAdjustment(nsecs_t adjustment) EXCLUDES(mMutex);
+
     // Returns the offsets that we are currently using
     Offsets getOffsets() EXCLUDES(mMutex);
 
@@ -113,6 +119,7 @@ private:
 
     mutable std::mutex mMutex;
     std::unordered_map<OffsetType, Offsets> mOffsetMap GUARDED_BY(mMutex);
+    nsecs_t mOffsetAdjustment GUARDED_BY(mMutex) = 0;
     nsecs_t mThresholdForNextVsync;
 
     Scheduler* mScheduler = nullptr;
@@ -26,11 +26,16 @@
 #include <cmath>
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <mutex>
 #include <optional>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <cutils/properties.h>
+#include <sys/system_properties.h>
+
+#include <thread>
 #include <log/log.h>
 
 #include <binder/IPCThreadState.h>
@@ -283,6 +288,9 @@ SurfaceFlinger::SurfaceFlinger(Factory& factory, SkipInitializationTag)
         mCompositionEngine(mFactory.createCompositionEngine()) {}
 
 SurfaceFlinger::SurfaceFlinger(Factory& factory) : SurfaceFlinger(factory, SkipInitialization) {
+    mGlCompositionDoneTimeline.setTraceName("fence-gl-composition-done");
+    mDisplayTimeline.setTraceName("fence-display-present");
+
     ALOGI("SurfaceFlinger is starting");
 
     hasSyncFramework = running_without_sync_framework(true);
@@ -347,6 +355,20 @@ SurfaceFlinger::SurfaceFlinger(Factory& factory) : SurfaceFlinger(factory, SkipI
     property_get("debug.sf.showupdates", value, "0");
     mDebugRegion = atoi(value);
 
+    property_get("debug.sf.gpu_partial_updates", value, "0");
+    mUseClientPartialUpdates = atoi(value);
+
+    property_get("debug.sf.parallel_display_composition", value, "0");
+    mParallelDisplayComposition = atoi(value);
+
+    property_get("debug.sf.parallel_latch", value, "0");
+    mParallelBufferLatch = atoi(value);
+
+    property_get("debug.sf.phase_offset_tuning", value, "0");
+    mPhaseOffsetTuning = atoi(value);
+    mMaxPhaseOffsetAdjustment =
+            us2ns(property_get_int32("debug.sf.phase_offset_tuning_max_us", 1500));
+
     ALOGI_IF(mDebugRegion, "showupdates enabled");
 
     // DDMS debugging deprecated (b/120782499)
@@ -565,6 +587,8 @@ void SurfaceFlinger::bootFinished()
     LOG_EVENT_LONG(LOGTAG_SF_STOP_BOOTANIM,
                    ns2ms(systemTime(SYSTEM_TIME_MONOTONIC)));
 
+    startPersistentPropertyWatcher();
+
     postMessageAsync(new LambdaMessage([this]() NO_THREAD_SAFETY_ANALYSIS {
         readPersistentProperties();
         mBootStage = BootStage::FINISHED;
@@ -646,6 +670,18 @@ void SurfaceFlinger::init() {
             new RegionSamplingThread(*this, *mScheduler,
                                      RegionSamplingThread::EnvironmentTimingTunables());
 
+    // The two slow, independent bring-up steps are the composer HAL
+    // connection (HIDL service wait + client creation) and RenderEngine's
+    // EGL/GL driver initialization.  Start the composer connection on a
+    // worker and create RenderEngine inline -- EGL must stay on this thread,
+    // its context is bound to the creating thread -- then join before
+    // registering the callback and processing hotplug, both of which need
+    // the composer on the main thread.
+    std::future<std::unique_ptr<HWComposer>> hwComposerFuture =
+            std::async(std::launch::async, [this] {
+                return getFactory().createHWComposer(getBE().mHwcServiceName);
+            });
+
     // Get a RenderEngine for the given display / config (can't fail)
     int32_t renderEngineFeature = 0;
     renderEngineFeature |= (useColorManagement ?
@@ -664,7 +700,7 @@ void SurfaceFlinger::init() {
 
     LOG_ALWAYS_FATAL_IF(mVrFlingerRequestsDisplay,
             "Starting with vr flinger active is not currently supported.");
-    mCompositionEngine->setHwComposer(getFactory().createHWComposer(getBE().mHwcServiceName));
+    mCompositionEngine->setHwComposer(hwComposerFuture.get());
     mCompositionEngine->getHwComposer().registerCallback(this, getBE().mComposerSequenceId);
     // Process any initial hotplug and resulting display changes.
     processDisplayHotplugEventsLocked();
@@ -749,6 +785,49 @@ void SurfaceFlinger::init() {
     ALOGV("Done initializing");
 }
 
+void SurfaceFlinger::startPersistentPropertyWatcher() {
+    std::call_once(mPersistentPropertyWatcherFlag, [this] {
+        std::thread([this]() NO_THREAD_SAFETY_ANALYSIS {
+            // Re-read the persist.sys.sf.* tunables whenever the system
+            // property area changes, so saturation/color-mode edits take
+            // effect without a reboot.  The global serial bumps on any
+            // property set, so compare raw values and only bother the main
+            // thread when one of ours actually changed.
+            static const char* kWatchedProps[] = {
+                    "persist.sys.sf.color_saturation",
+                    "persist.sys.sf.native_mode",
+                    "persist.sys.sf.color_mode",
+            };
+            constexpr size_t kWatchedCount = sizeof(kWatchedProps) / sizeof(kWatchedProps[0]);
+            std::string lastValues[kWatchedCount];
+            char value[PROPERTY_VALUE_MAX];
+            for (size_t i = 0; i < kWatchedCount; i++) {
+                property_get(kWatchedProps[i], value, "");
+                lastValues[i] = value;
+            }
+
+            uint32_t serial = __system_property_area_serial();
+            while (true) {
+                __system_property_wait(nullptr, serial, &serial, nullptr);
+                bool changed = false;
+                for (size_t i = 0; i < kWatchedCount; i++) {
+                    property_get(kWatchedProps[i], value, "");
+                    if (lastValues[i] != value) {
+                        lastValues[i] = value;
+                        changed = true;
+                    }
+                }
+                if (changed) {
+                    postMessageAsync(new LambdaMessage([this]() NO_THREAD_SAFETY_ANALYSIS {
+                        readPersistentProperties();
+                        repaintEverything();
+                    }));
+                }
+            }
+        }).detach();
+    });
+}
+
 void SurfaceFlinger::readPersistentProperties() {
     Mutex::Autolock _l(mStateLock);
 
@@ -1741,6 +1820,8 @@ void SurfaceFlinger::onMessageReceived(int32_t what) NO_THREAD_SAFETY_ANALYSIS {
                 mTimeStats->incrementMissedFrames();
             }
 
+            tunePhaseOffsets(frameMissed);
+
             if (hwcFrameMissed) {
                 mHwcFrameMissedCount++;
             }
@@ -1825,11 +1906,53 @@ void SurfaceFlinger::handleMessageRefresh() {
     preComposition();
     rebuildLayerStacks();
     calculateWorkingSet();
-    for (const auto& [token, display] : mDisplays) {
-        beginFrame(display);
-        prepareFrame(display);
-        doDebugFlashRegions(display, repaintEverything);
-        doComposition(display, repaintEverything);
+    if (mParallelDisplayComposition && mDisplays.size() > 1) {
+        // Pipelined mode: as soon as a display's validate has fixed its
+        // device/client split, its client-composition layer list is built
+        // on a worker concurrently with the remaining displays' validates
+        // -- the HAL's validate latency stops being dead time.  Building
+        // strictly after the display's own validate means the composition
+        // types the build reads are final, so there is no misprediction
+        // to fall back from.  The draws and present below still serialize
+        // on the GL context and the composer command writer.
+        std::vector<std::future<void>> work;
+        for (const auto& [token, display] : mDisplays) {
+            beginFrame(display);
+            prepareFrame(display);
+
+            auto compositionDisplay = display->getCompositionDisplay();
+            if (!compositionDisplay->getState().isEnabled ||
+                !getHwComposer().hasClientComposition(compositionDisplay->getId())) {
+                continue;
+            }
+            work.push_back(std::async(std::launch::async,
+                                      [this, display = display]() NO_THREAD_SAFETY_ANALYSIS {
+                                          ClientCompositionBuild build;
+                                          build.layers =
+                                                  buildClientCompositionLayers(display,
+                                                                               &build.clearRegion);
+                                          std::lock_guard<std::mutex> lock(
+                                                  mPrebuiltCompositionLock);
+                                          mPrebuiltClientComposition.emplace(display.get(),
+                                                                             std::move(build));
+                                      }));
+        }
+        for (auto& future : work) {
+            future.wait();
+        }
+
+        for (const auto& [token, display] : mDisplays) {
+            doDebugFlashRegions(display, repaintEverything);
+            doComposition(display, repaintEverything);
+        }
+        mPrebuiltClientComposition.clear();
+    } else {
+        for (const auto& [token, display] : mDisplays) {
+            beginFrame(display);
+            prepareFrame(display);
+            doDebugFlashRegions(display, repaintEverything);
+            doComposition(display, repaintEverything);
+        }
     }
 
     logLayerStats();
@@ -1979,6 +2102,48 @@ void SurfaceFlinger::calculateWorkingSet() {
     }
 }
 
+void SurfaceFlinger::tunePhaseOffsets(bool frameMissed) {
+    if (!mPhaseOffsetTuning) {
+        return;
+    }
+
+    mTunerWindowFrames++;
+    if (frameMissed) {
+        mTunerWindowMisses++;
+    }
+    if (mTunerWindowFrames < kTunerWindowSize) {
+        return;
+    }
+
+    const uint32_t misses = mTunerWindowMisses;
+    mTunerWindowFrames = 0;
+    mTunerWindowMisses = 0;
+
+    // One step of latency is reclaimed after two consecutive clean
+    // windows; a window with a miss rate of 1% or more gives back two
+    // steps immediately.  The hysteresis keeps the offsets from
+    // oscillating when the device sits right at its deadline.
+    constexpr nsecs_t kTunerStepNs = 250 * 1000;
+    if (misses == 0) {
+        if (++mTunerCleanWindows >= 2 && mPhaseOffsetAdjustment < mMaxPhaseOffsetAdjustment) {
+            mTunerCleanWindows = 0;
+            mPhaseOffsetAdjustment =
+                    std::min(mPhaseOffsetAdjustment + kTunerStepNs, mMaxPhaseOffsetAdjustment);
+            ATRACE_INT("PhaseOffsetAdjustmentUs", static_cast<int32_t>(ns2us(mPhaseOffsetAdjustment)));
+            mVsyncModulator.setOffsetAdjustment(mPhaseOffsetAdjustment);
+        }
+    } else if (misses * 100 >= kTunerWindowSize) {
+        mTunerCleanWindows = 0;
+        if (mPhaseOffsetAdjustment > 0) {
+            mPhaseOffsetAdjustment = std::max<nsecs_t>(0, mPhaseOffsetAdjustment - 2 * kTunerStepNs);
+            ATRACE_INT("PhaseOffsetAdjustmentUs", static_cast<int32_t>(ns2us(mPhaseOffsetAdjustment)));
+            mVsyncModulator.setOffsetAdjustment(mPhaseOffsetAdjustment);
+        }
+    } else {
+        mTunerCleanWindows = 0;
+    }
+}
+
 void SurfaceFlinger::doDebugFlashRegions(const sp<DisplayDevice>& displayDevice,
                                          bool repaintEverything) {
     auto display = displayDevice->getCompositionDisplay();
@@ -1994,7 +2159,8 @@ void SurfaceFlinger::doDebugFlashRegions(const sp<DisplayDevice>& displayDevice,
         if (!dirtyRegion.isEmpty()) {
             base::unique_fd readyFence;
             // redraw the whole screen
-            doComposeSurfaces(displayDevice, dirtyRegion, &readyFence);
+            doComposeSurfaces(displayDevice, Region(displayState.bounds), dirtyRegion,
+                              &readyFence);
 
             display->getRenderSurface()->queueBuffer(std::move(readyFence));
         }
@@ -3166,13 +3332,71 @@ void SurfaceFlinger::computeVisibleRegions(const sp<const DisplayDevice>& displa
 
     outDirtyRegion.clear();
 
+    /*
+     * Incremental pass: the per-layer visibility caches are only usable if
+     * the traversal for this display contains the same layers, in the same
+     * order, as the previous pass; additions, removals and reorderings
+     * fall back to a full recompute.
+     */
+    std::vector<Layer*> traversal;
     mDrawingState.traverseInReverseZOrder([&](Layer* layer) {
+        if (display->belongsInOutput(layer->getLayerStack(), layer->getPrimaryDisplayOnly())) {
+            traversal.push_back(layer);
+        }
+    });
+    std::vector<Layer*>& prevTraversal = mVisibleRegionTraversals[displayDevice.get()];
+    const bool cacheUsable = (traversal == prevTraversal);
+    prevTraversal = traversal;
+
+    /*
+     * Screen-space area in which the occlusion inputs of lower layers have
+     * changed since the previous pass; a layer whose footprint does not
+     * intersect it (and whose own inputs are unchanged) reuses its cached
+     * regions instead of re-running the Region algebra.
+     */
+    Region changedAbove;
+
+    for (Layer* layer : traversal) {
         // start with the whole surface at its current location
         const Layer::State& s(layer->getDrawingState());
 
-        // only consider the layers on the given layer stack
-        if (!display->belongsInOutput(layer->getLayerStack(), layer->getPrimaryDisplayOnly())) {
-            return;
+        Layer::VisibilityCache& cache = layer->visibilityCache;
+        const bool cacheHit =
+                cacheUsable && cache.valid && cache.display == displayDevice.get();
+        const bool visibleNow = CC_LIKELY(layer->isVisible());
+
+        if (cacheHit && !visibleNow && !cache.visible) {
+            // Still hidden; contributes nothing to the accumulators.
+            layer->clearVisibilityRegions();
+            continue;
+        }
+
+        if (cacheHit && visibleNow && cache.visible) {
+            const bool translucent = !layer->isOpaque(s);
+            const Rect bounds(layer->getScreenBounds());
+            ui::Transform tr = layer->getTransform();
+            const uint32_t layerOrientation = tr.getOrientation();
+            bool inputsUnchanged = bounds == cache.bounds && translucent == cache.translucent &&
+                    layer->getAlpha() == cache.alpha &&
+                    layer->getRoundedCornerState().radius == cache.cornerRadius &&
+                    layerOrientation == cache.orientation;
+            if (inputsUnchanged && translucent && tr.preserveRects()) {
+                inputsUnchanged = tr.transform(layer->getActiveTransparentRegion(s))
+                                          .isTriviallyEqual(cache.transparentRegion);
+            }
+            if (inputsUnchanged && changedAbove.intersect(bounds).isEmpty()) {
+                // The cached regions are still valid: replay this layer's
+                // accumulator contributions and its content-dirty damage.
+                aboveCoveredLayers.orSelf(bounds);
+                if (layer->contentDirty) {
+                    // Geometry is unchanged, so old and new visible
+                    // regions coincide.
+                    outDirtyRegion.orSelf(layer->visibleRegion);
+                    layer->contentDirty = false;
+                }
+                aboveOpaqueLayers.orSelf(cache.opaqueRegion);
+                continue;
+            }
         }
 
         /*
@@ -3206,9 +3430,12 @@ void SurfaceFlinger::computeVisibleRegions(const sp<const DisplayDevice>& displa
 
 
         // handle hidden surfaces by setting the visible region to empty
-        if (CC_LIKELY(layer->isVisible())) {
-            const bool translucent = !layer->isOpaque(s);
-            Rect bounds(layer->getScreenBounds());
+        bool translucent = false;
+        Rect bounds(Rect::EMPTY_RECT);
+        uint32_t layerOrientation = 0;
+        if (visibleNow) {
+            translucent = !layer->isOpaque(s);
+            bounds = layer->getScreenBounds();
 
             visibleRegion.set(bounds);
             ui::Transform tr = layer->getTransform();
@@ -3226,7 +3453,7 @@ void SurfaceFlinger::computeVisibleRegions(const sp<const DisplayDevice>& displa
                 }
 
                 // compute the opaque region
-                const int32_t layerOrientation = tr.getOrientation();
+                layerOrientation = tr.getOrientation();
                 if (layer->getAlpha() == 1.0f && !translucent &&
                         layer->getRoundedCornerState().radius == 0.0f &&
                         ((layerOrientation & ui::Transform::ROT_INVALID) == false)) {
@@ -3237,8 +3464,17 @@ void SurfaceFlinger::computeVisibleRegions(const sp<const DisplayDevice>& displa
         }
 
         if (visibleRegion.isEmpty()) {
+            // The area this layer used to occupy must be re-resolved by
+            // the layers below it.
+            changedAbove.orSelf(layer->visibleRegion);
+            if (cache.valid && cache.display == displayDevice.get()) {
+                changedAbove.orSelf(cache.bounds);
+            }
+            cache.valid = true;
+            cache.display = displayDevice.get();
+            cache.visible = false;
             layer->clearVisibilityRegions();
-            return;
+            continue;
         }
 
         // Clip the covered region to the visible region
@@ -3284,12 +3520,29 @@ void SurfaceFlinger::computeVisibleRegions(const sp<const DisplayDevice>& displa
         // Update aboveOpaqueLayers for next (lower) layer
         aboveOpaqueLayers.orSelf(opaqueRegion);
 
+        // Expose the old and new footprints to the layers below and
+        // refresh the cache for the next pass.
+        if (cache.valid && cache.display == displayDevice.get()) {
+            changedAbove.orSelf(cache.bounds);
+        }
+        changedAbove.orSelf(bounds);
+        cache.valid = true;
+        cache.display = displayDevice.get();
+        cache.visible = true;
+        cache.bounds = bounds;
+        cache.translucent = translucent;
+        cache.alpha = layer->getAlpha();
+        cache.cornerRadius = layer->getRoundedCornerState().radius;
+        cache.orientation = layerOrientation;
+        cache.transparentRegion = transparentRegion;
+        cache.opaqueRegion = opaqueRegion;
+
         // Store the visible region in screen space
         layer->setVisibleRegion(visibleRegion);
         layer->setCoveredRegion(coveredRegion);
         layer->setVisibleNonTransparentRegion(
                 visibleRegion.subtract(transparentRegion));
-    });
+    }
 
     outOpaqueRegion = aboveOpaqueLayers;
 }
@@ -3343,13 +3596,64 @@ bool SurfaceFlinger::handlePageFlip()
         // writes to Layer current state. See also b/119481871
         Mutex::Autolock lock(mStateLock);
 
-        for (auto& layer : mLayersWithQueuedFrames) {
-            if (layer->latchBuffer(visibleRegions, latchTime)) {
-                mLayersPendingRefresh.push_back(layer);
+        if (mParallelBufferLatch && mLayersWithQueuedFrames.size() > 1 &&
+            getRenderEngine().useNativeFenceSync()) {
+            // Latch independent layers on workers: each layer owns its
+            // consumer, the shared sinks (TimeStats, the RenderEngine
+            // image cache, scheduler wakeups) are internally
+            // synchronized, and with native fence sync no GL binding
+            // happens at latch time.  Each layer latches exactly once
+            // here, so per-layer acquisition order is untouched; results
+            // are folded back in the original order below.
+            struct LatchResult {
+                bool refresh = false;
+                bool visibleRegions = false;
+            };
+            std::vector<LatchResult> results(mLayersWithQueuedFrames.size());
+            const size_t workerCount =
+                    std::min<size_t>(mLayersWithQueuedFrames.size(),
+                                     std::max(1u, std::thread::hardware_concurrency()));
+            std::vector<std::future<void>> work;
+            work.reserve(workerCount);
+            for (size_t worker = 0; worker < workerCount; worker++) {
+                work.push_back(std::async(std::launch::async,
+                                          [&, worker]() NO_THREAD_SAFETY_ANALYSIS {
+                                              for (size_t i = worker;
+                                                   i < mLayersWithQueuedFrames.size();
+                                                   i += workerCount) {
+                                                  bool layerVisibleRegions = false;
+                                                  results[i].refresh =
+                                                          mLayersWithQueuedFrames[i]
+                                                                  ->latchBuffer(layerVisibleRegions,
+                                                                                latchTime);
+                                                  results[i].visibleRegions = layerVisibleRegions;
+                                              }
+                                          }));
             }
-            layer->useSurfaceDamage();
-            if (layer->isBufferLatched()) {
-                newDataLatched = true;
+            for (auto& future : work) {
+                future.wait();
+            }
+
+            for (size_t i = 0; i < mLayersWithQueuedFrames.size(); i++) {
+                auto& layer = mLayersWithQueuedFrames[i];
+                visibleRegions |= results[i].visibleRegions;
+                if (results[i].refresh) {
+                    mLayersPendingRefresh.push_back(layer);
+                }
+                layer->useSurfaceDamage();
+                if (layer->isBufferLatched()) {
+                    newDataLatched = true;
+                }
+            }
+        } else {
+            for (auto& layer : mLayersWithQueuedFrames) {
+                if (layer->latchBuffer(visibleRegions, latchTime)) {
+                    mLayersPendingRefresh.push_back(layer);
+                }
+                layer->useSurfaceDamage();
+                if (layer->isBufferLatched()) {
+                    newDataLatched = true;
+                }
             }
         }
     }
@@ -3392,14 +3696,88 @@ void SurfaceFlinger::doDisplayComposition(const sp<DisplayDevice>& displayDevice
 
     ALOGV("doDisplayComposition");
     base::unique_fd readyFence;
-    if (!doComposeSurfaces(displayDevice, Region::INVALID_REGION, &readyFence)) return;
+    if (!doComposeSurfaces(displayDevice, inDirtyRegion, Region::INVALID_REGION, &readyFence)) {
+        return;
+    }
 
     // swap buffers (presentation)
     display->getRenderSurface()->queueBuffer(std::move(readyFence));
 }
 
+std::vector<renderengine::LayerSettings> SurfaceFlinger::buildClientCompositionLayers(
+        const sp<DisplayDevice>& displayDevice, Region* outClearRegion) {
+    ATRACE_CALL();
+
+    auto display = displayDevice->getCompositionDisplay();
+    const auto& displayState = display->getState();
+    const auto displayId = display->getId();
+    const bool supportProtectedContent = getRenderEngine().supportsProtectedContent();
+    const DisplayRenderArea renderArea(displayDevice);
+    const bool hasClientComposition = getHwComposer().hasClientComposition(displayId);
+
+    std::vector<renderengine::LayerSettings> clientCompositionLayers;
+    Region clearRegion = Region::INVALID_REGION;
+    bool firstLayer = true;
+    for (auto& layer : displayDevice->getVisibleLayersSortedByZ()) {
+        const Region viewportRegion(displayState.viewport);
+        const Region clip(viewportRegion.intersect(layer->visibleRegion));
+        ALOGV("Layer: %s", layer->getName().string());
+        ALOGV("  Composition type: %s", toString(layer->getCompositionType(displayDevice)).c_str());
+        if (!clip.isEmpty()) {
+            switch (layer->getCompositionType(displayDevice)) {
+                case Hwc2::IComposerClient::Composition::CURSOR:
+                case Hwc2::IComposerClient::Composition::DEVICE:
+                case Hwc2::IComposerClient::Composition::SIDEBAND:
+                case Hwc2::IComposerClient::Composition::SOLID_COLOR: {
+                    LOG_ALWAYS_FATAL_IF(!displayId);
+                    const Layer::State& state(layer->getDrawingState());
+                    if (layer->getClearClientTarget(displayDevice) && !firstLayer &&
+                        layer->isOpaque(state) && (layer->getAlpha() == 1.0f) &&
+                        layer->getRoundedCornerState().radius == 0.0f && hasClientComposition) {
+                        // never clear the very first layer since we're
+                        // guaranteed the FB is already cleared
+                        renderengine::LayerSettings layerSettings;
+                        Region dummyRegion;
+                        bool prepared =
+                                layer->prepareClientLayer(renderArea, clip, dummyRegion,
+                                                          supportProtectedContent, layerSettings);
+
+                        if (prepared) {
+                            layerSettings.source.buffer.buffer = nullptr;
+                            layerSettings.source.solidColor = half3(0.0, 0.0, 0.0);
+                            layerSettings.alpha = half(0.0);
+                            layerSettings.disableBlending = true;
+                            clientCompositionLayers.push_back(layerSettings);
+                        }
+                    }
+                    break;
+                }
+                case Hwc2::IComposerClient::Composition::CLIENT: {
+                    renderengine::LayerSettings layerSettings;
+                    bool prepared =
+                            layer->prepareClientLayer(renderArea, clip, clearRegion,
+                                                      supportProtectedContent, layerSettings);
+                    if (prepared) {
+                        clientCompositionLayers.push_back(layerSettings);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        } else {
+            ALOGV("  Skipping for empty clip");
+        }
+        firstLayer = false;
+    }
+
+    *outClearRegion = clearRegion;
+    return clientCompositionLayers;
+}
+
 bool SurfaceFlinger::doComposeSurfaces(const sp<DisplayDevice>& displayDevice,
-                                       const Region& debugRegion, base::unique_fd* readyFence) {
+                                       const Region& dirtyRegion, const Region& debugRegion,
+                                       base::unique_fd* readyFence) {
     ATRACE_CALL();
     ALOGV("doComposeSurfaces");
 
@@ -3410,7 +3788,6 @@ bool SurfaceFlinger::doComposeSurfaces(const sp<DisplayDevice>& displayDevice,
     const bool supportProtectedContent = renderEngine.supportsProtectedContent();
 
     const Region bounds(displayState.bounds);
-    const DisplayRenderArea renderArea(displayDevice);
     const bool hasClientComposition = getHwComposer().hasClientComposition(displayId);
     ATRACE_INT("hasClientComposition", hasClientComposition);
 
@@ -3484,65 +3861,49 @@ bool SurfaceFlinger::doComposeSurfaces(const sp<DisplayDevice>& displayDevice,
      */
 
     ALOGV("Rendering client layers");
-    bool firstLayer = true;
     Region clearRegion = Region::INVALID_REGION;
-    for (auto& layer : displayDevice->getVisibleLayersSortedByZ()) {
-        const Region viewportRegion(displayState.viewport);
-        const Region clip(viewportRegion.intersect(layer->visibleRegion));
-        ALOGV("Layer: %s", layer->getName().string());
-        ALOGV("  Composition type: %s", toString(layer->getCompositionType(displayDevice)).c_str());
-        if (!clip.isEmpty()) {
-            switch (layer->getCompositionType(displayDevice)) {
-                case Hwc2::IComposerClient::Composition::CURSOR:
-                case Hwc2::IComposerClient::Composition::DEVICE:
-                case Hwc2::IComposerClient::Composition::SIDEBAND:
-                case Hwc2::IComposerClient::Composition::SOLID_COLOR: {
-                    LOG_ALWAYS_FATAL_IF(!displayId);
-                    const Layer::State& state(layer->getDrawingState());
-                    if (layer->getClearClientTarget(displayDevice) && !firstLayer &&
-                        layer->isOpaque(state) && (layer->getAlpha() == 1.0f) &&
-                        layer->getRoundedCornerState().radius == 0.0f && hasClientComposition) {
-                        // never clear the very first layer since we're
-                        // guaranteed the FB is already cleared
-                        renderengine::LayerSettings layerSettings;
-                        Region dummyRegion;
-                        bool prepared =
-                                layer->prepareClientLayer(renderArea, clip, dummyRegion,
-                                                          supportProtectedContent, layerSettings);
-
-                        if (prepared) {
-                            layerSettings.source.buffer.buffer = nullptr;
-                            layerSettings.source.solidColor = half3(0.0, 0.0, 0.0);
-                            layerSettings.alpha = half(0.0);
-                            layerSettings.disableBlending = true;
-                            clientCompositionLayers.push_back(layerSettings);
-                        }
-                    }
-                    break;
-                }
-                case Hwc2::IComposerClient::Composition::CLIENT: {
-                    renderengine::LayerSettings layerSettings;
-                    bool prepared =
-                            layer->prepareClientLayer(renderArea, clip, clearRegion,
-                                                      supportProtectedContent, layerSettings);
-                    if (prepared) {
-                        clientCompositionLayers.push_back(layerSettings);
-                    }
-                    break;
-                }
-                default:
-                    break;
-            }
+    {
+        auto prebuilt = mPrebuiltClientComposition.find(displayDevice.get());
+        if (prebuilt != mPrebuiltClientComposition.end()) {
+            clientCompositionLayers = std::move(prebuilt->second.layers);
+            clearRegion = prebuilt->second.clearRegion;
+            mPrebuiltClientComposition.erase(prebuilt);
         } else {
-            ALOGV("  Skipping for empty clip");
+            clientCompositionLayers = buildClientCompositionLayers(displayDevice, &clearRegion);
         }
-        firstLayer = false;
     }
 
     // Perform some cleanup steps if we used client composition.
     if (hasClientComposition) {
         clientCompositionDisplay.clearRegion = clearRegion;
 
+        if (mUseClientPartialUpdates && displayId) {
+            // The buffer we just dequeued is as old as the framebuffer
+            // rotation depth, so everything that changed since it was
+            // last rendered is this frame's damage plus that of the
+            // frames before it, in framebuffer space.  The accumulated
+            // region is only trusted once the history is full -- i.e.
+            // the previous frames were all client-composed; otherwise
+            // (and on repaint-everything, which arrives as a
+            // full-viewport dirty region) RenderEngine does a full draw.
+            const size_t depth = maxFrameBufferAcquiredBuffers > 1
+                    ? static_cast<size_t>(maxFrameBufferAcquiredBuffers) - 1
+                    : 1;
+            const Region frameDamage = displayState.transform.transform(dirtyRegion);
+            auto& history = mClientCompositionDamage[displayDevice.get()];
+            if (history.size() >= depth) {
+                Region accumulated(frameDamage);
+                for (const Region& past : history) {
+                    accumulated.orSelf(past);
+                }
+                clientCompositionDisplay.damageRegion = accumulated;
+            }
+            history.push_front(frameDamage);
+            while (history.size() > depth) {
+                history.pop_back();
+            }
+        }
+
         // We boost GPU frequency here because there will be color spaces conversion
         // and it's expensive. We boost the GPU frequency so that GPU composition can
         // finish in time. We must reset GPU frequency afterwards, because high frequency
@@ -3569,6 +3930,11 @@ bool SurfaceFlinger::doComposeSurfaces(const sp<DisplayDevice>& displayDevice,
                                 buf->getNativeBuffer(), /*useFramebufferCache=*/true, std::move(fd),
                                 readyFence);
     } else if (displayId) {
+        // The GPU buffers stop being rendered while HWC composes, so any
+        // accumulated damage history goes stale.
+        if (mUseClientPartialUpdates) {
+            mClientCompositionDamage.erase(displayDevice.get());
+        }
         mPowerAdvisor.setExpensiveRenderingExpected(*displayId, false);
     }
     return true;
@@ -3654,6 +4020,17 @@ uint32_t SurfaceFlinger::setTransactionFlags(uint32_t flags,
     return old;
 }
 
+// Normalized ordering key for a queued transaction: heads that should be
+// applied at the next opportunity -- no desired present time, or a timestamp
+// far enough in the future that the stability rule ignores it -- sort first.
+int64_t SurfaceFlinger::transactionQueueKey(const TransactionState& transaction) {
+    if (transaction.desiredPresentTime < 0 ||
+        transaction.desiredPresentTime >= transaction.postTime + s2ns(1)) {
+        return 0;
+    }
+    return transaction.desiredPresentTime;
+}
+
 bool SurfaceFlinger::flushTransactionQueues() {
     // to prevent onHandleDestroyed from being called while the lock is held,
     // we must keep a copy of the transactions (specifically the composer
@@ -3663,9 +4040,25 @@ bool SurfaceFlinger::flushTransactionQueues() {
     {
         Mutex::Autolock _l(mStateLock);
 
-        auto it = mTransactionQueues.begin();
-        while (it != mTransactionQueues.end()) {
-            auto& [applyToken, transactionQueue] = *it;
+        const nsecs_t expectedPresentTime = getExpectedPresentTime();
+        // Walk only the queues whose head is due.  The index is ordered by
+        // head desired-present-time, so tokens scheduled several frames
+        // ahead are skipped wholesale rather than rescanned every
+        // invalidate.  Queues whose head stays blocked (fence not signaled,
+        // or still inside its presentation window) are re-indexed after the
+        // walk so this loop cannot revisit them in the same pass.
+        std::vector<std::pair<int64_t, sp<IBinder>>> blocked;
+        auto indexIt = mPendingTransactionHeads.begin();
+        while (indexIt != mPendingTransactionHeads.end() &&
+               indexIt->first <= expectedPresentTime) {
+            const sp<IBinder> applyToken = indexIt->second;
+            indexIt = mPendingTransactionHeads.erase(indexIt);
+
+            auto it = mTransactionQueues.find(applyToken);
+            if (it == mTransactionQueues.end()) {
+                continue;
+            }
+            auto& transactionQueue = it->second;
 
             while (!transactionQueue.empty()) {
                 const auto& transaction = transactionQueue.front();
@@ -3685,12 +4078,22 @@ bool SurfaceFlinger::flushTransactionQueues() {
             }
 
             if (transactionQueue.empty()) {
-                it = mTransactionQueues.erase(it);
+                mTransactionQueues.erase(it);
                 mTransactionCV.broadcast();
             } else {
-                it = std::next(it, 1);
+                blocked.emplace_back(transactionQueueKey(transactionQueue.front()), applyToken);
             }
         }
+        for (auto& entry : blocked) {
+            mPendingTransactionHeads.emplace(entry.first, std::move(entry.second));
+        }
+
+        if (!mTransactionQueues.empty()) {
+            // Queues the index skipped as not-yet-due were never visited
+            // above, so they must rearm the flush themselves or nothing
+            // schedules the invalidate that will eventually apply them.
+            setTransactionFlags(eTransactionFlushNeeded);
+        }
     }
     return flushedATransaction;
 }
@@ -3780,9 +4183,17 @@ void SurfaceFlinger::setTransactionState(const Vector<ComposerState>& states,
     }
     if (itr != mTransactionQueues.end() ||
         !transactionIsReadyToBeApplied(desiredPresentTime, states)) {
-        mTransactionQueues[applyToken].emplace(states, displays, flags, desiredPresentTime,
-                                               uncacheBuffer, listenerCallbacks, postTime,
-                                               privileged);
+        auto& queue = mTransactionQueues[applyToken];
+        queue.emplace(states, displays, flags, desiredPresentTime, uncacheBuffer,
+                      listenerCallbacks, postTime, privileged);
+        if (queue.size() == 1) {
+            // new non-empty queue: index it by its head
+            mPendingTransactionHeads.emplace(transactionQueueKey(queue.front()), applyToken);
+        }
+        mTransactionsDeferred++;
+        if (queue.size() > mPeakTransactionQueueDepth) {
+            mPeakTransactionQueueDepth = queue.size();
+        }
         setTransactionFlags(eTransactionFlushNeeded);
         return;
     }
@@ -3831,11 +4242,8 @@ void SurfaceFlinger::applyTransactionState(const Vector<ComposerState>& states,
         mTransactionCompletedThread.addCallback(listener, callbackIds);
     }
 
-    uint32_t clientStateFlags = 0;
-    for (const ComposerState& state : states) {
-        clientStateFlags |= setClientStateLocked(state, desiredPresentTime, listenerCallbacks,
-                                                 postTime, privileged);
-    }
+    uint32_t clientStateFlags = applyClientStatesLocked(states, desiredPresentTime,
+                                                        listenerCallbacks, postTime, privileged);
 
     // If the state doesn't require a traversal and there are callbacks, send them now
     if (!(clientStateFlags & eTraversalNeeded) && !listenerCallbacks.empty()) {
@@ -3965,6 +4373,125 @@ bool SurfaceFlinger::callingThreadHasUnscopedSurfaceFlingerAccess() {
     return true;
 }
 
+uint32_t SurfaceFlinger::applyClientStatesLocked(
+        const Vector<ComposerState>& states, int64_t desiredPresentTime,
+        const std::vector<ListenerCallbacks>& listenerCallbacks, int64_t postTime,
+        bool privileged) {
+    // Changes that only touch state owned by the targeted layer.  Z-order,
+    // hierarchy, layer-stack, barrier, buffer and callback changes all
+    // update shared structures (mCurrentState.layersSortedByZ, parents,
+    // TransactionCompletedThread) and must stay on the calling thread.
+    constexpr uint64_t kSubtreeLocalChanges = layer_state_t::ePositionChanged |
+            layer_state_t::eSizeChanged | layer_state_t::eAlphaChanged |
+            layer_state_t::eColorChanged | layer_state_t::eColorTransformChanged |
+            layer_state_t::eMatrixChanged | layer_state_t::eTransparentRegionChanged |
+            layer_state_t::eFlagsChanged | layer_state_t::eCropChanged_legacy |
+            layer_state_t::eCornerRadiusChanged | layer_state_t::eTransformChanged |
+            layer_state_t::eTransformToDisplayInverseChanged | layer_state_t::eCropChanged |
+            layer_state_t::eFrameChanged | layer_state_t::eDataspaceChanged;
+
+    // Below this size the partitioning bookkeeping costs more than it saves.
+    constexpr size_t kParallelStateThreshold = 16;
+
+    uint32_t flags = 0;
+
+    // Transactions carrying completion callbacks keep their registration
+    // order; don't reorder anything in that case.
+    if (states.size() < kParallelStateThreshold || !listenerCallbacks.empty()) {
+        for (const ComposerState& state : states) {
+            flags |= setClientStateLocked(state, desiredPresentTime, listenerCallbacks, postTime,
+                                          privileged);
+        }
+        return flags;
+    }
+
+    // First pass: resolve each state's layer and find layers that have any
+    // non-local state; such layers keep all of their states sequential so
+    // per-layer submission order is preserved.
+    std::vector<Layer*> resolvedLayers;
+    resolvedLayers.reserve(states.size());
+    std::unordered_set<Layer*> sequentialLayers;
+    for (const ComposerState& state : states) {
+        sp<Client> client(static_cast<Client*>(state.client.get()));
+        sp<Layer> layer =
+                client != nullptr ? client->getLayerUser(state.state.surface) : nullptr;
+        resolvedLayers.push_back(layer.get());
+        if (layer != nullptr && (state.state.what & ~kSubtreeLocalChanges) != 0) {
+            sequentialLayers.insert(layer.get());
+        }
+    }
+
+    // Second pass: partition parallel-eligible states by the root of the
+    // subtree they touch so no two workers ever share a layer or a parent
+    // chain; everything else stays in submission order.
+    std::unordered_map<Layer*, std::vector<const ComposerState*>> subtrees;
+    std::vector<const ComposerState*> sequentialStates;
+    for (size_t i = 0; i < states.size(); i++) {
+        const ComposerState& state = states[i];
+        Layer* layer = resolvedLayers[i];
+        if (layer == nullptr || (state.state.what & ~kSubtreeLocalChanges) != 0 ||
+            sequentialLayers.count(layer) != 0) {
+            sequentialStates.push_back(&state);
+            continue;
+        }
+        sp<Layer> root = layer;
+        for (sp<Layer> parent = root->getParent(); parent != nullptr;
+             parent = root->getParent()) {
+            root = parent;
+        }
+        subtrees[root.get()].push_back(&state);
+    }
+
+    std::vector<std::vector<const ComposerState*>> groups;
+    groups.reserve(subtrees.size());
+    for (auto& [root, groupStates] : subtrees) {
+        groups.push_back(std::move(groupStates));
+    }
+
+    if (groups.size() > 1) {
+        const size_t workerCount =
+                std::min<size_t>(groups.size(),
+                                 std::max(1u, std::thread::hardware_concurrency()));
+        std::atomic<uint32_t> parallelFlags{0};
+        std::vector<std::future<void>> work;
+        work.reserve(workerCount);
+        for (size_t worker = 0; worker < workerCount; worker++) {
+            // mStateLock is held by the calling thread for the lifetime of
+            // the workers, so the annotated requirement is satisfied.
+            work.push_back(std::async(std::launch::async, [&, worker]() NO_THREAD_SAFETY_ANALYSIS {
+                uint32_t workerStateFlags = 0;
+                for (size_t i = worker; i < groups.size(); i += workerCount) {
+                    for (const ComposerState* state : groups[i]) {
+                        workerStateFlags |=
+                                setClientStateLocked(*state, desiredPresentTime,
+                                                     listenerCallbacks, postTime, privileged);
+                    }
+                }
+                parallelFlags.fetch_or(workerStateFlags, std::memory_order_relaxed);
+            }));
+        }
+        for (auto& future : work) {
+            future.wait();
+        }
+        flags |= parallelFlags.load(std::memory_order_relaxed);
+    } else {
+        for (const auto& groupStates : groups) {
+            for (const ComposerState* state : groupStates) {
+                flags |= setClientStateLocked(*state, desiredPresentTime, listenerCallbacks,
+                                              postTime, privileged);
+            }
+        }
+    }
+
+    // Short sequential publish step for everything touching shared state.
+    for (const ComposerState* state : sequentialStates) {
+        flags |= setClientStateLocked(*state, desiredPresentTime, listenerCallbacks, postTime,
+                                      privileged);
+    }
+
+    return flags;
+}
+
 uint32_t SurfaceFlinger::setClientStateLocked(
         const ComposerState& composerState, int64_t desiredPresentTime,
         const std::vector<ListenerCallbacks>& listenerCallbacks, int64_t postTime,
@@ -4654,12 +5181,17 @@ status_t SurfaceFlinger::doDump(int fd, const DumpArgs& args,
 
         const auto flag = args.empty() ? ""s : std::string(String8(args[0]));
 
+        std::optional<LayersProto> deferredLayersProto;
         if (const auto it = dumpers.find(flag); it != dumpers.end()) {
             (it->second)(args, asProto, result);
         } else {
             if (asProto) {
-                LayersProto layersProto = dumpProtoInfo(LayerVector::StateSet::Current);
-                result.append(layersProto.SerializeAsString().c_str(), layersProto.ByteSize());
+                // The proto object is itself the snapshot; building it
+                // needs the state lock but flattening it to bytes does
+                // not, and for deep layer trees the flattening is the
+                // bigger half.  Defer it to after the unlock so frequent
+                // winscope pulls stop stalling the main thread.
+                deferredLayersProto = dumpProtoInfo(LayerVector::StateSet::Current);
             } else {
                 dumpAllLocked(args, result);
             }
@@ -4668,6 +5200,11 @@ status_t SurfaceFlinger::doDump(int fd, const DumpArgs& args,
         if (locked) {
             mStateLock.unlock();
         }
+
+        if (deferredLayersProto) {
+            result.append(deferredLayersProto->SerializeAsString().c_str(),
+                          deferredLayersProto->ByteSize());
+        }
     }
     write(fd, result.c_str(), result.size());
     return NO_ERROR;
@@ -4977,6 +5514,11 @@ void SurfaceFlinger::dumpAllLocked(const DumpArgs& args, std::string& result) co
     result.append("\nWide-Color information:\n");
     dumpWideColorInfo(result);
 
+    StringAppendF(&result,
+                  "\nTransaction scheduling: %" PRIu64 " deferred, peak queue depth %zu, "
+                  "%zu token(s) pending\n",
+                  mTransactionsDeferred, mPeakTransactionQueueDepth, mTransactionQueues.size());
+
     colorizer.bold(result);
     result.append("Sync configuration: ");
     colorizer.reset(result);
@@ -5043,6 +5585,7 @@ void SurfaceFlinger::dumpAllLocked(const DumpArgs& args, std::string& result) co
     colorizer.reset(result);
 
     getRenderEngine().dump(result);
+    ClientCache::getInstance().dump(result);
 
     DebugEGLImageTracker::getInstance()->dump(result);
 
@@ -6009,12 +6552,107 @@ status_t SurfaceFlinger::captureScreenCommon(RenderArea& renderArea,
     return result;
 }
 
+bool SurfaceFlinger::captureSingleBufferLayerDirect(const RenderArea& renderArea,
+                                                    TraverseLayersFunction traverseLayers,
+                                                    ANativeWindowBuffer* buffer, int* outSyncFd) {
+    // Thumbnailing and recording services often capture exactly one
+    // full-frame opaque buffer layer; that case needs no GL pass at all,
+    // just a pixel copy, when the geometry is the identity and both
+    // buffers are CPU-mappable.
+    Layer* single = nullptr;
+    size_t layerCount = 0;
+    traverseLayers([&](Layer* layer) {
+        layerCount++;
+        single = layer;
+    });
+    if (layerCount != 1 || single == nullptr) {
+        return false;
+    }
+
+    const sp<GraphicBuffer>& source = single->getActiveBuffer();
+    if (source == nullptr) {
+        return false;
+    }
+    GraphicBuffer* dest = GraphicBuffer::from(buffer);
+
+    const auto reqWidth = static_cast<uint32_t>(renderArea.getReqWidth());
+    const auto reqHeight = static_cast<uint32_t>(renderArea.getReqHeight());
+    const Rect sourceCrop = renderArea.getSourceCrop();
+    const Rect fullSource(source->getWidth(), source->getHeight());
+
+    if (renderArea.needsFiltering() || renderArea.getRotationFlags() != ui::Transform::ROT_0 ||
+        renderArea.getTransform().getType() != 0 /* identity */) {
+        return false;
+    }
+    if (reqWidth != source->getWidth() || reqHeight != source->getHeight() ||
+        (!sourceCrop.isEmpty() && sourceCrop != fullSource)) {
+        return false;
+    }
+    if (!single->isOpaque(single->getDrawingState()) || single->getAlpha() != 1.0f ||
+        single->getRoundedCornerState().radius > 0.0f ||
+        single->getActiveBufferTransform() != 0 ||
+        single->getDrawingState().hasColorTransform) {
+        return false;
+    }
+    // No dataspace conversion either: the copy must be bit-exact.
+    const ui::Dataspace layerDataspace = single->getDataSpace();
+    const ui::Dataspace reqDataspace = renderArea.getReqDataSpace();
+    if (reqDataspace != layerDataspace &&
+        !(reqDataspace == ui::Dataspace::V0_SRGB &&
+          (layerDataspace == ui::Dataspace::UNKNOWN || layerDataspace == ui::Dataspace::SRGB))) {
+        return false;
+    }
+    if (source->getPixelFormat() != PIXEL_FORMAT_RGBA_8888 ||
+        dest->getPixelFormat() != PIXEL_FORMAT_RGBA_8888) {
+        return false;
+    }
+    if ((source->getUsage() & GRALLOC_USAGE_SW_READ_MASK) == 0 ||
+        (dest->getUsage() & GRALLOC_USAGE_SW_WRITE_MASK) == 0) {
+        return false;
+    }
+
+    const sp<Fence>& acquireFence = single->getActiveBufferFence();
+    const int fenceFd = acquireFence != nullptr ? acquireFence->dup() : -1;
+
+    void* sourcePixels = nullptr;
+    if (source->lockAsync(GRALLOC_USAGE_SW_READ_OFTEN, &sourcePixels, fenceFd) != NO_ERROR ||
+        sourcePixels == nullptr) {
+        return false;
+    }
+    void* destPixels = nullptr;
+    if (dest->lock(GRALLOC_USAGE_SW_WRITE_OFTEN, &destPixels) != NO_ERROR ||
+        destPixels == nullptr) {
+        source->unlock();
+        return false;
+    }
+
+    const size_t rowBytes = reqWidth * 4;
+    const uint8_t* sourceRow = static_cast<const uint8_t*>(sourcePixels);
+    uint8_t* destRow = static_cast<uint8_t*>(destPixels);
+    for (uint32_t y = 0; y < reqHeight; y++) {
+        memcpy(destRow, sourceRow, rowBytes);
+        sourceRow += source->getStride() * 4;
+        destRow += dest->getStride() * 4;
+    }
+
+    dest->unlock();
+    source->unlock();
+
+    // The copy completed on the CPU; no fence for the caller to wait on.
+    *outSyncFd = -1;
+    return true;
+}
+
 void SurfaceFlinger::renderScreenImplLocked(const RenderArea& renderArea,
                                             TraverseLayersFunction traverseLayers,
                                             ANativeWindowBuffer* buffer, bool useIdentityTransform,
                                             int* outSyncFd) {
     ATRACE_CALL();
 
+    if (captureSingleBufferLayerDirect(renderArea, traverseLayers, buffer, outSyncFd)) {
+        return;
+    }
+
     const auto reqWidth = renderArea.getReqWidth();
     const auto reqHeight = renderArea.getReqHeight();
     const auto rotation = renderArea.getRotationFlags();
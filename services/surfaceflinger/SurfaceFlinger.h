@@ -35,6 +35,7 @@
 #include <input/ISetInputWindowsListener.h>
 #include <layerproto/LayerProtoHeader.h>
 #include <math/mat4.h>
+#include <renderengine/LayerSettings.h>
 #include <serviceutils/PriorityDumper.h>
 #include <system/graphics.h>
 #include <ui/FenceTime.h>
@@ -64,6 +65,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
@@ -177,6 +179,8 @@ public:
     SurfaceFlingerBE& getBE() { return mBE; }
     const SurfaceFlingerBE& getBE() const { return mBE; }
 
+    bool isMainThread() const { return std::this_thread::get_id() == mMainThreadId; }
+
     // This is the phase offset in nanoseconds of the software vsync event
     // relative to the vsync event reported by HWComposer.  The software vsync
     // event is when SurfaceFlinger and Choreographer-based applications run each
@@ -594,6 +598,14 @@ private:
     uint32_t setClientStateLocked(const ComposerState& composerState, int64_t desiredPresentTime,
                                   const std::vector<ListenerCallbacks>& listenerCallbacks,
                                   int64_t postTime, bool privileged) REQUIRES(mStateLock);
+    // Applies all client states of one transaction.  States whose change
+    // mask is local to the targeted layer are partitioned by disjoint layer
+    // subtrees and applied on a worker pool; hierarchy, buffer and callback
+    // changes are applied sequentially in submission order afterwards.
+    uint32_t applyClientStatesLocked(const Vector<ComposerState>& states,
+                                     int64_t desiredPresentTime,
+                                     const std::vector<ListenerCallbacks>& listenerCallbacks,
+                                     int64_t postTime, bool privileged) REQUIRES(mStateLock);
     uint32_t setDisplayStateLocked(const DisplayState& s) REQUIRES(mStateLock);
     uint32_t addInputWindowCommands(const InputWindowCommands& inputWindowCommands)
             REQUIRES(mStateLock);
@@ -648,6 +660,12 @@ private:
 
     using TraverseLayersFunction = std::function<void(const LayerVector::Visitor&)>;
 
+    // No-GL fast path for captures of a single full-frame opaque buffer
+    // layer; returns false (leaving the output untouched) whenever any
+    // condition for a straight pixel copy doesn't hold.
+    bool captureSingleBufferLayerDirect(const RenderArea& renderArea,
+                                        TraverseLayersFunction traverseLayers,
+                                        ANativeWindowBuffer* buffer, int* outSyncFd);
     void renderScreenImplLocked(const RenderArea& renderArea, TraverseLayersFunction traverseLayers,
                                 ANativeWindowBuffer* buffer, bool useIdentityTransform,
                                 int* outSyncFd);
@@ -671,6 +689,8 @@ private:
      * Properties
      */
     void readPersistentProperties();
+    void startPersistentPropertyWatcher();
+    std::once_flag mPersistentPropertyWatcherFlag;
 
     /* ------------------------------------------------------------------------
      * EGL
@@ -752,6 +772,11 @@ private:
     void invalidateHwcGeometry();
     void computeVisibleRegions(const sp<const DisplayDevice>& display, Region& dirtyRegion,
                                Region& opaqueRegion);
+    // Last visible-region traversal per display (keyed by display identity,
+    // never dereferenced).  The per-layer visibility caches are only usable
+    // when the traversal is unchanged; additions, removals and reorderings
+    // fall back to a full recompute.
+    std::unordered_map<const void*, std::vector<Layer*>> mVisibleRegionTraversals;
 
     void preComposition();
     void postComposition();
@@ -784,6 +809,9 @@ private:
      */
     void prepareFrame(const sp<DisplayDevice>& display);
     void doComposition(const sp<DisplayDevice>& display, bool repainEverything);
+    // Feedback controller nudging the vsync phase offsets; called once
+    // per frame with whether the previous frame missed its deadline.
+    void tunePhaseOffsets(bool frameMissed);
     void doDebugFlashRegions(const sp<DisplayDevice>& display, bool repaintEverything);
     void logLayerStats();
     void doDisplayComposition(const sp<DisplayDevice>& display, const Region& dirtyRegion);
@@ -791,8 +819,14 @@ private:
     // This fails if using GL and the surface has been destroyed. readyFence
     // will be populated if using GL and native fence sync is supported, to
     // signal when drawing has completed.
-    bool doComposeSurfaces(const sp<DisplayDevice>& display, const Region& debugRegionm,
+    bool doComposeSurfaces(const sp<DisplayDevice>& display, const Region& dirtyRegion,
+                           const Region& debugRegionm,
                            base::unique_fd* readyFence);
+    // Builds the renderengine layer list for a display's client
+    // composition.  CPU-only, so independent displays can run it
+    // concurrently; see handleMessageRefresh().
+    std::vector<renderengine::LayerSettings> buildClientCompositionLayers(
+            const sp<DisplayDevice>& display, Region* outClearRegion);
 
     void postFramebuffer(const sp<DisplayDevice>& display);
     void postFrame();
@@ -1021,6 +1055,42 @@ private:
     bool mDebugDisableTransformHint = false;
     volatile nsecs_t mDebugInTransaction = 0;
     bool mForceFullDamage = false;
+    // When enabled (debug.sf.gpu_partial_updates), client composition only
+    // renders the accumulated damage of the output buffer and preserves
+    // the rest of its contents; assumes the render surface keeps the
+    // standard three buffers in rotation.
+    bool mUseClientPartialUpdates = false;
+    // Damage of the previous frames per display (most recent first), used
+    // to accumulate the output buffer's damage.  Main thread only.
+    std::unordered_map<const void*, std::deque<Region>> mClientCompositionDamage;
+    // When enabled (debug.sf.parallel_display_composition) and several
+    // displays are attached, the client-composition layer lists are built
+    // on worker threads between HWC validate and the draws.
+    bool mParallelDisplayComposition = false;
+    // When enabled (debug.sf.parallel_latch), layers with queued frames
+    // are latched on worker threads; requires native fence sync so no GL
+    // work happens at latch time.
+    bool mParallelBufferLatch = false;
+
+    // Phase-offset feedback loop (debug.sf.phase_offset_tuning): reclaims
+    // fixed latency margin by shifting the app/SF offsets later while no
+    // frames are missed, and gives it back with hysteresis when misses
+    // reappear.  Main thread only; see tunePhaseOffsets().
+    bool mPhaseOffsetTuning = false;
+    nsecs_t mMaxPhaseOffsetAdjustment = 0;
+    nsecs_t mPhaseOffsetAdjustment = 0;
+    static constexpr uint32_t kTunerWindowSize = 600;
+    uint32_t mTunerWindowFrames = 0;
+    uint32_t mTunerWindowMisses = 0;
+    uint32_t mTunerCleanWindows = 0;
+    struct ClientCompositionBuild {
+        std::vector<renderengine::LayerSettings> layers;
+        Region clearRegion = Region::INVALID_REGION;
+    };
+    std::mutex mPrebuiltCompositionLock;
+    // Filled by the parallel build phase, consumed by doComposeSurfaces();
+    // only ever read on the main thread after the workers have joined.
+    std::unordered_map<const void*, ClientCompositionBuild> mPrebuiltClientComposition;
     bool mPropagateBackpressure = true;
     bool mPropagateBackpressureClientComposition = false;
     std::unique_ptr<SurfaceInterceptor> mInterceptor;
@@ -1089,6 +1159,18 @@ private:
     };
     std::unordered_map<sp<IBinder>, std::queue<TransactionState>, IBinderHash> mTransactionQueues;
 
+    // Index of non-empty transaction queues ordered by their head entry's
+    // normalized desired present time (0 for apply-ASAP heads), so
+    // flushTransactionQueues() only visits queues that are actually due
+    // instead of rescanning every token each invalidate.  One entry per
+    // non-empty queue; maintained wherever mTransactionQueues changes.
+    std::multimap<int64_t, sp<IBinder>> mPendingTransactionHeads;
+    static int64_t transactionQueueKey(const TransactionState& transaction);
+
+    // deferred-transaction statistics, for dumpsys
+    uint64_t mTransactionsDeferred = 0;
+    size_t mPeakTransactionQueueDepth = 0;
+
     /* ------------------------------------------------------------------------
      * Feature prototyping
      */
@@ -51,7 +51,18 @@ void SurfaceTracing::addFirstEntry() {
 
 LayersTraceProto SurfaceTracing::traceWhenNotified() {
     std::unique_lock<std::mutex> lock(mSfLock);
-    mCanStartTrace.wait(lock);
+    // A notification that arrived while the previous snapshot was being
+    // built was recorded instead of blocking the main thread; consume it
+    // before sleeping.  (One recorded during the brief window before the
+    // wait is picked up on the next wakeup.)
+    if (mPendingNotify.exchange(false)) {
+        mWhere = mPendingWhere.load();
+    } else {
+        mCanStartTrace.wait(lock);
+        if (mPendingNotify.exchange(false)) {
+            mWhere = mPendingWhere.load();
+        }
+    }
     android::base::ScopedLockAssertion assumeLock(mSfLock);
     LayersTraceProto entry = traceLayersLocked(mWhere);
     lock.unlock();
@@ -69,8 +80,19 @@ bool SurfaceTracing::addTraceToBuffer(LayersTraceProto& entry) {
 }
 
 void SurfaceTracing::notify(const char* where) {
-    std::scoped_lock lock(mSfLock);
-    mWhere = where;
+    {
+        std::unique_lock<std::mutex> lock(mSfLock, std::try_to_lock);
+        if (lock.owns_lock()) {
+            mWhere = where;
+            mCanStartTrace.notify_one();
+            return;
+        }
+    }
+    // The tracing thread is mid-snapshot under the state lock; record the
+    // notification and return instead of stalling the main thread for the
+    // several milliseconds a full LayersProto serialization takes.
+    mPendingWhere.store(where);
+    mPendingNotify.store(true);
     mCanStartTrace.notify_one();
 }
 
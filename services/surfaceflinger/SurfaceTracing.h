@@ -21,6 +21,7 @@
 #include <utils/StrongPointer.h>
 
 #include <android-base/thread_annotations.h>
+#include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -98,6 +99,11 @@ private:
     std::mutex& mSfLock;
     uint32_t mTraceFlags GUARDED_BY(mSfLock) = TRACE_ALL;
     const char* mWhere GUARDED_BY(mSfLock) = "";
+    // Notification recorded when the main thread found the tracing thread
+    // mid-snapshot; consumed by the tracing thread without ever blocking
+    // the notifier.
+    std::atomic<bool> mPendingNotify{false};
+    std::atomic<const char*> mPendingWhere{nullptr};
 
     mutable std::mutex mTraceLock;
     LayersTraceBuffer mBuffer GUARDED_BY(mTraceLock);
@@ -262,16 +262,18 @@ void TimeStats::setPostTime(int32_t layerID, uint64_t frameNumber, const std::st
           postTime);
 
     std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerID) && mTimeStatsTracker.size() < MAX_NUM_LAYER_RECORDS &&
+    auto it = mTimeStatsTracker.find(layerID);
+    if (it == mTimeStatsTracker.end() && mTimeStatsTracker.size() < MAX_NUM_LAYER_RECORDS &&
         layerNameIsValid(layerName)) {
-        mTimeStatsTracker[layerID].layerName = layerName;
+        it = mTimeStatsTracker.emplace(layerID, LayerRecord()).first;
+        it->second.layerName = layerName;
     }
-    if (!mTimeStatsTracker.count(layerID)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerID];
+    if (it == mTimeStatsTracker.end()) return;
+    LayerRecord& layerRecord = it->second;
     if (layerRecord.timeRecords.size() == MAX_NUM_TIME_RECORDS) {
         ALOGE("[%d]-[%s]-timeRecords is at its maximum size[%zu]. Ignore this when unittesting.",
               layerID, layerRecord.layerName.c_str(), MAX_NUM_TIME_RECORDS);
-        mTimeStatsTracker.erase(layerID);
+        mTimeStatsTracker.erase(it);
         return;
     }
     // For most media content, the acquireFence is invalid because the buffer is
@@ -300,8 +302,9 @@ void TimeStats::setLatchTime(int32_t layerID, uint64_t frameNumber, nsecs_t latc
     ALOGV("[%d]-[%" PRIu64 "]-LatchTime[%" PRId64 "]", layerID, frameNumber, latchTime);
 
     std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerID)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerID];
+    auto it = mTimeStatsTracker.find(layerID);
+    if (it == mTimeStatsTracker.end()) return;
+    LayerRecord& layerRecord = it->second;
     if (layerRecord.waitData < 0 ||
         layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
         return;
@@ -318,8 +321,9 @@ void TimeStats::setDesiredTime(int32_t layerID, uint64_t frameNumber, nsecs_t de
     ALOGV("[%d]-[%" PRIu64 "]-DesiredTime[%" PRId64 "]", layerID, frameNumber, desiredTime);
 
     std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerID)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerID];
+    auto it = mTimeStatsTracker.find(layerID);
+    if (it == mTimeStatsTracker.end()) return;
+    LayerRecord& layerRecord = it->second;
     if (layerRecord.waitData < 0 ||
         layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
         return;
@@ -336,8 +340,9 @@ void TimeStats::setAcquireTime(int32_t layerID, uint64_t frameNumber, nsecs_t ac
     ALOGV("[%d]-[%" PRIu64 "]-AcquireTime[%" PRId64 "]", layerID, frameNumber, acquireTime);
 
     std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerID)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerID];
+    auto it = mTimeStatsTracker.find(layerID);
+    if (it == mTimeStatsTracker.end()) return;
+    LayerRecord& layerRecord = it->second;
     if (layerRecord.waitData < 0 ||
         layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
         return;
@@ -356,8 +361,9 @@ void TimeStats::setAcquireFence(int32_t layerID, uint64_t frameNumber,
           acquireFence->getSignalTime());
 
     std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerID)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerID];
+    auto it = mTimeStatsTracker.find(layerID);
+    if (it == mTimeStatsTracker.end()) return;
+    LayerRecord& layerRecord = it->second;
     if (layerRecord.waitData < 0 ||
         layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
         return;
@@ -374,8 +380,9 @@ void TimeStats::setPresentTime(int32_t layerID, uint64_t frameNumber, nsecs_t pr
     ALOGV("[%d]-[%" PRIu64 "]-PresentTime[%" PRId64 "]", layerID, frameNumber, presentTime);
 
     std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerID)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerID];
+    auto it = mTimeStatsTracker.find(layerID);
+    if (it == mTimeStatsTracker.end()) return;
+    LayerRecord& layerRecord = it->second;
     if (layerRecord.waitData < 0 ||
         layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
         return;
@@ -398,8 +405,9 @@ void TimeStats::setPresentFence(int32_t layerID, uint64_t frameNumber,
           presentFence->getSignalTime());
 
     std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerID)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerID];
+    auto it = mTimeStatsTracker.find(layerID);
+    if (it == mTimeStatsTracker.end()) return;
+    LayerRecord& layerRecord = it->second;
     if (layerRecord.waitData < 0 ||
         layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
         return;
@@ -431,8 +439,9 @@ void TimeStats::removeTimeRecord(int32_t layerID, uint64_t frameNumber) {
     ALOGV("[%d]-[%" PRIu64 "]-removeTimeRecord", layerID, frameNumber);
 
     std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerID)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerID];
+    auto it = mTimeStatsTracker.find(layerID);
+    if (it == mTimeStatsTracker.end()) return;
+    LayerRecord& layerRecord = it->second;
     size_t removeAt = 0;
     for (const TimeRecord& record : layerRecord.timeRecords) {
         if (record.frameTime.frameNumber == frameNumber) break;
@@ -601,22 +610,31 @@ bool TimeStats::isEnabled() {
 void TimeStats::dump(bool asProto, std::optional<uint32_t> maxLayers, std::string& result) {
     ATRACE_CALL();
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (mTimeStats.statsStart == 0) {
-        return;
-    }
+    // Snapshot the aggregated stats under the lock and serialize from the
+    // copy with no lock held, so a frequent telemetry puller doesn't
+    // serialize against the per-frame setters for the duration of the
+    // proto/string build.
+    TimeStatsHelper::TimeStatsGlobal timeStats;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mTimeStats.statsStart == 0) {
+            return;
+        }
 
-    mTimeStats.statsEnd = static_cast<int64_t>(std::time(0));
+        mTimeStats.statsEnd = static_cast<int64_t>(std::time(0));
 
-    flushPowerTimeLocked();
+        flushPowerTimeLocked();
+
+        timeStats = mTimeStats;
+    }
 
     if (asProto) {
         ALOGD("Dumping TimeStats as proto");
-        SFTimeStatsGlobalProto timeStatsProto = mTimeStats.toProto(maxLayers);
+        SFTimeStatsGlobalProto timeStatsProto = timeStats.toProto(maxLayers);
         result.append(timeStatsProto.SerializeAsString().c_str(), timeStatsProto.ByteSize());
     } else {
         ALOGD("Dumping TimeStats as text");
-        result.append(mTimeStats.toString(maxLayers));
+        result.append(timeStats.toString(maxLayers));
         result.append("\n");
     }
 }
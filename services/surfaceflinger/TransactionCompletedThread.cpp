@@ -55,6 +55,17 @@ TransactionCompletedThread::~TransactionCompletedThread() {
         mThread.join();
     }
 
+    {
+        std::lock_guard lock(mDeliveryMutex);
+        mDeliveryRunning = false;
+    }
+    mDeliveryCondition.notify_all();
+    for (std::thread& deliveryThread : mDeliveryThreads) {
+        if (deliveryThread.joinable()) {
+            deliveryThread.join();
+        }
+    }
+
     {
         std::lock_guard lock(mMutex);
         for (const auto& [listener, transactionStats] : mCompletedTransactions) {
@@ -73,6 +84,43 @@ void TransactionCompletedThread::run() {
 
     std::lock_guard lockThread(mThreadMutex);
     mThread = std::thread(&TransactionCompletedThread::threadMain, this);
+    for (size_t i = 0; i < kDeliveryThreads; i++) {
+        mDeliveryThreads[i] = std::thread(&TransactionCompletedThread::deliveryThreadMain, this, i);
+    }
+}
+
+void TransactionCompletedThread::enqueueDelivery(
+        const sp<ITransactionCompletedListener>& listener, ListenerStats&& listenerStats) {
+    const size_t index =
+            std::hash<IBinder*>{}(IInterface::asBinder(listener).get()) % kDeliveryThreads;
+    {
+        std::lock_guard lock(mDeliveryMutex);
+        mDeliveryQueues[index].emplace_back(listener, std::move(listenerStats));
+    }
+    mDeliveryCondition.notify_all();
+}
+
+void TransactionCompletedThread::deliveryThreadMain(size_t index) {
+    std::unique_lock lock(mDeliveryMutex);
+    while (mDeliveryRunning) {
+        if (mDeliveryQueues[index].empty()) {
+            mDeliveryCondition.wait(lock);
+            continue;
+        }
+        auto entry = std::move(mDeliveryQueues[index].front());
+        mDeliveryQueues[index].pop_front();
+
+        // The binder call happens without any lock held: a client whose
+        // oneway buffer is full only stalls this worker.
+        lock.unlock();
+        entry.first->onTransactionCompleted(entry.second);
+        IInterface::asBinder(entry.first)->unlinkToDeath(mDeathRecipient);
+        // Drop the stats (and with them possibly the last layer
+        // references) before retaking any lock; see the deadlock note in
+        // threadMain().
+        entry = {};
+        lock.lock();
+    }
 }
 
 status_t TransactionCompletedThread::addCallback(const sp<ITransactionCompletedListener>& listener,
@@ -263,9 +311,12 @@ void TransactionCompletedThread::threadMain() {
             if (!listenerStats.transactionStats.empty()) {
                 // If the listener is still alive
                 if (IInterface::asBinder(listener)->isBinderAlive()) {
-                    // Send callback
-                    listenerStats.listener->onTransactionCompleted(listenerStats);
-                    IInterface::asBinder(listener)->unlinkToDeath(mDeathRecipient);
+                    // Hand the merged stats to the delivery pool; the
+                    // binder call must not happen under mMutex.
+                    enqueueDelivery(listener, std::move(listenerStats));
+                    completedTransactionsItr =
+                            mCompletedTransactions.erase(completedTransactionsItr);
+                    continue;
                 }
                 completedTransactionsItr = mCompletedTransactions.erase(completedTransactionsItr);
             } else {
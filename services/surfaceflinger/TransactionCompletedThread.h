@@ -134,6 +134,22 @@ private:
     bool mKeepRunning GUARDED_BY(mMutex) = true;
 
     sp<Fence> mPresentFence GUARDED_BY(mMutex);
+
+    // Delivery pool: the merged per-listener callbacks leave the
+    // completion thread (and mMutex) and are sent by a small set of
+    // workers.  A listener always hashes to the same worker, preserving
+    // its callback order, so one client stuck in a full oneway buffer
+    // only stalls the listeners sharing its worker.
+    static constexpr size_t kDeliveryThreads = 4;
+    void deliveryThreadMain(size_t index);
+    void enqueueDelivery(const sp<ITransactionCompletedListener>& listener,
+                         ListenerStats&& listenerStats) REQUIRES(mMutex);
+    std::mutex mDeliveryMutex;
+    std::condition_variable mDeliveryCondition;
+    bool mDeliveryRunning GUARDED_BY(mDeliveryMutex) = true;
+    std::deque<std::pair<sp<ITransactionCompletedListener>, ListenerStats>>
+            mDeliveryQueues[kDeliveryThreads] GUARDED_BY(mDeliveryMutex);
+    std::thread mDeliveryThreads[kDeliveryThreads];
 };
 
 } // namespace android
@@ -39,7 +39,9 @@ public:
     MOCK_METHOD1(registerDisplayEventConnection,
                  status_t(const sp<android::EventThreadConnection> &));
     MOCK_METHOD2(setVsyncRate, void(uint32_t, const sp<android::EventThreadConnection> &));
+    MOCK_METHOD2(setVsyncPhase, void(uint32_t, const sp<android::EventThreadConnection> &));
     MOCK_METHOD1(requestNextVsync, void(const sp<android::EventThreadConnection> &));
+    MOCK_CONST_METHOD0(getVsyncRingMemory, sp<IMemory>());
     MOCK_METHOD1(pauseVsyncCallback, void(bool));
 };
 
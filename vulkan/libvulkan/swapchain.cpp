@@ -19,10 +19,12 @@
 #include <android/hardware/graphics/common/1.0/types.h>
 #include <grallocusage/GrallocUsageConversion.h>
 #include <log/log.h>
+#include <cutils/properties.h>
 #include <sync/sync.h>
 #include <system/window.h>
 #include <ui/BufferQueueDefs.h>
 #include <utils/StrongPointer.h>
+#include <utils/Timers.h>
 #include <utils/Trace.h>
 #include <utils/Vector.h>
 
@@ -234,11 +236,16 @@ struct Swapchain {
           pre_transform(pre_transform_),
           frame_timestamps_enabled(false),
           shared(present_mode == VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR ||
-                 present_mode == VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR) {
+                 present_mode == VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR),
+          acquire_pacing_enabled(property_get_bool("debug.vulkan.pacing", false)),
+          last_actual_present_time(0) {
         ANativeWindow* window = surface.window.get();
         native_window_get_refresh_cycle_duration(
             window,
             &refresh_duration);
+        for (size_t i = 0; i < kRecentFrameIdCount; i++) {
+            recent_frame_ids[i] = 0;
+        }
     }
     uint64_t get_refresh_duration()
     {
@@ -271,6 +278,22 @@ struct Swapchain {
     } images[android::BufferQueueDefs::NUM_BUFFER_SLOTS];
 
     android::Vector<TimingInfo> timing;
+
+    // Acquire pacing (debug.vulkan.pacing): AcquireNextImageKHR wakeups
+    // are delayed to the next predicted vsync edge, derived from the
+    // actual present timestamps of recent frames so titles stop
+    // busy-waiting for regular pacing.  See pace_acquire_wakeup().
+    static constexpr size_t kRecentFrameIdCount = 4;
+    bool acquire_pacing_enabled;
+    int64_t last_actual_present_time;
+    uint64_t recent_frame_ids[kRecentFrameIdCount];
+
+    void record_recent_frame_id(uint64_t frame_id) {
+        for (size_t i = kRecentFrameIdCount - 1; i > 0; i--) {
+            recent_frame_ids[i] = recent_frame_ids[i - 1];
+        }
+        recent_frame_ids[0] = frame_id;
+    }
 };
 
 VkSwapchainKHR HandleFromSwapchain(Swapchain* swapchain) {
@@ -1429,6 +1452,57 @@ VkResult GetSwapchainImagesKHR(VkDevice,
     return result;
 }
 
+// Delays the calling thread to the next predicted vsync edge, computed
+// from the most recent resolved present timestamp and the refresh
+// duration.  A frame loop that calls AcquireNextImageKHR at the top then
+// naturally runs vsync-cadenced without an app-side busy-wait.
+static void pace_acquire_wakeup(Swapchain& swapchain) {
+    ATRACE_CALL();
+
+    const int64_t refresh = swapchain.refresh_duration;
+    if (refresh <= 0)
+        return;
+
+    // Resolve the newest available present edge; frames queued two or
+    // more vsyncs ago have usually signalled by now.
+    ANativeWindow* window = swapchain.surface.window.get();
+    for (size_t i = 0; i < Swapchain::kRecentFrameIdCount; i++) {
+        const uint64_t frame_id = swapchain.recent_frame_ids[i];
+        if (frame_id == 0)
+            continue;
+        int64_t actual_present_time = NATIVE_WINDOW_TIMESTAMP_PENDING;
+        int ret = native_window_get_frame_timestamps(
+            window, frame_id, nullptr, nullptr, nullptr, nullptr, nullptr,
+            nullptr, &actual_present_time, nullptr, nullptr);
+        if (ret == android::NO_ERROR &&
+            actual_present_time != NATIVE_WINDOW_TIMESTAMP_PENDING &&
+            actual_present_time != NATIVE_WINDOW_TIMESTAMP_INVALID &&
+            actual_present_time > swapchain.last_actual_present_time) {
+            swapchain.last_actual_present_time = actual_present_time;
+            break;
+        }
+    }
+
+    const int64_t base = swapchain.last_actual_present_time;
+    if (base <= 0)
+        return;
+
+    const int64_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+    const int64_t next_vsync = base + ((now - base) / refresh + 1) * refresh;
+
+    // Wake slightly before the edge, and never sleep when the prediction
+    // is stale enough that we'd burn most of a period.
+    constexpr int64_t kWakeupMarginNs = 500000;
+    const int64_t sleep_until = next_vsync - kWakeupMarginNs;
+    if (sleep_until <= now || (sleep_until - now) >= refresh)
+        return;
+
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(sleep_until / 1000000000);
+    ts.tv_nsec = static_cast<long>(sleep_until % 1000000000);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+}
+
 VKAPI_ATTR
 VkResult AcquireNextImageKHR(VkDevice device,
                              VkSwapchainKHR swapchain_handle,
@@ -1450,6 +1524,15 @@ VkResult AcquireNextImageKHR(VkDevice device,
         timeout != UINT64_MAX,
         "vkAcquireNextImageKHR: non-infinite timeouts not yet implemented");
 
+    if (swapchain.acquire_pacing_enabled && !swapchain.shared) {
+        if (!swapchain.frame_timestamps_enabled) {
+            ALOGV("Calling native_window_enable_frame_timestamps(true)");
+            native_window_enable_frame_timestamps(window, true);
+            swapchain.frame_timestamps_enabled = true;
+        }
+        pace_acquire_wakeup(swapchain);
+    }
+
     if (swapchain.shared) {
         // In shared mode, we keep the buffer dequeued all the time, so we don't
         // want to dequeue a buffer here. Instead, just ask the driver to ensure
@@ -1696,6 +1779,17 @@ VkResult QueuePresentKHR(VkQueue queue, const VkPresentInfoKHR* present_info) {
                     }
                 }
 
+                if (swapchain.acquire_pacing_enabled) {
+                    // Track this frame so pace_acquire_wakeup() can derive
+                    // the vsync phase from its present timestamp, with or
+                    // without VK_GOOGLE_display_timing in use.
+                    uint64_t pacingFrameId = 0;
+                    if (native_window_get_next_frame_id(window, &pacingFrameId) ==
+                        android::NO_ERROR) {
+                        swapchain.record_recent_frame_id(pacingFrameId);
+                    }
+                }
+
                 err = window->queueBuffer(window, img.buffer.get(), fence);
                 // queueBuffer always closes fence, even on error
                 if (err != 0) {